@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "HouseHaunters.hpp"
 ////////////////////////////
 // This is the House Haunters game (skeleton). In order to make the code really
@@ -9,6 +10,104 @@ int main(int argc, char** argv)
 {
     // Create an instance of the House Haunters game engine
     HouseHauntersGame game;
+    // --debug prints render stats (and anything else that checks for it)
+    // --pacing=vsync|capped|uncapped|adaptive and --fps=N pick how frames are paced
+    // --tick=N sets the simulation rate, --no-interpolation draws only after ticks
+    // --max-substeps=N caps the ticks run to catch up in one frame
+    // --pipeline simulates on a second thread while the last tick is drawn
+    // --jobs=N sets how many threads share out a tick's work (default one per core)
+    // --deadzone=F and --stick-curve=F tune the sticks (fraction of the throw, exponent)
+    // --seed=N generates the same house every time
+    // --hot-reload puts textures and shaders on screen as they're saved
+    // --save=FILE is where F5 quick-saves the match and F9 loads it (quicksave.hhs),
+    //   --resume starts from what's saved there, say after a crash
+    // --bots=N goes straight into a match of you on the keyboard and N bots,
+    //   --watch leaves you out and has bots in every seat
+    // --net-player=N --net-port=P --peer=N@host:port ... plays over the network as
+    //   player N (give every machine the same --seed), --input-delay=N in ticks,
+    //   --rollback=N ticks to run on a guess when someone's input is late (0 waits)
+    FramePacer::MODE pacing = FramePacer::VSYNC;
+    float fps = 60;
+    Input::Response stick;
+    Lockstep lockstep;
+    int netPlayer = -1;
+    int netPort = 0;
+    int inputDelay = lockstep.getInputDelay();
+    struct Peer { int player; std::string host; unsigned short port; };
+    std::vector<Peer> peers;
+    std::string saveFile = "quicksave.hhs";
+    bool resume = false;
+    int bots = 0;
+    bool watch = false;
+    for(int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        if(arg == "--debug")
+            game.setDebugMode(true);
+        else if(arg.compare(0, 9, "--pacing=") == 0){
+            if(!FramePacer::parseMode(arg.substr(9), pacing))
+                std::cout << "Unknown pacing " << arg.substr(9) << ", using vsync" << std::endl;
+        }
+        else if(arg.compare(0, 6, "--fps=") == 0)
+            fps = std::stof(arg.substr(6));
+        else if(arg.compare(0, 7, "--tick=") == 0)
+            game.setTickRate(std::stof(arg.substr(7)));
+        else if(arg.compare(0, 15, "--max-substeps=") == 0)
+            game.setMaxSubSteps(std::stoi(arg.substr(15)));
+        else if(arg == "--no-interpolation")
+            game.setInterpolation(false);
+        else if(arg == "--pipeline")
+            game.setPipelined(true);
+        else if(arg.compare(0, 7, "--jobs=") == 0)
+            game.setJobThreads(std::stoi(arg.substr(7)));
+        else if(arg.compare(0, 11, "--deadzone=") == 0)
+            stick.deadZone = std::stof(arg.substr(11));
+        else if(arg.compare(0, 14, "--stick-curve=") == 0)
+            stick.exponent = std::stof(arg.substr(14));
+        else if(arg.compare(0, 7, "--seed=") == 0)
+            game.setSeed(std::stoul(arg.substr(7)));
+        else if(arg == "--hot-reload")
+            game.setHotReload(true);
+        else if(arg.compare(0, 7, "--save=") == 0)
+            saveFile = arg.substr(7);
+        else if(arg == "--resume")
+            resume = true;
+        else if(arg.compare(0, 7, "--bots=") == 0)
+            bots = std::max(0, std::min(4, std::stoi(arg.substr(7))));
+        else if(arg == "--watch")
+            watch = true;
+        else if(arg.compare(0, 13, "--net-player=") == 0)
+            netPlayer = std::stoi(arg.substr(13));
+        else if(arg.compare(0, 11, "--net-port=") == 0)
+            netPort = std::stoi(arg.substr(11));
+        else if(arg.compare(0, 14, "--input-delay=") == 0)
+            inputDelay = std::stoi(arg.substr(14));
+        else if(arg.compare(0, 11, "--rollback=") == 0)
+            game.setRollback(std::stoi(arg.substr(11)));
+        else if(arg.compare(0, 7, "--peer=") == 0){
+            // N@host:port
+            std::string peer = arg.substr(7);
+            std::size_t at = peer.find('@');
+            std::size_t colon = peer.rfind(':');
+            if(at == std::string::npos || colon == std::string::npos || colon < at){
+                std::cout << "Expected --peer=N@host:port, got " << arg << std::endl;
+                continue;
+            }
+            peers.push_back({std::stoi(peer.substr(0, at)), peer.substr(at + 1, colon - at - 1),
+                             static_cast<unsigned short>(std::stoi(peer.substr(colon + 1)))});
+        }
+    }
+    if(netPlayer >= 0){
+        lockstep.setInputDelay(inputDelay);
+        if(lockstep.open(netPort, netPlayer, static_cast<int>(peers.size()) + 1)){
+            for(auto it = peers.begin(); it != peers.end(); it++)
+                lockstep.addPeer(it->player, sf::IpAddress(it->host), it->port);
+            game.setLockstep(&lockstep);
+        }
+    }
+    game.setPacing(pacing, fps);
+    game.setStickResponse(stick);
+    game.setSaveFile(saveFile, resume);
+    game.setBots(bots, watch);
     
     // Maybe potentially read in config files here
     // and then push them to the game
@@ -0,0 +1,295 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "engine/Input.hpp"
+#include "engine/JobSystem.hpp"
+#include "game/sim/BotMatch.hpp"
+////////////////////////////
+// Balance simulator: plays bot matches (see include/game/sim/BotMatch.hpp)
+// for every combination of the rules being swept, on every core, with no
+// window, sound or network, and writes a line of CSV for each combination:
+// how often the players win and how long the ghost and the players last.
+//
+//     HHBalance --matches=10000 --sweep=villainHealth=6:14:2
+//               --sweep=itemDamageHigh=3,5,7 --players=1,2,3,4
+//
+// Any of Match::Rules's numbers can be swept (--list shows them) or set
+// for the whole run (--set=phaseSeconds=60). Every combination plays the
+// same seeds (--seed, --seed + 1, ...), so the difference between two
+// lines is down to the rules and not to a luckier run of houses.
+//
+// What the numbers are good for is in HELP below (and --help): the
+// matches are the game's own (Match, which HH plays too) but the players
+// are MatchBots, so they say how rules compare for bots, not what win
+// rate people will get.
+///////////////////////////
+
+namespace
+{
+    const char* HELP =
+        "HHBalance [--matches=N] [--players=N,...] [--sweep=NAME=a,b,c | NAME=from:to[:step]]...\n"
+        "          [--set=NAME=V]... [--tuning=FILE] [--threads=N] [--seed=N] [--tick=N]\n"
+        "          [--out=FILE] [--list] [--help]\n"
+        "\n"
+        "Plays bot matches for every combination of the swept rules and writes a CSV line\n"
+        "for each. What the numbers are valid for:\n"
+        "  - The rules and the match are the game's own: HH plays the same Match, so\n"
+        "    a rule behaves the same way here as on screen.\n"
+        "  - The players are bots (MatchBot), not people. They always know where the\n"
+        "    ghost is, even through walls, react the tick something happens, never\n"
+        "    work together and play by fixed priorities (flee, fight, search, explore).\n"
+        "    Win rates and times are how bots do; people will do better or worse.\n"
+        "  - So use them to compare rule sets with each other (every line plays the\n"
+        "    same seeds) and to spot rules that make a match one-sided, not as the\n"
+        "    win rate players will see.\n"
+        "  - Matches here stop at 600 seconds (timed_out, or --set=timeLimitSeconds=S);\n"
+        "    the game has no time limit.\n"
+        "  - The rules start from the built-in defaults, not resources/tuning.txt,\n"
+        "    unless --tuning=FILE is given.\n";
+
+    struct Axis
+    {
+        std::string name;
+        std::vector<float> values;
+    };
+
+    // "a,b,c" or "from:to:step"
+    bool parseValues(const std::string& text, std::vector<float>& values)
+    {
+        values.clear();
+        try{
+            std::size_t colon = text.find(':');
+            if(colon != std::string::npos){
+                std::size_t second = text.find(':', colon + 1);
+                float from = std::stof(text.substr(0, colon));
+                float to = std::stof(text.substr(colon + 1, second - colon - 1));
+                float step = second == std::string::npos ? 1 : std::stof(text.substr(second + 1));
+                if(step <= 0)
+                    return false;
+                // a hair over, so a step that doesn't add up exactly still reaches to
+                for(int i = 0; from + i * step <= to + step * 1e-3f; i++)
+                    values.push_back(from + i * step);
+            }
+            else{
+                std::size_t start = 0;
+                while(start <= text.size()){
+                    std::size_t comma = text.find(',', start);
+                    if(comma == std::string::npos)
+                        comma = text.size();
+                    values.push_back(std::stof(text.substr(start, comma - start)));
+                    start = comma + 1;
+                }
+            }
+        }
+        catch(const std::exception&){
+            return false;
+        }
+        return !values.empty();
+    }
+
+    double quantile(std::vector<float>& sorted, double q)
+    {
+        if(sorted.empty())
+            return 0;
+        return sorted[std::min(sorted.size() - 1, static_cast<std::size_t>(q * sorted.size()))];
+    }
+
+    double mean(const std::vector<float>& values)
+    {
+        double sum = 0;
+        for(auto it = values.begin(); it != values.end(); it++)
+            sum += *it;
+        return values.empty() ? 0 : sum / values.size();
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // --matches=N for each combination, --players=N[,N...] in each
+    // --sweep=NAME=a,b,c or NAME=from:to[:step], --set=NAME=V, --list
+    // --threads=N (0 for one a core), --seed=N for the first match
+    // --tick=N ticks a (game) second, --out=FILE for the CSV
+    // --tuning=FILE starts from a tuning file (see resources/tuning.txt)
+    // --help says what the numbers are good for
+    int matches = 1000;
+    unsigned int threads = 0;
+    unsigned long seed = 1;
+    float tick = 60;
+    std::string out = "balance.csv";
+    Match::Rules rules;
+    rules.timeLimitSeconds = 600;
+    Axis players = {"players", std::vector<float>(1, 4)};
+    std::vector<Axis> axes;
+    for(int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        if(arg.compare(0, 10, "--matches=") == 0)
+            matches = std::max(1, std::stoi(arg.substr(10)));
+        else if(arg.compare(0, 10, "--players=") == 0){
+            if(!parseValues(arg.substr(10), players.values)){
+                std::cout << "Bad players in " << arg << std::endl;
+                return 1;
+            }
+        }
+        else if(arg.compare(0, 10, "--threads=") == 0)
+            threads = static_cast<unsigned int>(std::max(0, std::stoi(arg.substr(10))));
+        else if(arg.compare(0, 7, "--seed=") == 0)
+            seed = std::stoul(arg.substr(7));
+        else if(arg.compare(0, 7, "--tick=") == 0)
+            tick = std::stof(arg.substr(7));
+        else if(arg.compare(0, 6, "--out=") == 0)
+            out = arg.substr(6);
+        else if(arg.compare(0, 9, "--tuning=") == 0){
+            if(!rules.load(arg.substr(9)))
+                return 1;
+        }
+        else if(arg.compare(0, 8, "--sweep=") == 0 || arg.compare(0, 6, "--set=") == 0){
+            std::string spec = arg.substr(arg.find('=') + 1);
+            std::size_t equals = spec.find('=');
+            Axis axis;
+            axis.name = spec.substr(0, equals);
+            float current;
+            if(equals == std::string::npos || !rules.get(axis.name, current)){
+                std::cout << "No rule called " << axis.name << " (--list shows them)" << std::endl;
+                return 1;
+            }
+            if(!parseValues(spec.substr(equals + 1), axis.values)){
+                std::cout << "Bad values in " << arg << std::endl;
+                return 1;
+            }
+            if(arg.compare(0, 6, "--set=") == 0)
+                rules.set(axis.name, axis.values.front());
+            else
+                axes.push_back(axis);
+        }
+        else if(arg == "--help"){
+            std::cout << HELP;
+            return 0;
+        }
+        else if(arg == "--list"){
+            std::vector<Match::Rules::Field> fields = rules.getFields();
+            for(auto it = fields.begin(); it != fields.end(); it++){
+                float value;
+                rules.get(it->name, value);
+                std::cout << "  " << it->name << " = " << value << std::endl;
+            }
+            return 0;
+        }
+        else
+            std::cout << "Unknown option " << arg << std::endl;
+    }
+    for(auto it = players.values.begin(); it != players.values.end(); it++){
+        if(*it < 1 || *it > 4){
+            std::cout << "Matches are for 1 to 4 players" << std::endl;
+            return 1;
+        }
+    }
+    axes.push_back(players);
+
+    std::ofstream csv(out);
+    if(!csv){
+        std::cout << "Couldn't write " << out << std::endl;
+        return 1;
+    }
+    for(auto it = axes.begin(); it != axes.end(); it++)
+        csv << it->name << ",";
+    csv << "matches,players_won,villain_won,timed_out,win_rate,win_rate_low,win_rate_high,"
+           "match_seconds,ghost_ttk_mean,ghost_ttk_median,ghost_ttk_p90,"
+           "first_death_mean,first_death_median,players_alive,clues_read,items_found,swings\n";
+
+    std::size_t combinations = 1;
+    for(auto it = axes.begin(); it != axes.end(); it++)
+        combinations *= it->values.size();
+    JobSystem jobs;
+    jobs.start(threads);
+    std::cout << "HHBalance: " << combinations << " combinations of " << matches << " matches on "
+              << jobs.getThreadCount() << " threads, to " << out << std::endl;
+
+    std::vector<BotMatch::Outcome> outcomes(matches);
+    std::vector<std::size_t> at(axes.size(), 0);
+    double totalStart = Input::now();
+    double totalMatches = 0;
+    for(std::size_t c = 0; c < combinations; c++){
+        Match::Rules point = rules;
+        for(std::size_t a = 0; a + 1 < axes.size(); a++)
+            point.set(axes[a].name, axes[a].values[at[a]]);
+        if(const char* problem = point.getProblem()){
+            std::cout << "Can't play these rules: " << problem << std::endl;
+            return 1;
+        }
+        std::vector<Config::CHARACTER> characters;
+        for(int p = 0; p < static_cast<int>(axes.back().values[at.back()]); p++)
+            characters.push_back(static_cast<Config::CHARACTER>(p));
+
+        double start = Input::now();
+        jobs.parallelFor(outcomes.size(), 1, [&](std::size_t begin, std::size_t end){
+            for(std::size_t m = begin; m < end; m++)
+                outcomes[m] = BotMatch::play(seed + m, characters, point, 1 / tick);
+        });
+        double seconds = Input::now() - start;
+        totalMatches += matches;
+
+        int results[4] = {0, 0, 0, 0};
+        double played = 0;
+        BotMatch::Outcome sum;
+        // how long the ghost lasted once it was out, in the matches it lost
+        std::vector<float> ghostTtk;
+        std::vector<float> firstDeaths;
+        for(auto it = outcomes.begin(); it != outcomes.end(); it++){
+            results[it->result]++;
+            played += it->seconds;
+            sum.playersAlive += it->playersAlive;
+            sum.cluesRead += it->cluesRead;
+            sum.itemsFound += it->itemsFound;
+            sum.swings += it->swings;
+            if(it->result == Match::PLAYERS_WON && it->ghostOut >= 0)
+                ghostTtk.push_back(it->seconds - it->ghostOut);
+            if(it->firstDeath >= 0)
+                firstDeaths.push_back(it->firstDeath);
+        }
+        std::sort(ghostTtk.begin(), ghostTtk.end());
+        std::sort(firstDeaths.begin(), firstDeaths.end());
+        // Wilson score interval, 95%
+        double n = matches;
+        double p = results[Match::PLAYERS_WON] / n;
+        double z = 1.96;
+        double centre = (p + z * z / (2 * n)) / (1 + z * z / n);
+        double spread = z * std::sqrt(p * (1 - p) / n + z * z / (4 * n * n)) / (1 + z * z / n);
+        double bots = n * characters.size();
+
+        for(std::size_t a = 0; a < axes.size(); a++)
+            csv << axes[a].values[at[a]] << ",";
+        char line[400];
+        std::snprintf(line, sizeof(line),
+                      "%d,%d,%d,%d,%.4f,%.4f,%.4f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.3f,%.3f,%.3f,%.3f\n",
+                      matches, results[Match::PLAYERS_WON], results[Match::VILLAIN_WON],
+                      results[Match::TIMED_OUT], p, std::max(0.0, centre - spread),
+                      std::min(1.0, centre + spread), played / n, mean(ghostTtk), quantile(ghostTtk, 0.5),
+                      quantile(ghostTtk, 0.9), mean(firstDeaths), quantile(firstDeaths, 0.5),
+                      sum.playersAlive / bots, sum.cluesRead / bots, sum.itemsFound / bots, sum.swings / bots);
+        csv << line;
+        // a run cut short keeps every line it finished
+        csv.flush();
+
+        std::snprintf(line, sizeof(line), "  %zu/%zu: players won %.1f%%, ghost lasted %.1f s, %.0f matches/s",
+                      c + 1, combinations, p * 100, mean(ghostTtk), matches / seconds);
+        std::cout << line << std::endl;
+
+        // next combination, the first axis turning fastest
+        for(std::size_t a = 0; a < axes.size(); a++){
+            if(++at[a] < axes[a].values.size())
+                break;
+            at[a] = 0;
+        }
+    }
+    double seconds = Input::now() - totalStart;
+    char line[200];
+    std::snprintf(line, sizeof(line), "HHBalance: %.0f matches in %.1f s, %.0f matches/s",
+                  totalMatches, seconds, totalMatches / seconds);
+    std::cout << line << std::endl;
+    return 0;
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "engine/Input.hpp"
+#include "engine/JobSystem.hpp"
+#include "game/sim/BotMatch.hpp"
+////////////////////////////
+// Soak test: plays matches with a bot in every seat (see
+// include/game/sim/MatchBot.hpp), flat out on every core, with no window,
+// sound or network, and says how they went and how fast they ran.
+//
+//     HHBots --matches=1000 --players=4
+//
+// Each match is its own seed (--seed, --seed + 1, ...), so any one of them
+// plays out the same way again on its own.
+///////////////////////////
+int main(int argc, char** argv)
+{
+    // --matches=N to play, --players=N in each, --threads=N (0 for one a core)
+    // --seed=N for the first, --tick=N ticks a (game) second
+    // --phase=S before the ghost's out, --limit=S before a match times out
+    int matches = 200;
+    int players = 4;
+    unsigned int threads = 0;
+    unsigned long seed = 1;
+    float tick = 60;
+    Match::Rules rules;
+    rules.timeLimitSeconds = 600;
+    for(int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        if(arg.compare(0, 10, "--matches=") == 0)
+            matches = std::max(1, std::stoi(arg.substr(10)));
+        else if(arg.compare(0, 10, "--players=") == 0)
+            players = std::max(1, std::min(4, std::stoi(arg.substr(10))));
+        else if(arg.compare(0, 10, "--threads=") == 0)
+            threads = static_cast<unsigned int>(std::max(0, std::stoi(arg.substr(10))));
+        else if(arg.compare(0, 7, "--seed=") == 0)
+            seed = std::stoul(arg.substr(7));
+        else if(arg.compare(0, 7, "--tick=") == 0)
+            tick = std::stof(arg.substr(7));
+        else if(arg.compare(0, 8, "--phase=") == 0)
+            rules.phaseSeconds = std::stof(arg.substr(8));
+        else if(arg.compare(0, 8, "--limit=") == 0)
+            rules.timeLimitSeconds = std::stof(arg.substr(8));
+        else
+            std::cout << "Unknown option " << arg << std::endl;
+    }
+    std::vector<Config::CHARACTER> characters;
+    for(int p = 0; p < players; p++)
+        characters.push_back(static_cast<Config::CHARACTER>(p));
+
+    JobSystem jobs;
+    jobs.start(threads);
+    std::vector<BotMatch::Outcome> outcomes(matches);
+    double start = Input::now();
+    jobs.parallelFor(outcomes.size(), 1, [&](std::size_t begin, std::size_t end){
+        for(std::size_t m = begin; m < end; m++)
+            outcomes[m] = BotMatch::play(seed + m, characters, rules, 1 / tick);
+    });
+    double seconds = Input::now() - start;
+
+    int results[4] = {0, 0, 0, 0};
+    double played = 0, ticks = 0;
+    BotMatch::Outcome sum;
+    for(auto it = outcomes.begin(); it != outcomes.end(); it++){
+        results[it->result]++;
+        played += it->seconds;
+        ticks += it->ticks;
+        sum.roomsVisited += it->roomsVisited;
+        sum.cluesRead += it->cluesRead;
+        sum.swings += it->swings;
+        sum.itemsFound += it->itemsFound;
+        sum.playersAlive += it->playersAlive;
+    }
+    char line[200];
+    std::snprintf(line, sizeof(line), "HHBots: %d matches of %d bots, %d rooms, on %u threads in %.2f s",
+                  matches, players, Match::getRoomCount(players), jobs.getThreadCount(), seconds);
+    std::cout << line << std::endl;
+    std::snprintf(line, sizeof(line), "  %.0f matches/s, %.2f M ticks/s, %.0fx real time (%.0f s a match on average)",
+                  matches / seconds, ticks / seconds / 1e6, played / seconds, played / matches);
+    std::cout << line << std::endl;
+    std::snprintf(line, sizeof(line), "  players won %d, ghost won %d, timed out %d",
+                  results[Match::PLAYERS_WON], results[Match::VILLAIN_WON], results[Match::TIMED_OUT]);
+    std::cout << line << std::endl;
+    double bots = static_cast<double>(matches) * players;
+    std::snprintf(line, sizeof(line), "  a bot: %.1f rooms, %.1f clues read, %.1f swings, %.2f items; %.2f of them left standing",
+                  sum.roomsVisited / bots, sum.cluesRead / bots, sum.swings / bots, sum.itemsFound / bots,
+                  sum.playersAlive / bots);
+    std::cout << line << std::endl;
+    return 0;
+}
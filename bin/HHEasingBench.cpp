@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "engine/Input.hpp"
+#include "engine/Interpolate.hpp"
+#include "engine/RandomStream.hpp"
+#include "engine/TweenManager.hpp"
+////////////////////////////
+// Easing throughput: how many tweens a second every curve evaluates one
+// at a time (the scalar functions in a loop, as the game did before) and
+// batched through interpolate::ease(), then how long TweenManager::update()
+// takes with a screenful of tweens spread over every curve.
+//
+//     HHEasingBench --tweens=4096 --seconds=0.2
+//
+// tools/EasingCheck.cpp checks the two give the same values.
+///////////////////////////
+
+namespace
+{
+    const char* NAMES[interpolate::EASE_COUNT] = {
+        "linear",
+        "expo in", "expo out", "expo in out",
+        "cubic in", "cubic out", "cubic in out",
+        "quartic in", "quartic out", "quartic in out",
+        "quintic in", "quintic out", "quintic in out",
+        "quadratic in", "quadratic out", "quadratic in out",
+        "sine in", "sine out", "sine in out",
+        "circular in", "circular out", "circular in out",
+        "back in", "back out", "back in out",
+        "elastic in", "elastic out", "elastic in out"
+    };
+
+    // everything computed is summed into this, so none of it is optimized away
+    volatile float sink;
+
+    // Runs pass over and over for about seconds, returns passes a second
+    template<typename Pass>
+    double rate(double seconds, Pass pass)
+    {
+        long passes = 0;
+        double start = Input::now();
+        double elapsed = 0;
+        while(elapsed < seconds){
+            for(int i = 0; i < 16; i++)
+                pass();
+            passes += 16;
+            elapsed = Input::now() - start;
+        }
+        return passes / elapsed;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // --tweens=N in each batch, --seconds=S timing each curve
+    std::size_t count = 4096;
+    double seconds = 0.2;
+    for(int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        if(arg.compare(0, 9, "--tweens=") == 0)
+            count = std::max(1, std::stoi(arg.substr(9)));
+        else if(arg.compare(0, 10, "--seconds=") == 0)
+            seconds = std::stod(arg.substr(10));
+        else
+            std::cout << "Unknown option " << arg << std::endl;
+    }
+
+    RandomStream rng(1, RandomStream::getNameId("easing"));
+    std::vector<float> t(count), b(count), c(count), d(count), out(count);
+    for(std::size_t i = 0; i < count; i++){
+        d[i] = static_cast<float>(rng.uniform(0.05, 5));
+        t[i] = static_cast<float>(rng.uniform(0, d[i]));
+        b[i] = static_cast<float>(rng.uniform(-500, 500));
+        c[i] = static_cast<float>(rng.uniform(-500, 500));
+    }
+
+    std::cout << "HHEasingBench: batches of " << count << ", millions of tweens a second" << std::endl;
+    char line[160];
+    std::snprintf(line, sizeof(line), "  %-18s %-7s %10s %10s %8s", "", "", "scalar", "ease()", "speedup");
+    std::cout << line << std::endl;
+    for(int e = 0; e < interpolate::EASE_COUNT; e++){
+        interpolate::EASE curve = static_cast<interpolate::EASE>(e);
+        interpolate::Function f = interpolate::function(curve);
+        double scalar = rate(seconds, [&]{
+            for(std::size_t i = 0; i < count; i++)
+                out[i] = f(t[i], b[i], c[i], d[i]);
+            sink = out[count - 1];
+        }) * count / 1e6;
+        double batched = rate(seconds, [&]{
+            interpolate::ease(curve, t.data(), b.data(), c.data(), d.data(), out.data(), count);
+            sink = out[count - 1];
+        }) * count / 1e6;
+        std::snprintf(line, sizeof(line), "  %-18s %-7s %10.1f %10.1f %7.2fx", NAMES[e],
+                      interpolate::isVectorized(curve) ? "simd" : "scalar", scalar, batched, batched / scalar);
+        std::cout << line << std::endl;
+    }
+
+    // A TweenManager with count tweens over every curve that never finish,
+    // so every update does the same work
+    TweenManager manager;
+    std::vector<float> targets(count);
+    for(std::size_t i = 0; i < count; i++)
+        manager.add(&targets[i], static_cast<interpolate::EASE>(i % interpolate::EASE_COUNT), b[i], b[i] + c[i], 1e9f);
+    double updates = rate(seconds, [&]{
+        manager.update(1 / 60.0f);
+        sink = targets[count - 1];
+    });
+    std::snprintf(line, sizeof(line), "  TweenManager::update() with %zu tweens: %.1f us, %.1f M tweens/s",
+                  count, 1e6 / updates, updates * count / 1e6);
+    std::cout << line << std::endl;
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "HouseHaunters.hpp"
+#include "engine/RandomStream.hpp"
+////////////////////////////
+// Input to photon latency: plays a match with nobody at the controls but a
+// synthetic gamepad, pressed and released at set times through
+// GameEngine::feedInput, and reports how long each press took to show up
+// on screen (GameEngine::LoopStats, from the press to the display of the
+// first frame drawn from its tick).
+//
+//     HHLatency --seconds=20 --presses=4 --pipeline --pacing=uncapped
+//
+// A press happens at a random moment, not on a tick, so the time it waits
+// for the next tick is counted the way a real one's would be. The frame
+// pacing and loop flags are HH's, to compare settings against each other.
+///////////////////////////
+
+namespace
+{
+    // past every joystick and the keyboard
+    const int PAD = sf::Joystick::Count + 1;
+
+    struct Presser
+    {
+        double next = -1;
+        double end = 0;
+        double gap = 0.25;
+        bool down = false;
+        sf::Vector2f move = sf::Vector2f(1, 0);
+        RandomStream rng;
+    };
+}
+
+int main(int argc, char** argv)
+{
+    HouseHauntersGame game;
+    // --seconds=S to play for, --presses=N a second (each press is released
+    // halfway to the next), --seed=N for the house and the press times
+    // --pacing=... --fps=N --tick=N --max-substeps=N --no-interpolation
+    // --pipeline --jobs=N as for HH
+    double seconds = 20;
+    double presses = 4;
+    unsigned long seed = 1;
+    FramePacer::MODE pacing = FramePacer::VSYNC;
+    float fps = 60;
+    for(int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        if(arg.compare(0, 10, "--seconds=") == 0)
+            seconds = std::stod(arg.substr(10));
+        else if(arg.compare(0, 10, "--presses=") == 0)
+            presses = std::max(0.1, std::stod(arg.substr(10)));
+        else if(arg.compare(0, 7, "--seed=") == 0)
+            seed = std::stoul(arg.substr(7));
+        else if(arg.compare(0, 9, "--pacing=") == 0){
+            if(!FramePacer::parseMode(arg.substr(9), pacing))
+                std::cout << "Unknown pacing " << arg.substr(9) << ", using vsync" << std::endl;
+        }
+        else if(arg.compare(0, 6, "--fps=") == 0)
+            fps = std::stof(arg.substr(6));
+        else if(arg.compare(0, 7, "--tick=") == 0)
+            game.setTickRate(std::stof(arg.substr(7)));
+        else if(arg.compare(0, 15, "--max-substeps=") == 0)
+            game.setMaxSubSteps(std::stoi(arg.substr(15)));
+        else if(arg == "--no-interpolation")
+            game.setInterpolation(false);
+        else if(arg == "--pipeline")
+            game.setPipelined(true);
+        else if(arg.compare(0, 7, "--jobs=") == 0)
+            game.setJobThreads(std::stoi(arg.substr(7)));
+        else
+            std::cout << "Unknown option " << arg << std::endl;
+    }
+    game.setSeed(seed);
+    game.setPacing(pacing, fps);
+    game.setQuickStart(std::vector<int>(1, PAD));
+
+    Presser presser;
+    presser.gap = 1 / presses;
+    presser.rng = RandomStream(seed, RandomStream::getNameId("presses"));
+    game.setInputFeed([&](double now){
+        if(presser.next < 0){
+            presser.end = now + seconds;
+            presser.next = now + presser.rng.uniform(0, presser.gap);
+        }
+        if(now >= presser.end){
+            game.quit();
+            return;
+        }
+        // at most one edge a tick, stamped with when it happened
+        if(now < presser.next)
+            return;
+        double at = presser.next;
+        presser.down = !presser.down;
+        Input::Actions held;
+        held[Input::ATTACK] = presser.down;
+        if(presser.down)
+            presser.move = -presser.move;
+        game.feedInput(PAD, held, presser.down ? presser.move : sf::Vector2f(), at);
+        // let go half a gap later, press again anywhere from a quarter to
+        // three quarters of one after that, so presses land all over a tick
+        presser.next = at + presser.gap * (presser.down ? 0.5 : presser.rng.uniform(0.25, 0.75));
+    });
+    game.start();
+
+    GameEngine::LoopStats s = game.takeLoopStats();
+    char line[200];
+    std::snprintf(line, sizeof(line), "HHLatency: %u frames, %u ticks, %u frames drawn alongside a tick, worst frame %.1f ms",
+                  s.frames, s.ticks, s.pipelined, s.worstFrameSeconds * 1000);
+    std::cout << line << std::endl;
+    if(!s.inputs){
+        std::cout << "HHLatency: no presses made it to the screen" << std::endl;
+        return 1;
+    }
+    std::snprintf(line, sizeof(line), "HHLatency: %u presses and releases, pressed to displayed in %.1f ms on average, %.1f ms at worst",
+                  s.inputs, s.inputLatencySeconds / s.inputs * 1000, s.worstInputLatencySeconds * 1000);
+    std::cout << line << std::endl;
+    return 0;
+}
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include "engine/RandomStream.hpp"
+#include "game/sim/MatchClient.hpp"
+////////////////////////////
+// Load test for bin/HHServer.cpp: plays hundreds of matches against it at
+// once with bots, then asks it how busy that kept it. A match that ends is
+// replaced by a new one, so the count stays put.
+//
+//     HHServer --threads=1 &
+//     HHLoad --matches=300 --seconds=30
+//
+// The bots just wander, swing at the ghost when it's close and poke at
+// furniture now and then; they're there to make traffic, not to win.
+///////////////////////////
+
+namespace
+{
+    struct Bot
+    {
+        sf::Vector2f heading;
+        float turnIn = 0;
+        bool run = false;
+        bool swung = false;
+        float useIn = 0;
+    };
+
+    Lockstep::Frame think(Bot& bot, const MatchSnapshot& s, int player, float dt, RandomStream& rng)
+    {
+        Input::Actions down;
+        bot.turnIn -= dt;
+        if(bot.turnIn <= 0){
+            double angle = rng.uniform(0, 2 * M_PI);
+            bot.heading = sf::Vector2f(std::cos(angle), std::sin(angle));
+            bot.run = rng.bernoulli(0.3) != 0;
+            bot.turnIn = static_cast<float>(rng.uniform(0.5, 2));
+        }
+        sf::Vector2f move = bot.heading;
+        if(player < static_cast<int>(s.entities.size()) && s.hasVillain()){
+            sf::Vector2f me = s.entities[player].getPosition();
+            sf::Vector2f ghost = s.entities.back().getPosition();
+            sf::Vector2f d = ghost - me;
+            float distance = std::sqrt(d.x * d.x + d.y * d.y);
+            // turn to face it and swing, letting go in between
+            if(distance < 96 && distance > 0){
+                move = d / distance;
+                bot.swung = !bot.swung;
+                down[Input::ATTACK] = bot.swung;
+            }
+        }
+        bot.useIn -= dt;
+        if(bot.useIn <= 0){
+            down[Input::USE] = true;
+            bot.useIn = static_cast<float>(rng.uniform(1, 4));
+        }
+        down[Input::RUN] = bot.run;
+        return Lockstep::Frame::pack(down, move);
+    }
+
+    struct Game
+    {
+        std::unique_ptr<MatchClient> client;
+        std::vector<Bot> bots;
+    };
+}
+
+int main(int argc, char** argv)
+{
+    // --host=H --port=P where HHServer is, --server-threads=N how many of its
+    //   ports (P, P + 1, ...) to spread the matches over
+    // --matches=N matches at once, --players=N in each
+    // --seconds=S to measure for (after a couple of seconds to get going)
+    // --tick=N inputs sent a second, --seed=N for the first match
+    std::string host = "127.0.0.1";
+    unsigned short port = 5000;
+    int serverThreads = 1;
+    int matches = 200;
+    int players = 4;
+    float seconds = 20;
+    float tick = 60;
+    unsigned long seed = 1;
+    const float warmup = 2;
+    for(int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        if(arg.compare(0, 7, "--host=") == 0)
+            host = arg.substr(7);
+        else if(arg.compare(0, 7, "--port=") == 0)
+            port = static_cast<unsigned short>(std::stoi(arg.substr(7)));
+        else if(arg.compare(0, 17, "--server-threads=") == 0)
+            serverThreads = std::max(1, std::stoi(arg.substr(17)));
+        else if(arg.compare(0, 10, "--matches=") == 0)
+            matches = std::max(1, std::stoi(arg.substr(10)));
+        else if(arg.compare(0, 10, "--players=") == 0)
+            players = std::max(1, std::min(4, std::stoi(arg.substr(10))));
+        else if(arg.compare(0, 10, "--seconds=") == 0)
+            seconds = std::stof(arg.substr(10));
+        else if(arg.compare(0, 7, "--tick=") == 0)
+            tick = std::stof(arg.substr(7));
+        else if(arg.compare(0, 7, "--seed=") == 0)
+            seed = std::stoul(arg.substr(7));
+        else
+            std::cout << "Unknown option " << arg << std::endl;
+    }
+    sf::IpAddress address(host);
+    std::vector<Config::CHARACTER> characters;
+    for(int p = 0; p < players; p++)
+        characters.push_back(static_cast<Config::CHARACTER>(p));
+    RandomStream rng(seed, RandomStream::getNameId("bots"));
+    std::vector<Game> games(matches);
+    unsigned long nextSeed = seed;
+    auto begin = [&](Game& g, int n){
+        g.client.reset(new MatchClient());
+        g.client->open(address, static_cast<unsigned short>(port + n % serverThreads),
+                       static_cast<sf::Uint32>(nextSeed++), characters);
+        g.bots.assign(players, Bot());
+    };
+    for(int n = 0; n < matches; n++)
+        begin(games[n], n);
+    std::cout << "HHLoad: " << matches << " matches of " << players << " on " << host
+              << ":" << port << "-" << port + serverThreads - 1 << std::endl;
+
+    float dt = 1 / tick;
+    double start = Input::now();
+    double next = start;
+    bool measuring = false;
+    std::vector<MatchServer::Load> before(serverThreads);
+    MatchClient::Stats counted;
+    unsigned int ended = 0;
+    double measuredFrom = 0;
+    while(Input::now() - start < warmup + seconds){
+        if(!measuring && Input::now() - start >= warmup){
+            for(auto it = games.begin(); it != games.end(); it++){
+                const MatchClient::Stats& s = it->client->getStats();
+                counted.bytesReceived -= s.bytesReceived;
+                counted.bytesSent -= s.bytesSent;
+                counted.snapshots -= s.snapshots;
+                counted.undecodable -= s.undecodable;
+            }
+            measuring = true;
+            measuredFrom = Input::now();
+            for(int t = 0; t < serverThreads; t++)
+                MatchClient::askLoad(address, port + t, before[t]);
+        }
+        for(int n = 0; n < matches; n++){
+            Game& g = games[n];
+            MatchClient& c = *g.client;
+            c.receive();
+            const MatchSnapshot& s = c.getSnapshot();
+            if(c.hasSnapshot() && s.result != Match::PLAYING){
+                // a fresh one in its place
+                const MatchClient::Stats& st = c.getStats();
+                if(measuring){
+                    counted.bytesReceived += st.bytesReceived;
+                    counted.bytesSent += st.bytesSent;
+                    counted.snapshots += st.snapshots;
+                    counted.undecodable += st.undecodable;
+                    ended++;
+                }
+                begin(g, n);
+                continue;
+            }
+            for(int i = 0; i < c.getSeatCount(); i++)
+                c.setInput(i, think(g.bots[i], s, c.getSeat(i), dt, rng));
+            c.send();
+        }
+        next += dt;
+        double now = Input::now();
+        if(next > now)
+            std::this_thread::sleep_for(std::chrono::duration<double>(next - now));
+        else
+            next = now;
+    }
+    double measured = Input::now() - measuredFrom;
+    for(auto it = games.begin(); it != games.end(); it++){
+        const MatchClient::Stats& s = it->client->getStats();
+        counted.bytesReceived += s.bytesReceived;
+        counted.bytesSent += s.bytesSent;
+        counted.snapshots += s.snapshots;
+        counted.undecodable += s.undecodable;
+    }
+
+    char line[200];
+    std::snprintf(line, sizeof(line), "HHLoad: %.1f s, %u matches ended, %.1f snapshots/s per match (%u undecodable)",
+                  measured, ended, counted.snapshots / measured / matches, counted.undecodable);
+    std::cout << line << std::endl;
+    std::snprintf(line, sizeof(line), "  per match: %.0f B/s down, %.0f B/s up, %.1f B per snapshot",
+                  counted.bytesReceived / measured / matches, counted.bytesSent / measured / matches,
+                  counted.snapshots ? static_cast<double>(counted.bytesReceived) / counted.snapshots : 0.0);
+    std::cout << line << std::endl;
+    std::vector<MatchServer::Load> loads;
+    for(int t = 0; t < serverThreads; t++){
+        MatchServer::Load after;
+        if(!MatchClient::askLoad(address, port + t, after)){
+            std::cout << "  server thread " << t << " didn't answer" << std::endl;
+            continue;
+        }
+        loads.push_back(after.since(before[t]));
+    }
+    if(loads.empty())
+        return 1;
+    MatchServer::Load sum = MatchServer::total(loads);
+    std::snprintf(line, sizeof(line), "  server: %d matches on %u threads, %.1f%% busy, %u late ticks, %.0f matches per core",
+                  sum.matches, static_cast<unsigned>(loads.size()),
+                  sum.busySeconds / std::max(0.001f, sum.seconds * loads.size()) * 100,
+                  sum.overruns, sum.getMatchesPerCore());
+    std::cout << line << std::endl;
+    return 0;
+}
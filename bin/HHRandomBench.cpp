@@ -0,0 +1,120 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "engine/Input.hpp"
+#include "engine/RandomStream.hpp"
+////////////////////////////
+// How fast RandomStream (Philox, see include/engine/RandomStream.hpp) hands
+// out variates next to the Lehmer generator it replaced: draws the same
+// distributions from both and reports millions of variates a second.
+//
+//     HHRandomBench --count=100000000
+//
+// The Lehmer generator is Park & Miller's, as Random.cpp had it (one
+// stream, the same Schrage multiply), and its variates are rvgs.c's
+// formulas on top of it, the same ones RandomStream ports.
+///////////////////////////
+
+namespace
+{
+    class Lehmer
+    {
+    public:
+        double random()
+        {
+            const long Q = MODULUS / MULTIPLIER;
+            const long R = MODULUS % MULTIPLIER;
+            long t = MULTIPLIER * (state % Q) - R * (state / Q);
+            state = t > 0 ? t : t + MODULUS;
+            return (double) state / MODULUS;
+        }
+        long equilikely(long a, long b) { return a + (long) ((b - a + 1) * random()); };
+        double exponential(double m) { return -m * log(1.0 - random()); };
+        double normal(double m, double s)
+        {
+            const double p0 = 0.322232431088;     const double q0 = 0.099348462606;
+            const double p1 = 1.0;                const double q1 = 0.588581570495;
+            const double p2 = 0.342242088547;     const double q2 = 0.531103462366;
+            const double p3 = 0.204231210245e-1;  const double q3 = 0.103537752850;
+            const double p4 = 0.453642210148e-4;  const double q4 = 0.385607006340e-2;
+            double u = random();
+            double t = u < 0.5 ? sqrt(-2.0 * log(u)) : sqrt(-2.0 * log(1.0 - u));
+            double p = p0 + t * (p1 + t * (p2 + t * (p3 + t * p4)));
+            double q = q0 + t * (q1 + t * (q2 + t * (q3 + t * q4)));
+            return m + s * (u < 0.5 ? (p / q) - t : t - (p / q));
+        }
+    private:
+        static const long MODULUS = 2147483647;
+        static const long MULTIPLIER = 48271;
+        long state = 123456789;
+    };
+
+    // everything drawn is summed into this, so none of it is optimized away
+    volatile double sink;
+
+    // Runs draw count times and returns millions a second
+    template<typename Draw>
+    double rate(long count, Draw draw)
+    {
+        double sum = 0;
+        double start = Input::now();
+        for(long i = 0; i < count; i++)
+            sum += draw();
+        double seconds = Input::now() - start;
+        sink = sum;
+        return count / seconds / 1e6;
+    }
+
+    void report(const char* variate, double lehmer, double philox)
+    {
+        char line[160];
+        std::snprintf(line, sizeof(line), "  %-22s %8.1f M/s %8.1f M/s %7.2fx", variate, lehmer, philox, philox / lehmer);
+        std::cout << line << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // --count=N variates of each kind
+    long count = 100000000;
+    for(int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        if(arg.compare(0, 8, "--count=") == 0)
+            count = std::max(1000L, std::stol(arg.substr(8)));
+        else
+            std::cout << "Unknown option " << arg << std::endl;
+    }
+
+    Lehmer lehmer;
+    RandomStream stream(123456789, RandomStream::getNameId("bench"));
+    std::cout << "HHRandomBench: " << count << " of each" << std::endl;
+    char header[160];
+    std::snprintf(header, sizeof(header), "  %-22s %12s %12s %8s", "", "Lehmer", "RandomStream", "speedup");
+    std::cout << header << std::endl;
+    report("uniform (0, 1)", rate(count, [&]{ return lehmer.random(); }),
+                             rate(count, [&]{ return stream.random(); }));
+    report("equilikely(0, 19)", rate(count, [&]{ return (double)lehmer.equilikely(0, 19); }),
+                                rate(count, [&]{ return (double)stream.equilikely(0, 19); }));
+    report("exponential(1)", rate(count, [&]{ return lehmer.exponential(1); }),
+                             rate(count, [&]{ return stream.exponential(1); }));
+    report("normal(0, 1)", rate(count, [&]{ return lehmer.normal(0, 1); }),
+                           rate(count, [&]{ return stream.normal(0, 1); }));
+
+    // a block at a time, which Lehmer can't do (each draw needs the last)
+    const long BATCH = 4096;
+    std::vector<double> batch(BATCH);
+    double sum = 0;
+    double start = Input::now();
+    for(long done = 0; done < count; done += BATCH){
+        stream.fill(batch.data(), BATCH);
+        sum += batch[0] + batch[BATCH - 1];
+    }
+    sink = sum;
+    double filled = count / (Input::now() - start) / 1e6;
+    double uniform = rate(count, [&]{ return lehmer.random(); });
+    report("uniform, fill()", uniform, filled);
+    return 0;
+}
@@ -0,0 +1,211 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "components/Islands.hpp"
+#include "engine/Input.hpp"
+#include "engine/JobSystem.hpp"
+#include "engine/RandomStream.hpp"
+#include "game/rooms/HouseLayout.hpp"
+////////////////////////////
+// How the island update scales with threads: thousands of walkers in a big
+// house, split into islands every tick the way EntityGroup does it (see
+// include/components/Islands.hpp) and updated an island a job on a
+// JobSystem of 1, 2, ... N threads.
+//
+//     HHScaleBench --entities=500,1000,2000,4000 --rooms=400 --ticks=120 --threads=8
+//
+// A walker does what a Character does in a tick without the pictures:
+// steps along its heading if the house lets it (turning at random if not)
+// and checks itself against everyone else in its island. Every thread
+// count has to end with the walkers in the same places as one thread, or
+// the islands weren't independent after all.
+//
+// The more walkers a house holds the more doorways have someone in them,
+// and the fewer (and bigger) the islands, so it's run at a few crowds.
+///////////////////////////
+
+namespace
+{
+    // what EntityGroup gives the islands
+    const float REACH = 16;
+    const float DT = 1 / 60.0f;
+    const float SPEED = 120;
+
+    struct Walker
+    {
+        sf::FloatRect box;
+        sf::Vector2f heading;
+        RandomStream rng;
+        // everyone it's touched, so the checks can't be optimized away
+        unsigned long touches = 0;
+    };
+
+    void turn(Walker& w)
+    {
+        double angle = w.rng.uniform(0, 2 * M_PI);
+        w.heading = sf::Vector2f(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+
+    std::vector<Walker> spawn(const HouseLayout& house, std::size_t count, unsigned long seed)
+    {
+        RandomStream rng(seed, RandomStream::getNameId("spawn"));
+        std::vector<Walker> walkers(count);
+        for(std::size_t i = 0; i < count; i++){
+            Walker& w = walkers[i];
+            w.rng = RandomStream(seed, i + 1);
+            const sf::FloatRect& floor = house.rooms[rng.equilikely(0, house.rooms.size() - 1)].floor;
+            w.box = sf::FloatRect(static_cast<float>(rng.uniform(floor.left, floor.left + floor.width - 16)),
+                                  static_cast<float>(rng.uniform(floor.top, floor.top + floor.height - 16)), 16, 16);
+            turn(w);
+        }
+        return walkers;
+    }
+
+    void updateIsland(const HouseLayout& house, std::vector<Walker>& walkers, const std::vector<std::size_t>& members)
+    {
+        for(auto it = members.begin(); it != members.end(); it++){
+            Walker& w = walkers[*it];
+            sf::FloatRect next = w.box;
+            next.left += w.heading.x * SPEED * DT;
+            next.top += w.heading.y * SPEED * DT;
+            if(house.isInside(next))
+                w.box = next;
+            else
+                turn(w);
+            for(auto other = members.begin(); other != members.end(); other++)
+                if(*other != *it && w.box.intersects(walkers[*other].box))
+                    w.touches++;
+        }
+    }
+
+    std::vector<std::size_t> parseCounts(const std::string& list)
+    {
+        std::vector<std::size_t> counts;
+        std::size_t start = 0;
+        while(start < list.size()){
+            std::size_t comma = list.find(',', start);
+            if(comma == std::string::npos)
+                comma = list.size();
+            counts.push_back(std::max(1, std::stoi(list.substr(start, comma - start))));
+            start = comma + 1;
+        }
+        return counts;
+    }
+
+    // where everyone ended up, to compare runs
+    unsigned long checksum(const std::vector<Walker>& walkers)
+    {
+        unsigned long h = 14695981039346656037ul;
+        for(auto it = walkers.begin(); it != walkers.end(); it++){
+            h = (h ^ static_cast<unsigned long>(std::lround(it->box.left * 64))) * 1099511628211ul;
+            h = (h ^ static_cast<unsigned long>(std::lround(it->box.top * 64))) * 1099511628211ul;
+            h = (h ^ it->touches) * 1099511628211ul;
+        }
+        return h;
+    }
+    // Times entities walkers on 1..maxThreads threads; false if any thread
+    // count ends up with them somewhere else than one thread does
+    bool scale(const HouseLayout& house, const std::vector<sf::FloatRect>& areas, std::size_t entities,
+               int ticks, unsigned int maxThreads, unsigned long seed)
+    {
+        char line[200];
+        std::cout << entities << " walkers" << std::endl;
+        std::snprintf(line, sizeof(line), "  %7s %10s %10s %10s %8s %8s %9s %9s", "threads", "ms/tick", "partition",
+                      "update", "speedup", "islands", "largest", "walkers");
+        std::cout << line << std::endl;
+        double oneThread = 0;
+        unsigned long expected = 0;
+        bool same = true;
+        for(unsigned int threads = 1; threads <= maxThreads; threads++){
+            JobSystem jobs;
+            jobs.start(threads);
+            std::vector<Walker> walkers = spawn(house, entities, seed);
+            std::vector<sf::FloatRect> boxes(walkers.size());
+            Islands islands;
+            double partitioning = 0;
+            double updating = 0;
+            double islandCount = 0;
+            std::size_t largest = 0;
+            for(int t = 0; t < ticks; t++){
+                double start = Input::now();
+                for(std::size_t i = 0; i < walkers.size(); i++)
+                    boxes[i] = walkers[i].box;
+                islands.partition(areas, boxes, REACH);
+                double split = Input::now();
+                jobs.parallelFor(islands.getCount(), 1, [&](std::size_t begin, std::size_t end){
+                    for(std::size_t i = begin; i < end; i++)
+                        updateIsland(house, walkers, islands.getMembers(i));
+                });
+                double done = Input::now();
+                partitioning += split - start;
+                updating += done - split;
+                islandCount += islands.getCount();
+                for(std::size_t i = 0; i < islands.getCount(); i++)
+                    largest = std::max(largest, islands.getMembers(i).size());
+            }
+            double perTick = (partitioning + updating) / ticks * 1000;
+            unsigned long sum = checksum(walkers);
+            if(threads == 1){
+                oneThread = perTick;
+                expected = sum;
+            }
+            same = same && sum == expected;
+            std::snprintf(line, sizeof(line), "  %7u %10.3f %10.3f %10.3f %7.2fx %8.1f %9zu %9s", threads, perTick,
+                          partitioning / ticks * 1000, updating / ticks * 1000, oneThread / perTick,
+                          islandCount / ticks, largest, sum == expected ? "same" : "DIFFERENT");
+            std::cout << line << std::endl;
+        }
+        return same;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // --entities=N,N,... walkers in a house of --rooms=N, --ticks=N timed
+    // --threads=N the most threads to try, --seed=N for the house and walkers
+    std::vector<std::size_t> crowds = {500, 1000, 2000, 4000};
+    int roomCount = 400;
+    int ticks = 120;
+    unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned long seed = 1;
+    for(int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        if(arg.compare(0, 11, "--entities=") == 0)
+            crowds = parseCounts(arg.substr(11));
+        else if(arg.compare(0, 8, "--rooms=") == 0)
+            roomCount = std::min(HouseLayout::GRID * HouseLayout::GRID, std::max(1, std::stoi(arg.substr(8))));
+        else if(arg.compare(0, 8, "--ticks=") == 0)
+            ticks = std::max(1, std::stoi(arg.substr(8)));
+        else if(arg.compare(0, 10, "--threads=") == 0)
+            maxThreads = std::max(1, std::stoi(arg.substr(10)));
+        else if(arg.compare(0, 7, "--seed=") == 0)
+            seed = std::stoul(arg.substr(7));
+        else
+            std::cout << "Unknown option " << arg << std::endl;
+    }
+
+    HouseLayout house;
+    RandomStream houseRng(seed, RandomStream::getNameId("house"));
+    house.generate(roomCount, houseRng);
+    // what RoomGroup hands EntityGroup: every room and every doorway
+    std::vector<sf::FloatRect> areas;
+    for(auto it = house.rooms.begin(); it != house.rooms.end(); it++)
+        areas.push_back(it->area);
+    for(auto it = house.doors.begin(); it != house.doors.end(); it++)
+        areas.push_back(it->floor);
+
+    std::cout << "HHScaleBench: " << house.rooms.size() << " rooms, " << ticks << " ticks, "
+              << std::thread::hardware_concurrency() << " cores" << std::endl;
+    bool same = true;
+    for(auto crowd = crowds.begin(); crowd != crowds.end(); crowd++)
+        same = scale(house, areas, *crowd, ticks, maxThreads, seed) && same;
+    if(!same){
+        std::cerr << "HHScaleBench: islands updated in parallel ended up somewhere else" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include "game/sim/MatchServer.hpp"
+////////////////////////////
+// The House Haunters dedicated server. No window, no sound: it runs
+// matches (see include/game/sim/Match.hpp) for clients that send it their
+// inputs, as many as its threads can keep ticking.
+//
+// Try it with bin/HHLoad.cpp.
+///////////////////////////
+int main(int argc, char** argv)
+{
+    // --port=P listens on P, P + 1, ... one port per thread (default 5000)
+    // --threads=N runs N threads (default one per core)
+    // --tick=N ticks N times a second, --snapshot-every=N sends every Nth tick
+    // --phase=S brings the ghost out after S seconds instead of 90
+    // --report=S prints the load every S seconds (0 for never)
+    // --checkpoint=DIR quick-saves matches into DIR (and resumes them from
+    //   it), every S seconds with --checkpoint-every=S (default 5)
+    unsigned short port = 5000;
+    int threads = std::max(1u, std::thread::hardware_concurrency());
+    float report = 5;
+    MatchServer server;
+    Match::Rules rules;
+    std::string checkpoints;
+    float checkpointEvery = 5;
+    for(int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        if(arg.compare(0, 7, "--port=") == 0)
+            port = static_cast<unsigned short>(std::stoi(arg.substr(7)));
+        else if(arg.compare(0, 10, "--threads=") == 0)
+            threads = std::max(1, std::stoi(arg.substr(10)));
+        else if(arg.compare(0, 7, "--tick=") == 0)
+            server.setTickRate(std::stof(arg.substr(7)));
+        else if(arg.compare(0, 17, "--snapshot-every=") == 0)
+            server.setSnapshotInterval(std::stoi(arg.substr(17)));
+        else if(arg.compare(0, 8, "--phase=") == 0)
+            rules.phaseSeconds = std::stof(arg.substr(8));
+        else if(arg.compare(0, 9, "--report=") == 0)
+            report = std::stof(arg.substr(9));
+        else if(arg.compare(0, 13, "--checkpoint=") == 0)
+            checkpoints = arg.substr(13);
+        else if(arg.compare(0, 19, "--checkpoint-every=") == 0)
+            checkpointEvery = std::stof(arg.substr(19));
+        else
+            std::cout << "Unknown option " << arg << std::endl;
+    }
+    if(!server.setRules(rules))
+        return 1;
+    server.setCheckpoints(checkpoints, checkpointEvery);
+    if(!server.start(port, threads))
+        return 1;
+    while(true){
+        std::this_thread::sleep_for(std::chrono::duration<float>(report > 0 ? report : 60));
+        if(report > 0)
+            server.report(std::cout);
+    }
+    return 0;
+}
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "engine/RandomStream.hpp"
+#include "game/sim/MatchSave.hpp"
+#include "game/sim/MatchState.hpp"
+////////////////////////////
+// How big MatchStates come out and how fast they write and read back:
+// plays some matches with random inputs, saves every tick, then writes
+// each tick as a keyframe, as a delta against the tick before and as a
+// delta against the last keyframe, both QUANTIZED and EXACT.
+//
+//     HHStateBench --matches=20 --players=4 --seconds=120
+//
+// Every keyframe also goes into a MatchSave file (--save=FILE), and
+// halfway through each match a copy is quick-loaded from it, played on
+// with the same inputs and checked against the original at the end.
+///////////////////////////
+
+namespace
+{
+    struct Sizes
+    {
+        double bytes = 0;
+        std::size_t most = 0;
+        unsigned int count = 0;
+        void add(std::size_t b)
+        {
+            bytes += b;
+            most = std::max(most, b);
+            count++;
+        }
+        double average() const { return count ? bytes / count : 0; };
+    };
+
+    // Ways of writing each tick, QUANTIZED then EXACT
+    enum BASE {KEYFRAME, LAST_TICK, LAST_KEYFRAME, BASE_COUNT};
+    const char* BASE_NAMES[BASE_COUNT] = {"keyframe", "delta on last tick", "delta on keyframe"};
+
+    std::vector<uint8_t> bytesOf(const MatchState& s, const MatchState* base, MatchState::PRECISION precision)
+    {
+        BitWriter out;
+        s.write(out, base, precision);
+        return std::vector<uint8_t>(out.getData(), out.getData() + out.getByteCount());
+    }
+
+    // Holds a heading a while, runs now and then, pokes at things
+    void randomInput(RandomStream& rng, Input::Actions& down, sf::Vector2f& move)
+    {
+        if(rng.bernoulli(0.02)){
+            double angle = rng.uniform(0, 2 * M_PI);
+            move = sf::Vector2f(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+            down[Input::RUN] = rng.bernoulli(0.3) != 0;
+        }
+        down[Input::USE] = down[Input::USE] ? rng.bernoulli(0.9) != 0 : rng.bernoulli(0.01) != 0;
+        down[Input::ATTACK] = rng.bernoulli(0.05) != 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    // --matches=N to play, --players=N in each (the house grows with them)
+    // --seconds=S of each match, --tick=N ticks a second
+    // --keyframe-every=N ticks for the delta-on-keyframe sizes
+    // --seed=N for the first match
+    // --save=FILE to quick-save into (removed afterwards)
+    int matches = 20;
+    int players = 4;
+    float seconds = 120;
+    float tick = 60;
+    int keyframeEvery = 60;
+    unsigned long seed = 1;
+    std::string saveFile = "HHStateBench.hhs";
+    for(int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        if(arg.compare(0, 10, "--matches=") == 0)
+            matches = std::max(1, std::stoi(arg.substr(10)));
+        else if(arg.compare(0, 10, "--players=") == 0)
+            players = std::max(1, std::min(4, std::stoi(arg.substr(10))));
+        else if(arg.compare(0, 10, "--seconds=") == 0)
+            seconds = std::stof(arg.substr(10));
+        else if(arg.compare(0, 7, "--tick=") == 0)
+            tick = std::stof(arg.substr(7));
+        else if(arg.compare(0, 17, "--keyframe-every=") == 0)
+            keyframeEvery = std::max(1, std::stoi(arg.substr(17)));
+        else if(arg.compare(0, 7, "--seed=") == 0)
+            seed = std::stoul(arg.substr(7));
+        else if(arg.compare(0, 7, "--save=") == 0)
+            saveFile = arg.substr(7);
+        else
+            std::cout << "Unknown option " << arg << std::endl;
+    }
+    std::vector<Config::CHARACTER> characters;
+    for(int p = 0; p < players; p++)
+        characters.push_back(static_cast<Config::CHARACTER>(p));
+    float dt = 1 / tick;
+    int ticks = static_cast<int>(seconds * tick);
+
+    Sizes sizes[2][BASE_COUNT];
+    double writeSeconds[2][BASE_COUNT] = {};
+    double readSeconds[2] = {0, 0};
+    unsigned int mismatched = 0;
+    unsigned int restored = 0;
+    unsigned int diverged = 0;
+    Sizes quickSaves;
+    Sizes quickLoads;
+    double quickSaveSeconds = 0;
+    double quickLoadSeconds = 0;
+    MatchSave save;
+    if(!save.open(saveFile))
+        return 1;
+    for(int n = 0; n < matches; n++){
+        Match match(seed + n, characters);
+        Match copy(seed + n, characters);
+        bool restoredCopy = false;
+        RandomStream rng(seed + n, RandomStream::getNameId("bench"));
+        std::vector<Input::Actions> down(players);
+        std::vector<sf::Vector2f> move(players);
+        std::vector<MatchState> states(ticks + 1);
+        match.save(states[0]);
+        for(int t = 1; t <= ticks; t++){
+            for(int p = 0; p < players; p++){
+                randomInput(rng, down[p], move[p]);
+                match.setInput(p, down[p], move[p]);
+                if(restoredCopy)
+                    copy.setInput(p, down[p], move[p]);
+            }
+            match.tick(dt);
+            if(restoredCopy)
+                copy.tick(dt);
+            match.save(states[t]);
+            if(t % keyframeEvery == 0){
+                double start = Input::now();
+                save.save(states[t]);
+                quickSaveSeconds += Input::now() - start;
+                quickSaves.add(0);
+            }
+            if(t == ticks / 2){
+                // from the file, as if starting up again after a crash
+                double start = Input::now();
+                MatchSave file;
+                MatchState loaded;
+                restoredCopy = file.open(saveFile) && file.load(loaded) && copy.restore(loaded);
+                quickLoadSeconds += Input::now() - start;
+                quickLoads.add(0);
+            }
+        }
+        if(restoredCopy){
+            restored++;
+            MatchState end;
+            copy.save(end);
+            if(bytesOf(end, NULL, MatchState::EXACT) != bytesOf(states[ticks], NULL, MatchState::EXACT))
+                diverged++;
+        }
+
+        for(int precision = 0; precision < 2; precision++){
+            MatchState::PRECISION how = static_cast<MatchState::PRECISION>(precision);
+            // all three ways of each tick, then read back the deltas
+            // on the tick before
+            std::vector<std::vector<uint8_t> > encoded(ticks + 1);
+            BitWriter out;
+            for(int b = 0; b < BASE_COUNT; b++){
+                double start = Input::now();
+                for(int t = 0; t <= ticks; t++){
+                    const MatchState* base = NULL;
+                    if(b == LAST_TICK && t > 0)
+                        base = &states[t - 1];
+                    else if(b == LAST_KEYFRAME)
+                        base = &states[t - t % keyframeEvery];
+                    out.clear();
+                    states[t].write(out, base, how);
+                    sizes[precision][b].add(out.getByteCount());
+                    if(b == LAST_TICK)
+                        encoded[t].assign(out.getData(), out.getData() + out.getByteCount());
+                }
+                writeSeconds[precision][b] += Input::now() - start;
+            }
+
+            // replaying deltas tick on tick, like a replay file
+            std::vector<MatchState> decoded(ticks + 1);
+            double start = Input::now();
+            for(int t = 0; t <= ticks; t++){
+                BitReader in(encoded[t].data(), encoded[t].size());
+                if(!decoded[t].read(in, t > 0 ? &decoded[t - 1] : NULL))
+                    mismatched++;
+            }
+            readSeconds[precision] += Input::now() - start;
+            // EXACT has to come back bit for bit
+            if(how == MatchState::EXACT){
+                for(int t = 0; t <= ticks; t += keyframeEvery)
+                    if(bytesOf(decoded[t], NULL, how) != bytesOf(states[t], NULL, how))
+                        mismatched++;
+            }
+        }
+    }
+
+    char line[200];
+    std::snprintf(line, sizeof(line), "HHStateBench: %d matches of %d players, %d rooms, %d ticks each",
+                  matches, players, Match::getRoomCount(players), ticks);
+    std::cout << line << std::endl;
+    const char* PRECISION_NAMES[2] = {"quantized", "exact"};
+    for(int precision = 0; precision < 2; precision++){
+        std::cout << "  " << PRECISION_NAMES[precision] << ":" << std::endl;
+        for(int b = 0; b < BASE_COUNT; b++){
+            const Sizes& s = sizes[precision][b];
+            double each = writeSeconds[precision][b] / s.count;
+            std::snprintf(line, sizeof(line), "    %-20s %7.1f B average, %5u B most, written in %.2f us (%.0f MB/s)",
+                          BASE_NAMES[b], s.average(), static_cast<unsigned>(s.most),
+                          each * 1e6, s.average() / each / 1e6);
+            std::cout << line << std::endl;
+        }
+        const Sizes& deltas = sizes[precision][LAST_TICK];
+        std::snprintf(line, sizeof(line), "    read back tick on tick in %.2f us each",
+                      readSeconds[precision] / deltas.count * 1e6);
+        std::cout << line << std::endl;
+    }
+    std::snprintf(line, sizeof(line), "  quick save %.1f us, quick load (open, map, read, restore) %.1f us",
+                  quickSaveSeconds / quickSaves.count * 1e6, quickLoadSeconds / quickLoads.count * 1e6);
+    std::cout << line << std::endl;
+    save.close();
+    std::remove(saveFile.c_str());
+    std::cout << "  " << mismatched << " didn't read back, " << diverged << " of " << restored
+              << " restored matches played on differently" << std::endl;
+    return mismatched || diverged ? 1 : 0;
+}
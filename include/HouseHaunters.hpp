@@ -1,6 +1,8 @@
 #include <memory>
 #include <map>
+#include <vector>
 #include "engine/Engine.hpp"
+#include "game/sim/MatchBot.hpp"
 #include "game/screens/GameplayScreen.hpp"
 #include "game/screens/GametitleScreen.hpp"
 #include "game/screens/CharacterScreen.hpp"
@@ -21,10 +23,40 @@
 
 class HouseHauntersGame: public GameEngine
 {
+public:
+    // Same seed, same house (see Config::seed)
+    void setSeed(unsigned long s){ seed = s; };
+    // Skips the menus and goes straight into a match, player i + 1 on
+    // gamepads[i] playing BRO, SIS, DAD, MOM in turn
+    void setQuickStart(const std::vector<int>& gamepads){ quickStart = gamepads; };
+    // Quick-saves go to filename; resume starts the first match from it
+    // (see Config::save_file)
+    void setSaveFile(const std::string& filename, bool resume){ saveFile = filename; resumeSave = resume; };
+    // Quick-starts a match with count bots (see MatchBot) in the seats
+    // after you on the keyboard, or with watch, in every seat
+    void setBots(int count, bool watch){ bots = count; watchBots = watch; };
 private:
+    // Plays the bots' seats: every tick, before the gamepads are read, each
+    // bot looks at the match and its gamepad is fed what it would hold
+    void feedBots(double now);
+    int bots = 0;
+    bool watchBots = false;
+    GameplayScreen* gameplay = NULL;
+    std::vector<int> botPads;
+    std::vector<MatchBot> seatBots;
+    // the match the bots were made for and how far it had got, so a new
+    // match or a load starts them afresh
+    const Match* botMatch = NULL;
+    unsigned int botTicks = 0;
+    unsigned long seed = 0;
+    std::string saveFile = "quicksave.hhs";
+    bool resumeSave = false;
+    std::vector<int> quickStart;
     // This is an overridden virtual method that gets called
     // automatically when the game starts.
     void init();
+    // Reads tuning.txt again when it's been saved
+    void onFrame();
 protected:
     std::shared_ptr<Config> config;
 };
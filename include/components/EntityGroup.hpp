@@ -2,6 +2,8 @@
 #define ENTITYGROUP_HPP
 
 #include "engine/Engine.hpp"
+#include "components/Hitbox.hpp"
+#include "components/Islands.hpp"
 #include <memory>
 #include <iostream>
 #include <set>
@@ -17,6 +19,7 @@
 
 class Character; // forward declearation
 class Clue;
+class RoomGroup;
 /**
 * A group that contains items that can interact with each other
 */
@@ -31,10 +34,44 @@ public:
     std::shared_ptr<Character> getCharacter(int pnum);
     std::shared_ptr<Clue> getClue(int cnum);
     void onUpdate(float dt);
-    void drawInArea(sf::RenderTarget& ctx, sf::FloatRect box) const;
+    // Draws the characters overlapping box, returns how many were drawn
+    int drawInArea(sf::RenderTarget& ctx, sf::FloatRect box) const;
+    struct Drawn
+    {
+        GameObject* object;
+        // its hitbox, for culling
+        const Hitbox* box;
+    };
+    // Characters and clues, back to front by z_index
+    const std::vector<Drawn>& getDrawOrder() const { return drawOrder; };
+    // The rooms decide who can affect whom (see partition())
+    void setRoomGroup(RoomGroup* g){ rooms = g; };
+    // Where islands get updated side by side; without it they take turns
+    void setJobs(JobSystem* j){ jobs = j; };
+    // Everyone c can see or touch this tick (its island, c included)
+    const std::vector<Character*>& getNeighbours(const Character& c) const;
 protected:
     std::vector<std::shared_ptr<Character>> characters;
     std::vector<std::shared_ptr<Clue>> clues;
+    // Everything in characters and clues; kept sorted by sortDrawOrder()
+    std::vector<Drawn> drawOrder;
+    // z only moves a little between ticks, so an insertion sort over last
+    // tick's order is close to linear. Stable, so ties keep their order.
+    void sortDrawOrder();
+    // Splits the characters into islands (see Islands.hpp): rooms joined up
+    // by anyone in (or within a tick's reach of) more than one, and everyone
+    // in them. No one can affect anyone in another island during a tick, so
+    // islands can update in parallel with the same result as one after another.
+    void partition();
+    void updateIsland(std::size_t i, float dt);
+    RoomGroup* rooms = NULL;
+    JobSystem* jobs = NULL;
+    // numbered by their first character, so the same every run
+    std::vector<std::vector<Character*>> islands;
+    Islands split;
+    // the rooms' and characters' hitboxes, for split
+    std::vector<sf::FloatRect> areas;
+    std::vector<sf::FloatRect> boxes;
     // Draw all the entities
     void onDraw(sf::RenderTarget& ctx, sf::RenderStates states) const;
 };
@@ -0,0 +1,48 @@
+#ifndef ISLANDS_HPP
+#define ISLANDS_HPP
+
+#include <cstddef>
+#include <vector>
+#include <SFML/Graphics/Rect.hpp>
+////////////////
+// Islands.hpp
+//
+// Splits everyone into groups that can't affect each other this tick, so
+// each group can be updated on its own thread (see EntityGroup::partition).
+//
+// Areas (rooms, doorways) that anyone reaches into are joined up, and
+// everyone in joined areas is one island. Anyone outside every area is in
+// an island of their own kind, shared with everyone else outside.
+//
+//     islands.partition(rooms, hitboxes, 16);
+//     for(std::size_t i = 0; i < islands.getCount(); i++)
+//         jobs.run(group, [&, i]{ update(islands.getMembers(i)); });
+//
+// Only needs boxes, so it builds without any of the graphics.
+////////////////
+
+class Islands
+{
+public:
+    // Numbers boxes into islands. Islands are numbered by their first box,
+    // so the same boxes always get the same islands.
+    void partition(const std::vector<sf::FloatRect>& areas,
+                   const std::vector<sf::FloatRect>& boxes, float reach);
+    std::size_t getCount() const { return count; };
+    // Indices into the boxes, in order
+    const std::vector<std::size_t>& getMembers(std::size_t island) const { return members[island]; };
+    int getIsland(std::size_t box) const { return island[box]; };
+private:
+    std::size_t find(std::size_t area);
+    // union-find over the areas, plus one for outside them all
+    std::vector<std::size_t> parent;
+    // the first area each box reaches into
+    std::vector<std::size_t> home;
+    std::vector<int> number;
+    std::vector<int> island;
+    // kept from tick to tick for their memory; only the first count are used
+    std::vector<std::vector<std::size_t>> members;
+    std::size_t count = 0;
+};
+
+#endif
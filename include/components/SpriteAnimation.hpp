@@ -35,6 +35,10 @@ public:
     void stop(){ playing = false; };
     void setLooping(bool l);
     bool isPlaying(){ return playing; };
+    // The part of the sprite sheet currently shown
+    const sf::IntRect& getFrameRect() const { return sprite.getTextureRect(); };
+    // The current frame as drawn under parent (see RenderSnapshot.hpp)
+    SpriteSnapshot snapshot(const sf::Transform& parent) const;
 protected:
     std::function<void()> onComplete;
     float time = 0;
@@ -0,0 +1,59 @@
+///////////////
+// BitStream.hpp
+//
+// Packing values into exactly as many bits as they need, for things that
+// go over the network many times a second (see MatchSnapshot).
+//
+//     BitWriter out;
+//     out.write(health, 4);
+//     out.writeSigned(dx, 9);
+//     packet.append(out.getData(), out.getByteCount());
+//
+//     BitReader in(data, size);
+//     int health = in.read(4);
+//     if(!in.isValid()) ...   // ran off the end
+//
+// Bits go in lowest first; the last byte is padded with zeros.
+///////////////
+#ifndef BIT_STREAM_HPP
+#define BIT_STREAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class BitWriter
+{
+public:
+    // The low bits of value (at most 32)
+    void write(uint32_t value, int bits);
+    void writeBool(bool value){ write(value ? 1 : 0, 1); };
+    // value in bits bits, zig-zagged so small negatives stay small
+    void writeSigned(int32_t value, int bits);
+    const uint8_t* getData() const { return data.data(); };
+    std::size_t getByteCount() const { return data.size(); };
+    std::size_t getBitCount() const { return count; };
+    void clear();
+private:
+    std::vector<uint8_t> data;
+    std::size_t count = 0;
+};
+
+class BitReader
+{
+public:
+    BitReader(const void* data, std::size_t bytes);
+    // Past the end reads zeros and stops being valid
+    uint32_t read(int bits);
+    bool readBool(){ return read(1) != 0; };
+    int32_t readSigned(int bits);
+    bool isValid() const { return valid; };
+    std::size_t getBitsLeft() const { return size * 8 - count; };
+private:
+    const uint8_t* data;
+    std::size_t size;
+    std::size_t count = 0;
+    bool valid = true;
+};
+
+#endif
@@ -1,7 +1,7 @@
 #ifndef CLUEREADER_HPP
 #define CLUEREADER_HPP
-#include "rapidxml/rapidxml.hpp"
-#include "rapidxml/rapidxml_utils.hpp"
+#include "engine/ItemDatabase.hpp"
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -12,19 +12,23 @@ struct Item {
 
 class ClueReader {
 public:
+    // Loads the item database (only the first call for a file touches the disk)
     void readFile(std::string filename);
+    // Uses the item pack compiled in at build time (no file access at all)
+    void useCompiledItems();
     void selectItems();
-    std::vector<std::string> getInfo();
-    std::vector<std::string> getCluesJackpot();
-    std::vector<std::string> getCluesSpec();
-    std::vector<std::string> getCluesVague();
-    std::vector<std::string> getCluesWorthless();
+    const std::vector<std::string>& getInfo();
+    const std::vector<std::string>& getCluesJackpot();
+    const std::vector<std::string>& getCluesSpec();
+    const std::vector<std::string>& getCluesVague();
+    const std::vector<std::string>& getCluesWorthless();
     Item getItemHigh();
     Item getItemLow();
 
 private:
-    int getNumChild(rapidxml::xml_node<> *parent);
-    std::string items;
+    void addClues(const ItemRecord& item);
+    void addInfo(const std::string& type);
+    std::shared_ptr<const ItemDatabase> db;
     Item itemHigh;
     Item itemLow;
     std::vector<std::string> info;
@@ -32,7 +36,6 @@ private:
     std::vector<std::string> cluesSpec;
     std::vector<std::string> cluesVague;
     std::vector<std::string> cluesWorthless;
-    rapidxml::xml_document<> doc;
 };
 
 #endif
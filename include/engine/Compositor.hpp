@@ -0,0 +1,64 @@
+///////////////
+// Compositor.hpp
+//
+// Split-screen compositor. Every player view draws into its own viewport of
+// one offscreen layer, and only when its picture changed; the layer keeps
+// the rest from the previous frame. compose() then puts the whole layer on
+// screen in a single draw, with the lighting shader run once across every
+// viewport instead of once per view.
+//
+//     compositor.create(720, 480);
+//     view.renderWorld(compositor.getLayer());     // per view, if dirty
+//     compositor.clearLights();
+//     compositor.addViewLight(viewport, radius);   // per view
+//     compositor.compose(window);
+//
+// Without shaders the layer is composed unlit.
+///////////////
+#ifndef COMPOSITOR_HPP
+#define COMPOSITOR_HPP
+
+#include <SFML/Graphics.hpp>
+#include "engine/LightMap.hpp"
+
+class Compositor
+{
+public:
+    static const int MAX_VIEWS = 4;
+
+    // Makes the layer for a window of width x height pixels and loads the
+    // lighting shader (or just clears it if it's already the right size).
+    // Returns false if offscreen rendering isn't supported.
+    bool create(unsigned int width, unsigned int height);
+    bool isReady() const { return ready; };
+    // What the views draw into
+    sf::RenderTexture& getLayer() { return layer; };
+
+    // Light for the next compose()
+    void clearLights();
+    // The light sources seen through camera (a view with its viewport set)
+    void addLights(const sf::View& camera, const std::vector<Light>& lights);
+    // Fallback when there's no light map: full brightness at the centre of
+    // the viewport fading to dark at radius pixels from it
+    void addViewLight(sf::FloatRect viewport, float radius);
+    LightMap& getLightMap() { return lightMap; };
+    // Draws the layer onto target (the window) in one pass
+    void compose(sf::RenderTarget& target);
+private:
+    sf::RenderTexture layer;
+    LightMap lightMap;
+    // ResourceManager's, so it can be reloaded
+    sf::Shader* shader = NULL;
+    bool ready = false;
+    bool lit = false;
+    sf::Vector2u size;
+
+    // Lighting uniforms, in window pixels with the origin at the bottom left
+    int lights = 0;
+    sf::Vector2f viewMin[MAX_VIEWS];
+    sf::Vector2f viewMax[MAX_VIEWS];
+    sf::Vector2f centers[MAX_VIEWS];
+    float radii[MAX_VIEWS];
+};
+
+#endif
@@ -14,8 +14,17 @@
 
 // Utilities
 #include "engine/Interpolate.hpp"
+#include "engine/TweenManager.hpp"
+#include "engine/Timeline.hpp"
+#include "engine/Input.hpp"
 #include "engine/Gamepad.hpp"
 #include "engine/Random.hpp"
+#include "engine/RandomStream.hpp"
+#include "engine/RenderSnapshot.hpp"
+#include "engine/FrameWorker.hpp"
+#include "engine/JobSystem.hpp"
+#include "engine/Lockstep.hpp"
+#include "engine/FileWatcher.hpp"
 // Game creation
 #include "engine/GameObject.hpp"
 #include "engine/EngineEvents.hpp"
@@ -23,6 +32,10 @@
 #include "engine/GameScreen.hpp"
 #include "engine/GameEngine.hpp"
 #include "engine/ResourceManager.hpp"
+#include "engine/GlyphAtlas.hpp"
+#include "engine/LightMap.hpp"
+#include "engine/Compositor.hpp"
+#include "engine/GpuTimer.hpp"
 // #include "engine/ClueReader.hpp"
 
 #endif
@@ -9,6 +9,7 @@
 #include <string>
 #include <memory>
 #include <functional>
+#include <vector>
 #include "engine/EngineEvents.hpp"
 
 // We have to use a shared_ptr to prevent object slicing
@@ -31,6 +32,11 @@ public:
         events = std::queue< base_event_type >();
     };
     static void notify();
+    // While into is set, events queued on this thread are appended to it
+    // instead, so jobs running side by side can hand theirs over in a fixed
+    // order (see EntityGroup::onUpdate). NULL goes back to the queue.
+    // Returns what this thread was capturing into before.
+    static std::vector<base_event_type>* captureQueued(std::vector<base_event_type>* into);
 private:
     static std::map< std::string, event_list > listeners_map;
     static std::queue< base_event_type > events;
@@ -0,0 +1,57 @@
+#ifndef FILE_WATCHER_HPP
+#define FILE_WATCHER_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+////////////////
+// FileWatcher.hpp
+//
+// Says which of the files it's watching have been saved since it was last
+// asked, for picking up edits while the game runs:
+//
+//     FileWatcher watcher;
+//     watcher.watch("../resources/tuning.txt");
+//     every frame:
+//         std::vector<std::string> saved = watcher.poll();
+//
+// On Linux it's inotify on each file's directory rather than the file
+// itself, because a lot of editors save by writing a new file and renaming
+// it over the old one. Elsewhere poll() compares modification times.
+// Files come back named exactly as they were given to watch(), each once
+// however many times it was written.
+////////////////
+
+class FileWatcher
+{
+public:
+    FileWatcher(){};
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // false if its directory can't be watched
+    bool watch(const std::string& filename);
+    // The watched files saved since the last call; never blocks
+    std::vector<std::string> poll();
+    // As poll(), but waits up to timeoutMs for something to be saved
+    std::vector<std::string> wait(int timeoutMs);
+private:
+    struct File
+    {
+        std::string name;
+        std::string directory;
+        std::string base;
+        long long modified;
+    };
+    // what's changed by modification time, for where there's no inotify
+    void compareTimes(std::vector<std::string>& saved);
+    static long long modifiedTime(const std::string& filename);
+
+    std::vector<File> files;
+    int fd = -1;
+    // inotify watch to directory
+    std::map<int, std::string> directories;
+};
+
+#endif
@@ -0,0 +1,67 @@
+///////////////
+// FramePacer.hpp
+//
+// Decides when the next frame gets drawn, and keeps a histogram of how
+// long frames actually took.
+//
+//     VSYNC     display() waits for the monitor
+//     CAPPED    SFML's framerate limit (a plain sleep, so +-1 ms or worse)
+//     UNCAPPED  draw as fast as possible
+//     ADAPTIVE  sleep most of the way to the deadline, then spin for the
+//               rest; the sleep margin adapts to how late sleeps wake up
+//
+// The simulation rate is separate (see GameEngine::setTickRate), and frames
+// drawn between ticks are interpolated, so a 144 Hz display gets smooth
+// motion from a 60 Hz simulation.
+///////////////
+#ifndef FRAME_PACER_HPP
+#define FRAME_PACER_HPP
+
+#include <SFML/Window.hpp>
+#include <chrono>
+#include <ostream>
+#include <string>
+
+class FramePacer
+{
+public:
+    enum MODE {VSYNC, CAPPED, UNCAPPED, ADAPTIVE};
+    // "vsync", "capped", "uncapped" or "adaptive"; returns false if unknown
+    static bool parseMode(const std::string& name, MODE& mode);
+    static const char* getModeName(MODE mode);
+
+    void setMode(MODE mode, float fps = 60){ this->mode = mode; this->fps = fps; };
+    MODE getMode() const { return mode; };
+    // Sets up the window for the mode (call once it's created)
+    void apply(sf::Window& window);
+    // Call right after each display(); waits out the rest of the frame in
+    // ADAPTIVE mode and records how long the frame took
+    void frameDone();
+
+    // Frame times since the last reset, as a histogram
+    void report(std::ostream& out) const;
+    void reset();
+    // Current sleep margin in ADAPTIVE mode
+    double getMarginMs() const { return margin * 1000; };
+private:
+    typedef std::chrono::steady_clock Clock;
+    void waitUntil(Clock::time_point deadline);
+
+    MODE mode = VSYNC;
+    float fps = 60;
+    bool started = false;
+    Clock::time_point last;
+    Clock::time_point deadline;
+    // seconds; starts out safe and shrinks toward what sleeps really need
+    double margin = 0.002;
+
+    // half millisecond buckets, the last one catches everything slower
+    static const int BUCKETS = 80;
+    static constexpr double BUCKET_MS = 0.5;
+    unsigned int histogram[BUCKETS] = {};
+    unsigned int frames = 0;
+    double total = 0;
+    double worst = 0;
+};
+
+#endif
@@ -0,0 +1,41 @@
+///////////////
+// FrameWorker.hpp
+//
+// A thread that runs one job at a time, handed to it by the main loop:
+//
+//     worker.run([&]{ simulate(); });   // returns straight away
+//     draw();                           // meanwhile, on this thread
+//     worker.wait();                    // job done, safe to touch its data
+///////////////
+#ifndef FRAME_WORKER_HPP
+#define FRAME_WORKER_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class FrameWorker
+{
+public:
+    FrameWorker(){};
+    ~FrameWorker();
+    FrameWorker(const FrameWorker&) = delete;
+    FrameWorker& operator=(const FrameWorker&) = delete;
+    // Starts job on the worker (waits for the previous one first)
+    void run(std::function<void()> job);
+    // Blocks until the current job is done
+    void wait();
+    // True when called from inside a job
+    bool isWorkerThread() const;
+private:
+    void loop();
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::function<void()> job;
+    bool busy = false;
+    bool quit = false;
+};
+
+#endif
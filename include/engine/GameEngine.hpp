@@ -2,6 +2,8 @@
 #define GAME_ENGINE_HPP
 
 #include <SFML/Graphics.hpp>
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -11,6 +13,11 @@
 #include "engine/GameScreen.hpp"
 #include "engine/EventManager.hpp"
 #include "engine/Gamepad.hpp"
+#include "engine/TweenManager.hpp"
+#include "engine/FramePacer.hpp"
+#include "engine/FrameWorker.hpp"
+#include "engine/JobSystem.hpp"
+#include "engine/Lockstep.hpp"
 
 // Basically a state manager
 class GameEngine
@@ -19,6 +26,8 @@ public:
     void start();
     void stop(); // pause
     void exit(); // exit the game
+    // Exits at the start of the next frame; safe from the tick's thread
+    void quit(){ quitting = true; };
 
     void update(float dt);
     void draw();
@@ -26,11 +35,81 @@ public:
     void changeGameScreen(std::string s);
     void addGameScreen(std::string id, std::unique_ptr<GameScreen> s);
     void setDebugMode(bool m){ isDebugMode = m; };
+    bool getDebugMode(){ return isDebugMode; };
 
     void setWindowRect(sf::IntRect dim){ winDim = dim; };
     void setWindowRect(int t, int l, int w, int h){ winDim = sf::IntRect(t, l, w, h); };
 
     void setName(std::string n){this->name = n;};
+    // How frames are paced (see FramePacer); fps is for CAPPED and ADAPTIVE
+    void setPacing(FramePacer::MODE mode, float fps = 60){ pacer.setMode(mode, fps); };
+    // Simulation ticks per second, independent of the frame rate
+    void setTickRate(float hz){ tickRate = hz; };
+    float getTickRate(){ return tickRate; };
+    // Draw frames that fall between ticks at interpolated positions
+    // (otherwise only frames after a tick are drawn)
+    void setInterpolation(bool on){ interpolate = on; };
+    // At most this many ticks per frame. A frame that falls further behind
+    // (a screen loading, a hiccup) drops the rest, so the game runs slow
+    // for a moment instead of every following frame catching up.
+    void setMaxSubSteps(int n){ maxSubSteps = n; };
+    // Run ticks on a second thread while the last ones are drawn, for
+    // screens that support it (see GameScreen::isPipelined). Frames show
+    // the state one batch of ticks behind, in exchange for update and draw
+    // overlapping.
+    void setPipelined(bool on){ pipelined = on; };
+    // Threads for the job system, counting the one ticking (0 is one per
+    // core). Takes effect when the game starts.
+    void setJobThreads(unsigned int n){ jobThreads = n; };
+    // Textures and shaders saved while the game runs show up on the next
+    // frame (see ResourceManager.hpp)
+    void setHotReload(bool on){ hotReload = on; };
+    // Dead zone and curve for every gamepad's stick
+    void setStickResponse(const Input::Response& r){ gpcontroller.setResponse(r); };
+    // Play over the network: gamepad i is player i of the Lockstep, and
+    // this machine's player is driven by the gamepad (or keyboard) at
+    // device. Every tick waits for every player's input, except on a
+    // screen that can roll back (GameScreen::canRollback): there a late
+    // input is guessed for up to setRollback() ticks, and the ticks are
+    // run again if the guess was wrong.
+    void setLockstep(Lockstep* l, int device = 0){ lockstep = l; netDevice = device; };
+    // How many ticks netplay may run ahead on guesses, 0 to always wait
+    void setRollback(int ticks){ rollbackTicks = ticks; };
+    // Every machine has to run the same ticks, so nothing may change the
+    // game from outside them (a reloaded tuning file, say)
+    bool isNetworked() const { return lockstep != NULL; };
+    // Called every tick right before the gamepads are read, with the time
+    // they're read at, to drive gamepads with feedInput() (bots, a test
+    // harness). Runs wherever the tick does.
+    typedef std::function<void(double now)> InputFeed;
+    void setInputFeed(InputFeed f){ inputFeed = f; };
+    // Sets gamepad index as if a device read held and move at time (see
+    // GamepadController::feed); it isn't read from a device after that.
+    // Returns how many actions went down or up.
+    int feedInput(int index, const Input::Actions& held, sf::Vector2f move, double time);
+
+    struct LoopStats
+    {
+        unsigned int frames = 0;
+        unsigned int ticks = 0;
+        // frames that hit maxSubSteps
+        unsigned int behind = 0;
+        // simulated vs wall clock time; less simulated means time was dilated
+        float simSeconds = 0;
+        float realSeconds = 0;
+        // wall clock time the simulation never caught up on
+        float droppedSeconds = 0;
+        float worstFrameSeconds = 0;
+        // frames drawn while the next ticks ran on the worker
+        unsigned int pipelined = 0;
+        // presses and releases, and how long from sampling them to the
+        // first frame showing their tick being displayed
+        unsigned int inputs = 0;
+        float inputLatencySeconds = 0;
+        float worstInputLatencySeconds = 0;
+    };
+    // Counters since the last call
+    LoopStats takeLoopStats();
 
     /*void pushGameScreen(std::unique_ptr<GameScreen> s);/**/
     /*void popGameScreen(std::unique_ptr<GameScreen> s);/**/
@@ -38,10 +117,58 @@ public:
     bool isRunning(){ return running; };
 
     sf::RenderWindow* getContext(){ return &window; };
+    // Tweens advanced once per tick, before the current screen updates
+    TweenManager& getTweens(){ return tweens; };
+    // What a gamepad (or the keyboard) is doing as of the last tick
+    const Input::State& getInput(int index) const { return gpcontroller.getState(index); };
+    // The gamepad index the keyboard plays as (the one after the joysticks
+    // found at start)
+    int getKeyboardIndex() const { return gpcontroller.count; };
+    // For splitting a tick's work over several threads
+    JobSystem& getJobs(){ return jobs; };
 private:
     bool running;
     bool isDebugMode = false;
     GamepadController gpcontroller;
+    TweenManager tweens;
+    FramePacer pacer;
+    float tickRate = 60;
+    bool interpolate = true;
+    int maxSubSteps = 5;
+    bool pipelined = false;
+    FrameWorker worker;
+    JobSystem jobs;
+    unsigned int jobThreads = 0;
+    bool hotReload = false;
+    Lockstep* lockstep = NULL;
+    int netDevice = 0;
+    int rollbackTicks = 8;
+    // Hands the Lockstep the current screen's save and restore, if it
+    // has them
+    void useRollback();
+    InputFeed inputFeed;
+    std::atomic<bool> quitting{false};
+    // Sends our input and runs any ticks a bad guess undid; false if this
+    // tick has to wait for someone's input
+    bool syncLockstep(float dt);
+    // Sets every player's gamepad to their input for this tick
+    int feedLockstep(double time);
+    // Events, tweens and the screen for one tick
+    void tick(float dt);
+    // a screen change asked for on the worker, made once it's done
+    std::string pendingScreen;
+    // Events, steps ticks and publish(); on the worker when pipelined
+    void simulate(int steps, float dt);
+    // when the earliest input in the running batch of ticks was sampled,
+    // and in the batch being shown (-1 if none)
+    double batchInput = -1;
+    double shownInput = -1;
+    // when the gamepads were last read (GamepadController::poll)
+    double polledAt = 0;
+    void presented();
+    void displayed();
+    LoopStats loopStats;
+    void reportLoopStats();
     sf::IntRect winDim;//(0, 0, 720, 480);
     sf::RenderWindow window;
     std::string name = "New_Game";
@@ -52,6 +179,9 @@ private:
     //virtual void onStop(){};
     //virtual void onResume(){};
     virtual void onUpdate(float dt){};
+    // Every frame on the main thread, after the window's events and
+    // before any tick: somewhere to read files and devices
+    virtual void onFrame(){};
     virtual bool onExit(){ return true; };
     void handleEvents();
     virtual void onEvent(){};
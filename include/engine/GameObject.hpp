@@ -6,6 +6,7 @@
 #include <functional>
 #include <memory>
 #include <list>
+#include "engine/RenderSnapshot.hpp"
 
 ////////////////////////////////
 //
@@ -37,6 +38,22 @@ public:
     void relSetPosition(int x, int y){ this->relPos = sf::Vector2f(x, y); };
     void update(float dt);
     void checkHitboxes();
+    // How far the frame being drawn is between the last tick and the next
+    // one (0 to 1), set by GameEngine before each draw
+    static float interpolation;
+    // Set by GameEngine while netplay runs ticks again after a rollback:
+    // the state catches up, but what was heard or seen then (sounds,
+    // fades) shouldn't start a second time
+    static bool replaying;
+    // Where to draw the object this frame: between where it was before the
+    // last tick and where it is now. Jumps (teleports) aren't smoothed.
+    sf::Vector2f getRenderPosition() const;
+    sf::Vector2f getPreviousPosition() const { return hasPrevPosition ? prevPosition : getPosition(); };
+    // The same blend for any pair of positions
+    static sf::Vector2f interpolate(sf::Vector2f from, sf::Vector2f to);
+    // Copies what draw() would draw, for drawing it later or on another
+    // thread (see RenderSnapshot.hpp). Leaves s empty by default.
+    virtual void snapshot(EntitySnapshot& s) const {};
     // static methods
     std::list<GameObjectPtr> children;
 protected:
@@ -45,6 +62,9 @@ protected:
     sf::Vector2f relPos{0, 0};
     // Parent GameObject
     GameObject* m_parent;
+    // Position at the start of the last tick (see getRenderPosition)
+    sf::Vector2f prevPosition;
+    bool hasPrevPosition = false;
     std::list<GameObjectPtr> m_hitboxes;
     // inherited from sf::Drawable
     void setParent(GameObject* p){ this->m_parent = this; };
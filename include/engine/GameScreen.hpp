@@ -20,8 +20,26 @@ public:
     virtual bool onExit() { return true; };
     void setEngine(GameEngine* e) { this->engine = e; };
     void setConfig(std::shared_ptr<Config> c){config = c;};
+    // A screen that only draws state it copied out in publish() can be drawn
+    // while its next ticks run on the simulation thread (see
+    // GameEngine::setPipelined). Everything else is updated then drawn.
+    virtual bool isPipelined() const { return false; };
+    // Copies what onDraw needs into a back buffer, after each batch of ticks
+    virtual void publish(){};
+    // Makes the last publish() what onDraw sees; nothing is updating then
+    virtual void present(){};
+    // Rollback netplay (see Lockstep.hpp): a screen that can go back to a
+    // tick lets GameEngine run ticks on a guess about someone's input.
+    // saveTick(t) keeps what the screen is before tick t runs, and
+    // restoreTick(t) puts it back (false for a tick it never saved). The
+    // ticks after it are then run again with GameObject::replaying set.
+    virtual bool canRollback() const { return false; };
+    virtual void saveTick(unsigned int tick){};
+    virtual bool restoreTick(unsigned int tick){ return false; };
     std::string screenID;
 protected:
+    // How long screens take to emerge from darkness
+    static constexpr float FADE_IN_TIME = 3.4f;
     std::shared_ptr<Config> config;
     GameEngine* engine;
 };
@@ -1,15 +1,27 @@
 #ifndef JOYSTICK_CONTROLS_HPP
 #define JOYSTICK_CONTROLS_HPP
 ///////////
-// A very rough layout of how we might
-// decide to extrapolate the joystick controls
+// Polls keyboards and joysticks into Input::State snapshots (see
+// Input.hpp) and queues a "gamepad_event" for every action that went down
+// or came up.
 //
+// The devices are read by poll(), on the thread that polls the window
+// (SFML's joystick and keyboard state belong to it), once a frame before
+// any tick runs. update() hands what was read out on the tick, which may
+// be on the FrameWorker.
+//
+// Which keys and buttons produce which action is a table per LAYOUT in
+// Gamepad.cpp; a new controller is a new table, not new code. The left
+// stick also pushes the d-pad actions (so menus work with it), and goes
+// through an Input::Response into Input::State::move.
 ////////////
 #include <string>
 #include <map>
+#include <memory>
 #include <SFML/Graphics.hpp>
 #include "engine/EventManager.hpp"
 #include "engine/EngineEvents.hpp"
+#include "engine/Input.hpp"
 
 class GamepadEvent : public BasicEvent
 {
@@ -17,28 +29,20 @@ public:
     enum TYPE {PRESSED, RELEASED, DISCONNECT, CONNECT};
     int index;
     TYPE type;
-    std::string button;
+    Input::ACTION action;
+    // when the device was sampled (Input::now())
+    double time = 0;
 };
 
-typedef struct {
-    int button;
-    bool isDown;    
-} BUTTON_S;
-
-typedef struct {
-    sf::Keyboard::Key button;
-    bool isDown;
-} KBUTTON_S;
-
 class Gamepad
 {
 public:
-    Gamepad(){};
-    Gamepad(int index) : controllerIndex(index) { setLayout(guessLayout()); };
+    Gamepad(){ makeEvents(); };
+    Gamepad(int index) : controllerIndex(index) { makeEvents(); setLayout(guessLayout()); };
     enum LAYOUT {GENERIC, PS4, PS3, XB1, XB360, KEYBOARD};
     // some setters
-    void setController(int i){ controllerIndex = i; setLayout(guessLayout()); };
-    void setIndex(int i){ this->controllerIndex = i; };
+    void setController(int i){ controllerIndex = i; makeEvents(); setLayout(guessLayout()); };
+    void setIndex(int i){ this->controllerIndex = i; makeEvents(); };
     void setActive(bool a){ this->isActive_b  = a; };
     // set layout based on enum values
     void setLayout(LAYOUT layout);
@@ -47,16 +51,38 @@ public:
     bool isConnected(){ return this->isConnected_b; };
     bool isActive(){ return this->isActive_b; };
 
-    void update();
+    // Reads the device for the next update(), at time
+    void poll(const Input::Response& stick, double time);
+    // Moves to what poll() read, returns how many actions went down or up
+    int update();
+    // Reads the device without acting on it (for sending elsewhere)
+    Input::Actions sample(const Input::Response& stick, sf::Vector2f& move);
+    // Moves to held and move as sampled at time, queuing an event for
+    // every action that went down or up; returns how many did
+    int apply(const Input::Actions& held, sf::Vector2f move, double time);
+    // Actions as of the last update()
+    const Input::State& getState() const { return state; };
     int playerIndex = -1;
+    // Driven by GamepadController::feed, so update() leaves it alone
+    bool fed = false;
+    // what poll() last read
+    Input::Actions polled;
+    sf::Vector2f polledMove;
+    double polledAt = 0;
 protected:
     // guess the controller layout by checking vendor id/name
     LAYOUT guessLayout();
     // layout
-    LAYOUT layout;
+    LAYOUT layout = LAYOUT::GENERIC;
     int controllerIndex = -1;
-    std::map<std::string, BUTTON_S> button_map;
-    std::map<std::string, KBUTTON_S> kbutton_map; // for keyboards b/c 
+    // the layout's table
+    const Input::Binding* bindings = NULL;
+    std::size_t bindingCount = 0;
+    Input::State state;
+    // One event per action and edge, made up front and queued again every
+    // time that edge happens, so polling never allocates
+    std::shared_ptr<GamepadEvent> edges[Input::ACTION_COUNT][2];
+    void makeEvents();
     bool isConnected_b = true;
     bool isActive_b = true;
 };
@@ -69,10 +95,29 @@ public:
     void disableGamepads(std::vector<int> ids); // Disable 0 or more gamepads
     void enableGamepads(std::vector<int> ids);  // Disable 1 or more gamepads
     Gamepad* getGamepad(int index){return &gamepads[index]; };
+    // Actions of the gamepad at index as of the last update (nothing held
+    // if there's no such gamepad)
+    const Input::State& getState(int index) const;
     int count = 0;
-    // Query button presses(?)
-    void update();
+    // Reads every gamepad's device (see above); on the window's thread
+    void poll();
+    // Moves every gamepad to what poll() read, returns how many actions
+    // went down or up
+    int update();
+    // What poll() last read of gamepad index, without acting on it
+    // (nothing if there isn't one)
+    Input::Actions sample(int index, sf::Vector2f& move);
+    // Sets gamepad index to what was read somewhere else (over the
+    // network, a bot), adding it if needed; returns how many actions
+    // changed. update() doesn't sample it from a device after that.
+    int feed(int index, const Input::Actions& held, sf::Vector2f move, double time);
+    // The command key is bound to, if any (see Input::COMMAND)
+    static bool getCommand(sf::Keyboard::Key key, Input::COMMAND& command);
+    // Dead zone and curve for every gamepad's stick
+    void setResponse(const Input::Response& r){ stick = r; };
+    const Input::Response& getResponse() const { return stick; };
 private:
+    Input::Response stick;
     // list of game controllers ordered by 
     std::map<int, Gamepad> gamepads;
 };
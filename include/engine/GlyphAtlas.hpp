@@ -0,0 +1,91 @@
+///////////////
+// GlyphAtlas.hpp
+//
+// Bitmap glyph atlas for one font at one size, plus strings shaped into it
+// ahead of time.
+//
+// get() rasterizes every printable ASCII glyph into the font's texture page
+// for that size the first time it's asked for, so no glyph is rendered
+// mid-game. prepare() lays a string out once and keeps the quads; shape()
+// then just copies them to wherever the string is drawn. Everything shaped
+// with one atlas shares a texture, so any amount of text (and, with fill(),
+// the boxes behind it) is a single draw.
+//
+//     GlyphAtlas& atlas = GlyphAtlas::get("../resources/fonts/Underdog-Regular.ttf", 24, true);
+//     atlas.fill(box, sf::Color::Black, quads);
+//     atlas.shape("a clue", sf::Vector2f(30, 420), sf::Color::White, quads);
+//     states.texture = &atlas.getTexture();
+//     target.draw(quads, states);
+///////////////
+#ifndef GLYPH_ATLAS_HPP
+#define GLYPH_ATLAS_HPP
+
+#include <SFML/Graphics.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class GlyphAtlas
+{
+public:
+    // The atlas for a font file at a character size, made the first time
+    // it's asked for
+    static GlyphAtlas& get(const std::string& font, unsigned int size, bool bold = false);
+
+    const sf::Texture& getTexture() const;
+    unsigned int getCharacterSize() const { return size; };
+    // Lays str out and keeps the result for shape()
+    void prepare(const std::string& str);
+    // Appends the quads for str with its origin (top left, like sf::Text)
+    // at position. Returns the bounds of what was appended.
+    sf::FloatRect shape(const std::string& str, sf::Vector2f position, sf::Color color,
+                        sf::VertexArray& out);
+    // Bounds of str relative to its origin
+    sf::FloatRect measure(const std::string& str);
+    // Appends a solid rectangle, textured from the page's white pixel so it
+    // can share a draw with the text
+    void fill(sf::FloatRect rect, sf::Color color, sf::VertexArray& out) const;
+    // Strings laid out so far
+    std::size_t getShapedCount() const { return shaped.size(); };
+private:
+    GlyphAtlas(const sf::Font* font, unsigned int size, bool bold);
+    struct Shaped
+    {
+        // white quads, origin at (0, 0)
+        std::vector<sf::Vertex> quads;
+        sf::FloatRect bounds;
+    };
+    const Shaped& lookup(const std::string& str);
+
+    const sf::Font* font;
+    unsigned int size;
+    bool bold;
+    std::unordered_map<std::string, Shaped> shaped;
+
+    static std::map<std::string, std::unique_ptr<GlyphAtlas>> atlases;
+};
+
+// A drawable string shaped with a GlyphAtlas (a stand-in for sf::Text that
+// never lays anything out while drawing)
+class ShapedText: public sf::Drawable, public sf::Transformable
+{
+public:
+    ShapedText(){};
+    void setAtlas(GlyphAtlas& atlas){ this->atlas = &atlas; rebuild(); };
+    void setString(const std::string& str){ this->str = str; rebuild(); };
+    void setColor(sf::Color color){ this->color = color; rebuild(); };
+    const std::string& getString() const { return str; };
+    sf::FloatRect getLocalBounds() const { return bounds; };
+protected:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+    void rebuild();
+    GlyphAtlas* atlas = NULL;
+    std::string str;
+    sf::Color color = sf::Color::White;
+    sf::VertexArray quads;
+    sf::FloatRect bounds;
+};
+
+#endif
@@ -0,0 +1,46 @@
+///////////////
+// GpuTimer.hpp
+//
+// Measures how long the GPU spends on a block of draw calls, using
+// GL_TIME_ELAPSED queries (OpenGL 3.3 / ARB_timer_query).
+//
+//     timer.begin();
+//     ... draw ...
+//     timer.end();
+//     float ms = timer.getMilliseconds();   // an earlier frame's result
+//
+// Results are read a frame or two late so nothing ever waits on the GPU.
+// The GL context the draws go to must be active around begin() and end()
+// (call target.setActive() first). Without timer queries every call does
+// nothing and getMilliseconds() stays at -1.
+///////////////
+#ifndef GPU_TIMER_HPP
+#define GPU_TIMER_HPP
+
+class GpuTimer
+{
+public:
+    GpuTimer(){};
+    ~GpuTimer();
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    // True if the driver has timer queries
+    static bool isAvailable();
+
+    void begin();
+    void end();
+    // Most recent finished measurement, -1 if there isn't one yet
+    float getMilliseconds();
+private:
+    void poll();
+
+    // one query being recorded while the other one finishes
+    unsigned int queries[2] = {0, 0};
+    bool pending[2] = {false, false};
+    int current = 0;
+    bool running = false;
+    float last = -1;
+};
+
+#endif
@@ -0,0 +1,105 @@
+///////////////
+// Input.hpp
+//
+// What the game asks of a controller, independent of which buttons or keys
+// produce it. Every tick each Gamepad turns its device into a State (one
+// bit per action) through its layout's table of Bindings, then queues a
+// "gamepad_event" for every bit that changed.
+//
+// Gameplay can either react to the events or poll the state:
+//
+//     const Input::State& in = engine->getInput(gamepadIndex);
+//     if(in.isDown(Input::RUN)) ...
+//     if(in.wasPressed(Input::USE)) ...
+//
+// Devices are sampled at the start of every tick and their events handed
+// out straight away, so a press changes the game in the tick that saw it.
+//
+// State::move is where the player wants to go: the left stick through a
+// radial dead zone and a response curve (see Response), or the d-pad/arrow
+// keys as whole steps when the stick is at rest.
+//
+// COMMANDs aren't anyone's controls but the game's own (quick-save and
+// so on): keys bound to them in Gamepad.cpp's table are taken from the
+// window's KeyPressed events, so only while it's focused and once per
+// press, and queued as a "command" event (Event<Input::COMMAND>).
+///////////////
+#ifndef INPUT_HPP
+#define INPUT_HPP
+
+#include <SFML/System.hpp>
+#include <bitset>
+#include <cstddef>
+
+class Input
+{
+public:
+    // Menus read USE as "pick" and ATTACK as "back"
+    enum ACTION {UP, DOWN, LEFT, RIGHT, USE, ATTACK, RUN, GIVE_UP, START, ACTION_COUNT};
+    typedef std::bitset<ACTION_COUNT> Actions;
+    enum COMMAND {QUICK_SAVE, QUICK_LOAD, COMMAND_COUNT};
+
+    // One device's actions as of the last tick
+    struct State
+    {
+        Actions down;
+        // went down or came up on the last tick
+        Actions pressed;
+        Actions released;
+        // when it was sampled (Input::now())
+        double sampledAt = 0;
+        // stick or d-pad, each axis -1 to 1 (up and left are negative)
+        sf::Vector2f move;
+        bool isDown(ACTION a) const { return down[a]; };
+        bool wasPressed(ACTION a) const { return pressed[a]; };
+        bool wasReleased(ACTION a) const { return released[a]; };
+        // Moves to a new tick's worth of held actions
+        void advance(Actions now)
+        {
+            pressed = now & ~down;
+            released = down & ~now;
+            down = now;
+        };
+    };
+
+    // Where one action comes from on one kind of device
+    struct Binding
+    {
+        enum SOURCE {KEY, BUTTON, AXIS};
+        SOURCE source;
+        // sf::Keyboard::Key, joystick button or sf::Joystick::Axis
+        int code;
+        // AXIS only: the side that counts as down, -1 or 1
+        int side;
+        ACTION action;
+    };
+
+    // Which key gives which command
+    struct CommandBinding
+    {
+        // sf::Keyboard::Key
+        int key;
+        COMMAND command;
+    };
+
+    // How a stick's raw position becomes State::move
+    struct Response
+    {
+        // fraction of the throw, from the centre, that reads as nothing
+        // (radial, so diagonals aren't favoured the way per-axis zones are)
+        float deadZone = 0.2f;
+        // past this fraction it reads as fully pushed
+        float outerZone = 0.95f;
+        // 1 is linear; above 1 gives finer control near the centre
+        float exponent = 1.5f;
+        // raw is SFML's -100 to 100 per axis
+        sf::Vector2f apply(sf::Vector2f raw) const;
+    };
+
+    // "UP", "USE", ... for logging
+    static const char* getActionName(ACTION a);
+    // Seconds on a steady clock, for timestamping samples
+    static double now();
+};
+
+#endif
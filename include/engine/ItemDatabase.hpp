@@ -0,0 +1,78 @@
+///////////////////////////
+// ItemDatabase.hpp
+//
+// Parse-once store for the item/clue definitions in resources/items.xml
+// (or resources/items.json).
+//
+// The file is memory mapped and parsed in place, so every string handed out
+// points straight into the mapping; nothing is copied into std::strings.
+// Databases are cached by filename and shared by every ClueReader, so a new
+// match never re-reads or re-parses the file.
+//
+///////////////////////////
+
+#ifndef ITEM_DATABASE_HPP
+#define ITEM_DATABASE_HPP
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One item and its clue tiers. Strings are never NULL (missing ones are "").
+struct ItemRecord
+{
+    const char* name;
+    const char* type;
+    // indexed by ItemDatabase::CLUE
+    const char* clues[4];
+};
+
+class ItemDatabase
+{
+public:
+    enum TIER { HIGH = 0, LOW = 1, TIER_COUNT = 2 };
+    enum CLUE { JACKPOT = 0, SPECIFIC = 1, VAGUE = 2, WORTHLESS = 3, CLUE_COUNT = 4 };
+
+    ~ItemDatabase();
+    ItemDatabase(const ItemDatabase&) = delete;
+    ItemDatabase& operator=(const ItemDatabase&) = delete;
+
+    // Returns the database for filename, loading it the first time it's asked for.
+    // The format is picked from the extension (.json, anything else is xml).
+    // Returns NULL if the file couldn't be read or parsed.
+    static std::shared_ptr<const ItemDatabase> load(std::string filename);
+    // The database compiled into the game from resources/items.xml at build
+    // time (see include/engine/ItemPack.hpp). Nothing is read or parsed.
+    static std::shared_ptr<const ItemDatabase> compiled();
+
+    int getItemCount(TIER tier) const { return items[tier].size(); };
+    const ItemRecord& getItem(TIER tier, int index) const { return items[tier][index]; };
+    // Indices (for getItem) of every item of a type in a tier
+    const std::vector<int>& getItemsOfType(TIER tier, const std::string& type) const;
+    // Background info lines for an item type
+    const std::vector<const char*>& getInfo(const std::string& type) const;
+    // Every type that has info lines
+    std::vector<std::string> getInfoTypes() const;
+
+private:
+    ItemDatabase(){};
+    bool mapFile(const std::string& filename);
+    bool parseXML();
+    bool parseJSON();
+    void buildIndex();
+
+    // The (privately) mapped file contents, parsed in place
+    char* text = NULL;
+    std::size_t length = 0;
+    bool mapped = false;
+
+    std::vector<ItemRecord> items[TIER_COUNT];
+    std::map<std::string, std::vector<int>> types[TIER_COUNT];
+    std::map<std::string, std::vector<const char*>> info;
+
+    static std::map<std::string, std::shared_ptr<ItemDatabase>> cache;
+};
+
+#endif
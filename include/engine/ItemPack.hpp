@@ -0,0 +1,34 @@
+///////////////////////////
+// ItemPack.hpp
+//
+// resources/items.xml compiled into constant tables. The definitions are
+// generated at build time by tools/ItemPack.cpp (see CMakeLists.txt), which
+// also refuses to build a pack with missing names, types, clues or info.
+//
+// Use ItemDatabase::compiled() rather than reading these directly.
+//
+///////////////////////////
+
+#ifndef ITEM_PACK_HPP
+#define ITEM_PACK_HPP
+
+#include "engine/ItemDatabase.hpp"
+
+struct ItemPackInfo
+{
+    const char* type;
+    const char* const* lines;
+    int count;
+};
+
+struct ItemPack
+{
+    // Every item, tier by tier. Tier t is ITEMS[TIER_START[t]] up to
+    // (but not including) ITEMS[TIER_START[t + 1]].
+    static const ItemRecord ITEMS[];
+    static const int TIER_START[ItemDatabase::TIER_COUNT + 1];
+    static const ItemPackInfo INFO[];
+    static const int INFO_COUNT;
+};
+
+#endif
@@ -0,0 +1,102 @@
+///////////////
+// JobSystem.hpp
+//
+// A pool of threads for splitting one tick's work into jobs.
+//
+// Every thread has its own deque of jobs. A thread works through its own
+// deque newest first, and when it runs dry it steals the oldest job from
+// someone else's. Threads that aren't workers (the main loop, the
+// FrameWorker) share one deque, and waiting on a group runs jobs instead
+// of blocking:
+//
+//     JobSystem::Group group;
+//     jobs.run(group, [&]{ left.update(dt); });    // fork
+//     jobs.run(group, [&]{ right.update(dt); });
+//     jobs.wait(group);                             // join
+//
+//     jobs.parallelFor(items.size(), 64, [&](std::size_t begin, std::size_t end){
+//         for(std::size_t i = begin; i < end; i++)
+//             items[i].update(dt);
+//     });
+//
+// Which thread runs a job changes from run to run, so jobs should only
+// write to what they were given. Anything they need to hand back in order
+// (queued events, for one) goes into per-job slots that are merged after
+// the join.
+///////////////
+#ifndef JOB_SYSTEM_HPP
+#define JOB_SYSTEM_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem
+{
+public:
+    typedef std::function<void()> Job;
+    // Jobs that are waited on together
+    class Group
+    {
+    public:
+        Group(): pending(0) {};
+        Group(const Group&) = delete;
+        Group& operator=(const Group&) = delete;
+    private:
+        friend class JobSystem;
+        std::atomic<int> pending;
+    };
+
+    JobSystem();
+    ~JobSystem();
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    // Starts threads - 1 workers (the thread that waits is the last one).
+    // 0 means one per core. Until then everything runs on the waiting thread.
+    void start(unsigned int threads = 0);
+    // Threads that run jobs, counting the one waiting
+    unsigned int getThreadCount() const { return static_cast<unsigned int>(queues.size()); };
+
+    // Queues job as part of group
+    void run(Group& group, Job job);
+    // Runs queued jobs until every job in group is done
+    void wait(Group& group);
+    // Calls body on [0, count) in chunks of grain, spread over the threads,
+    // and returns once every chunk is done. The chunks are always the same,
+    // only which thread gets which changes.
+    void parallelFor(std::size_t count, std::size_t grain,
+                     const std::function<void(std::size_t begin, std::size_t end)>& body);
+private:
+    struct Task
+    {
+        Job job;
+        Group* group = NULL;
+    };
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+    void stop();
+    void loop(unsigned int slot);
+    unsigned int getSlot() const;
+    bool take(unsigned int slot, Task& task);
+    void execute(Task& task);
+
+    // slot 0 belongs to every thread that isn't a worker
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    // tasks sitting in any queue, so idle workers know when to wake
+    std::atomic<int> queued;
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool quit = false;
+};
+
+#endif
@@ -0,0 +1,74 @@
+///////////////
+// LightMap.hpp
+//
+// Screen-space lighting for any number of point lights.
+//
+// Lights are splatted into a low resolution map (an eighth of the window
+// each way by default) as additive quads textured with a falloff, one draw
+// per view. The map is then blurred, and the scene is drawn through it in
+// one pass. Every light fills its whole square of the map, so the map's
+// resolution is what the light count gets multiplied by; on a software
+// renderer that's most of the cost.
+//
+//     lightMap.clear();
+//     lightMap.addView(camera, lights);     // per view
+//     lightMap.apply(window, scene);
+//
+// Accumulating and multiplying work without shaders (the scene is drawn,
+// then the map multiplied over it); the blur and the single pass need
+// them.
+///////////////
+#ifndef LIGHT_MAP_HPP
+#define LIGHT_MAP_HPP
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+struct Light
+{
+    Light(sf::Vector2f position = sf::Vector2f(), float radius = 0, sf::Color color = sf::Color::White)
+        : position(position), radius(radius), color(color) {};
+    // world coordinates
+    sf::Vector2f position;
+    // distance at which the light has faded out
+    float radius;
+    sf::Color color;
+};
+
+class LightMap
+{
+public:
+    // Makes a map for a width x height window at 1/scale resolution.
+    // Returns false if render textures aren't supported.
+    bool create(unsigned int width, unsigned int height, unsigned int scale = 8);
+    bool isReady() const { return ready; };
+    // Light everything gets, even away from any light source
+    void setAmbient(sf::Color c){ ambient = c; };
+
+    // Starts a new frame
+    void clear();
+    // Adds the lights visible through camera, which must have its viewport set
+    void addView(const sf::View& camera, const std::vector<Light>& lights);
+    // Blurs the map and draws scene (a texture the size of the window)
+    // onto target, lit by it
+    void apply(sf::RenderTarget& target, const sf::Texture& scene);
+    // Lights drawn since the last clear()
+    int getLightCount() const { return drawn; };
+private:
+    void blur();
+
+    sf::RenderTexture map;
+    sf::RenderTexture scratch;
+    sf::Texture falloff;
+    // ResourceManager's, so it can be reloaded
+    sf::Shader* blurShader = NULL;
+    sf::Shader* lightShader = NULL;
+    sf::VertexArray quads;
+    sf::Color ambient = sf::Color(10, 10, 18);
+    unsigned int scale = 4;
+    bool ready = false;
+    bool canBlur = false;
+    int drawn = 0;
+};
+
+#endif
@@ -0,0 +1,163 @@
+///////////////
+// Lockstep.hpp
+//
+// Networked play where every machine runs the whole game and only the
+// players' inputs are sent. Each tick, every player's Input::State is
+// packed into a Frame (four bytes) and sent over UDP to every other
+// player; a tick runs once everyone's frame for it is in, so every
+// machine ticks on the same inputs.
+//
+//     Lockstep net;
+//     net.open(4000, 0, 2);                      // we're player 0 of 2
+//     net.addPeer(1, "192.168.1.20", 4000);
+//     net.setInputDelay(3);
+//     game.setLockstep(&net);
+//
+// Input delay: what's sampled on tick t is used on tick t + delay, which
+// gives it that long to reach the others before anyone waits on it.
+//
+// Frames are resent until the other side acks them, so a lost packet just
+// means the next one carries it too.
+//
+// Rollback: with hooks set, a tick whose remote frames are late runs on a
+// guess (their last frame) instead of waiting. save(t) is called before
+// such a tick; if a guess turns out wrong, rewind() calls restore(t) for
+// the first wrong tick and the ticks since are run again with real
+// inputs. Without hooks late frames stall the game. A restore that fails
+// (nothing saved for t) leaves this machine out of step for good, so
+// rewind() says so rather than carrying on.
+///////////////
+#ifndef LOCKSTEP_HPP
+#define LOCKSTEP_HPP
+
+#include <SFML/Network.hpp>
+#include <functional>
+#include <ostream>
+#include <vector>
+#include "engine/Input.hpp"
+
+class Lockstep
+{
+public:
+    // One player's input for one tick, as it goes over the wire
+    struct Frame
+    {
+        sf::Uint16 down = 0;
+        // State::move in 127ths
+        sf::Int8 moveX = 0;
+        sf::Int8 moveY = 0;
+        static Frame pack(const Input::Actions& down, sf::Vector2f move);
+        Input::Actions getActions() const { return Input::Actions(down); };
+        sf::Vector2f getMove() const { return sf::Vector2f(moveX / 127.0f, moveY / 127.0f); };
+        bool operator==(const Frame& f) const { return down == f.down && moveX == f.moveX && moveY == f.moveY; };
+        bool operator!=(const Frame& f) const { return !(*this == f); };
+    };
+    typedef std::function<void(sf::Uint32 tick)> Hook;
+    // false if the state before tick couldn't be put back
+    typedef std::function<bool(sf::Uint32 tick)> Restorer;
+    // The most ticks setRollback() will guess ahead, so the most a save
+    // hook ever has to keep
+    static const int MAX_AHEAD = 32;
+
+    Lockstep();
+    // Listens on port (0 picks one) as player local of players
+    bool open(unsigned short port, int local, int players);
+    unsigned short getPort() const { return socket.getLocalPort(); };
+    void addPeer(int player, const sf::IpAddress& address, unsigned short port);
+    int getLocalPlayer() const { return local; };
+    int getPlayerCount() const { return static_cast<int>(frames.size()); };
+    void setInputDelay(int ticks);
+    int getInputDelay() const { return delay; };
+    // Run late ticks on a guess, at most maxAhead (up to MAX_AHEAD) ticks
+    // past the last tick everyone's frames are in (see above)
+    void setRollback(Hook save, Restorer restore, int maxAhead = 8);
+
+    // The tick that runs next
+    sf::Uint32 getTick() const { return tick; };
+    // The local player's input, used getInputDelay() ticks from now
+    void submit(const Frame& frame);
+    // Takes in everything that's arrived
+    void receive();
+    // How many ticks to run again because a guess was wrong (restore()
+    // has been called and getTick() moved back), usually 0; -1 if restore()
+    // failed and this machine can't get back in step
+    int rewind();
+    // Whether getTick() can run: everyone's frame is in, or can be guessed
+    bool ready();
+    // player's input for getTick(), once ready()
+    const Frame& getFrame(int player) const;
+    // Done with getTick()
+    void advance();
+
+    struct Stats
+    {
+        struct Peer
+        {
+            int player = -1;
+            // payload only; UDP/IP adds 28 bytes to each packet
+            unsigned int bytesSent = 0;
+            unsigned int bytesReceived = 0;
+            unsigned int packetsSent = 0;
+            unsigned int packetsReceived = 0;
+            // includes up to a tick of the packet waiting to be answered
+            float roundTripSeconds = 0;
+            float worstRoundTripSeconds = 0;
+            unsigned int roundTrips = 0;
+        };
+        std::vector<Peer> peers;
+        float seconds = 0;
+        // ticks run, replays included
+        unsigned int ticks = 0;
+        // ticks that had to wait for a frame
+        unsigned int stalls = 0;
+        // ticks run on a guess, and ticks run again when it was wrong
+        unsigned int predicted = 0;
+        unsigned int replayed = 0;
+        // how many ticks before it was needed each remote frame arrived
+        // (negative: after, so something waited or guessed)
+        long leadTicks = 0;
+        unsigned int leadSamples = 0;
+        int worstLeadTicks = 0;
+    };
+    // Counters since the last call
+    Stats takeStats();
+    void report(std::ostream& out);
+private:
+    // ticks of frames kept per player; nothing is ever further apart
+    static const sf::Uint32 WINDOW = 128;
+    // most frames resent in one packet
+    static const sf::Uint32 MAX_RESEND = 32;
+    struct Peer
+    {
+        int player;
+        sf::IpAddress address;
+        unsigned short port;
+        // how many of our ticks they have
+        sf::Uint32 acked = 0;
+        // their clock on the last packet, echoed back for round trips
+        float stamp = -1;
+    };
+    void send();
+    Frame& at(int player, sf::Uint32 t){ return frames[player][t % WINDOW]; };
+    float clock() const;
+
+    sf::UdpSocket socket;
+    int local = 0;
+    int delay = 2;
+    sf::Uint32 tick = 0;
+    std::vector<Peer> peers;
+    // [player][tick % WINDOW], and how many ticks of each are in
+    std::vector<std::vector<Frame>> frames;
+    std::vector<sf::Uint32> received;
+    // what ran on each tick that isn't confirmed yet, to catch bad guesses
+    std::vector<std::vector<Frame>> used;
+    sf::Uint32 wrongFrom;
+    Hook save;
+    Restorer restore;
+    int maxAhead = 0;
+    double started;
+    double statsSince;
+    Stats stats;
+};
+
+#endif
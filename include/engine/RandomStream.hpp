@@ -0,0 +1,86 @@
+///////////////
+// RandomStream.hpp
+//
+// Counter-based random number streams (Philox4x32-10, from Salmon et al.
+// "Parallel Random Numbers: As Easy as 1, 2, 3").
+//
+// A stream is just (seed, stream id, position): every block of four numbers
+// is a pure function of those, so streams never overlap, can be created
+// anywhere without coordination, and can be saved/restored exactly.
+//
+// Each subsystem asks for its own named stream instead of sharing one global
+// generator:
+//
+//     RandomStream& rng = RandomStream::get("house");
+//     int x = rng.equilikely(0, 19);
+//
+// get() and seedAll() are thread safe. A single stream is not, so don't
+// share one between threads (give each its own name instead).
+//
+// The distributions are the ones from Random.hpp (Park & Geyer's rvgs).
+///////////////
+#ifndef RANDOM_STREAM_HPP
+#define RANDOM_STREAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class RandomStream
+{
+public:
+    RandomStream(uint64_t seed = 123456789, uint64_t id = 0);
+
+    // The stream called name, seeded from the current master seed
+    static RandomStream& get(const std::string& name);
+    // Sets the master seed and restarts every named stream from it
+    static void seedAll(uint64_t seed);
+    static uint64_t getMasterSeed();
+    // The id get(name) uses, for making a private copy of a named stream:
+    //     RandomStream house(seed, RandomStream::getNameId("house"));
+    static uint64_t getNameId(const std::string& name);
+
+    // Restart this stream from the beginning of the sequence for seed
+    void seed(uint64_t seed);
+    uint64_t getSeed() const { return key; };
+    uint64_t getId() const { return id; };
+    // Number of values drawn so far. setPosition() jumps anywhere in O(1).
+    uint64_t getPosition() const { return counter * 4 + used - 4; };
+    void setPosition(uint64_t position);
+
+    // 32 random bits
+    uint32_t next();
+    // Uniform real in (0, 1), never exactly 0 or 1
+    double random();
+    // Batched versions of next() and random()
+    void fill(uint32_t* out, std::size_t n);
+    void fill(double* out, std::size_t n);
+
+    // Discrete distributions
+    long bernoulli(double p);
+    long binomial(long n, double p);
+    long equilikely(long a, long b);
+    long geometric(double p);
+    long pascal(long n, double p);
+    long poisson(double m);
+    // Continuous distributions
+    double uniform(double a, double b);
+    double exponential(double m);
+    double erlang(long n, double b);
+    double normal(double m, double s);
+    double lognormal(double a, double b);
+    double chisquare(long n);
+    double student(long n);
+
+    // Philox4x32-10 of (counter, id) under key
+    static void block(uint64_t counter, uint64_t id, uint64_t key, uint32_t out[4]);
+private:
+    uint64_t key;
+    uint64_t id;
+    // index of the next block to generate
+    uint64_t counter = 0;
+    uint32_t buffer[4];
+    int used = 4;
+};
+
+#endif
@@ -0,0 +1,55 @@
+///////////////
+// RenderSnapshot.hpp
+//
+// What a screen copies out of its game objects after each batch of ticks,
+// so it can be drawn while the next batch is simulated on another thread
+// (see GameEngine::setPipelined and GameScreen::publish).
+//
+// The simulation thread writes DoubleBuffer::back(), the render thread
+// reads front(), and the engine swaps them when neither is running.
+///////////////
+#ifndef RENDER_SNAPSHOT_HPP
+#define RENDER_SNAPSHOT_HPP
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// A sprite and everything it was drawn with (its parents' transforms)
+struct SpriteSnapshot
+{
+    sf::Sprite sprite;
+    sf::Transform transform;
+};
+
+struct EntitySnapshot
+{
+    // where the entity is, for deciding who can see it
+    sf::FloatRect box;
+    // position before and after the last tick, for interpolation
+    sf::Vector2f previous;
+    sf::Vector2f current;
+    // changes whenever the sprites do (see Character::getDrawKey)
+    std::size_t drawKey = 0;
+    std::vector<SpriteSnapshot> sprites;
+    // Where it's drawn this frame (see GameObject::interpolate)
+    sf::Vector2f getRenderPosition() const;
+    // Draws the sprites at the interpolated position
+    void draw(sf::RenderTarget& target) const;
+};
+
+template<class T>
+class DoubleBuffer
+{
+public:
+    // written by the simulation
+    T& back(){ return buffers[1 - current]; };
+    // read when drawing
+    const T& front() const { return buffers[current]; };
+    // only while neither side is using them
+    void swap(){ current = 1 - current; };
+private:
+    T buffers[2];
+    int current = 0;
+};
+
+#endif
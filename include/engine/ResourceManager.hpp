@@ -3,8 +3,28 @@
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <string>
+////////////////
+// ResourceManager.hpp
+//
+// Loads each font, texture, sound and shader once, and hands the same one
+// to everything that asks for it by filename.
+//
+// While it's watching (GameEngine::setHotReload), saving a texture or a
+// shader's source puts the new one on screen without restarting: a
+// background thread notices the save (see FileWatcher.hpp) and decodes the
+// image or reads the source, then applyReloads(), between frames, swaps it
+// into the very texture or shader everything already points at. A save
+// that doesn't decode or compile leaves the old one showing. Fonts and
+// sounds aren't reloaded (a sound buffer can't be swapped out from under a
+// sound that's playing it).
+////////////////
 
 class ResourceManager
 {
@@ -12,10 +32,47 @@ public:
     static sf::Font* getFont(std::string name);
     static sf::Texture* getTexture(std::string name);
     static sf::SoundBuffer* getSoundBuffer(std::string name);
+    // NULL if there are no shaders or the pair doesn't compile
+    static sf::Shader* getShader(std::string vertex, std::string fragment);
+
+    // The background thread watching everything loaded, before and after
+    static void startWatching();
+    static void stopWatching();
+    // Swaps in whatever's been decoded since the last call. Call it between
+    // frames on the thread that draws; returns how many it swapped.
+    static int applyReloads();
 private:
+    // a texture (vertex is its filename) or a shader pair
+    struct Watched
+    {
+        std::string vertex;
+        std::string fragment;
+        bool shader;
+    };
+    struct Reload
+    {
+        Watched file;
+        sf::Image image;
+        std::string vertexSource;
+        std::string fragmentSource;
+        // Input::now() when the save was noticed
+        double saved;
+    };
+    static void watchLoop();
+    // for the watching thread to pick up, if there is one
+    static void watch(const Watched& file);
+
     static std::map< std::string, sf::Font > fonts_cache;
     static std::map< std::string, sf::Texture > textures_cache;
     static std::map< std::string, sf::SoundBuffer > sound_cache;
+    static std::map< std::pair<std::string, std::string>, std::unique_ptr<sf::Shader> > shader_cache;
+
+    static std::atomic<bool> watching;
+    static std::thread watcher;
+    // guards toWatch and reloads, which go between the threads
+    static std::mutex reloadMutex;
+    static std::vector<Watched> toWatch;
+    static std::vector<Reload> reloads;
 };
 
-#endif
\ No newline at end of file
+#endif
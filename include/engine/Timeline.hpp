@@ -0,0 +1,56 @@
+///////////////
+// Timeline.hpp
+//
+// Builds a sequence of tweens and callbacks on a TweenManager. Each step is
+// turned into a delayed tween when it's added, so a running timeline costs
+// nothing beyond the tweens themselves.
+//
+//     intro = Timeline(&engine->getTweens());
+//     intro.then(&alpha, interpolate::LINEAR, 255, 50, 3.4f)   // 0.0 - 3.4s
+//          .with(&scale, interpolate::BACK_OUT, 0, 1, 1)       // 0.0 - 1.0s
+//          .at(3).call([this](){ showPrompt(); });              // at 3.0s
+//
+// Destroying a Timeline doesn't stop it; cancel() does.
+///////////////
+#ifndef TIMELINE_HPP
+#define TIMELINE_HPP
+
+#include <functional>
+#include <vector>
+#include "engine/TweenManager.hpp"
+
+class Timeline
+{
+public:
+    Timeline(TweenManager* tweens = NULL) : tweens(tweens) {};
+
+    // Starts once everything added so far has finished
+    Timeline& then(float* target, interpolate::EASE curve, float start, float end, float duration);
+    // Starts together with the previous step
+    Timeline& with(float* target, interpolate::EASE curve, float start, float end, float duration);
+    // Calls f once everything added so far has finished
+    Timeline& call(std::function<void()> f);
+    // Leaves a gap before the next step
+    Timeline& wait(float seconds);
+    // The next step starts this many seconds after the timeline was made
+    Timeline& at(float seconds);
+
+    // Stops every step that hasn't finished yet
+    void cancel();
+    bool isActive() const;
+    // Time at which the last step ends
+    float getDuration() const { return end; };
+private:
+    // When the next then() or call() starts
+    float nextStart();
+
+    TweenManager* tweens;
+    std::vector<TweenManager::Handle> steps;
+    // start of the last step and end of the sequence so far
+    float last = 0;
+    float end = 0;
+    // set by wait() and at(), negative when unset
+    float next = -1;
+};
+
+#endif
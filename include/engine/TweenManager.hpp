@@ -0,0 +1,85 @@
+///////////////
+// TweenManager.hpp
+//
+// Runs every active tween (positions, alpha, scale, ...) in one pass per tick.
+//
+// A tween drives a float from start to end over a duration along one of the
+// interpolate curves. Tweens are stored by curve as structure-of-arrays, so
+// update() is one batched interpolate::ease() call per curve followed by a
+// scatter of the results into the targets:
+//
+//     TweenManager::Handle h = tweens.add(&alpha, interpolate::QUADRATIC_OUT, 255, 0, 0.5f);
+//
+// The target has to outlive the tween (or cancel() it first). Finished
+// tweens are dropped after their last value is written, then their
+// onComplete callbacks run. Use Timeline to build sequences.
+///////////////
+#ifndef TWEEN_MANAGER_HPP
+#define TWEEN_MANAGER_HPP
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "engine/Interpolate.hpp"
+
+class TweenManager
+{
+public:
+    typedef unsigned int Handle;
+
+    // Animates *target from start to end over duration seconds, starting
+    // after delay seconds. Without a delay target is set to start straight away.
+    // target may be NULL for a tween that only exists for its callback.
+    Handle add(float* target, interpolate::EASE curve, float start, float end, float duration, float delay = 0);
+    // Calls f after delay seconds
+    Handle schedule(float delay, std::function<void()> f);
+    // Calls f once the tween finishes (not if it's cancelled)
+    void onComplete(Handle h, std::function<void()> f);
+    // Stops a tween where it is. Does nothing if it already finished.
+    void cancel(Handle h);
+    bool isActive(Handle h) const { return slots.count(h) != 0; };
+
+    // Advances every tween by dt seconds and writes the new values
+    void update(float dt);
+    void clear();
+    std::size_t size() const { return slots.size(); };
+private:
+    // Every tween using one curve, one array per field
+    struct Lane
+    {
+        // negative while the tween is still waiting on its delay
+        std::vector<float> elapsed;
+        std::vector<float> start;
+        std::vector<float> change;
+        std::vector<float> duration;
+        std::vector<float> value;
+        std::vector<float*> target;
+        std::vector<Handle> handle;
+        std::vector<std::function<void()>> done;
+    };
+    // A scheduled callback
+    struct Timer
+    {
+        float remaining;
+        Handle handle;
+        std::function<void()> done;
+    };
+    struct Slot
+    {
+        // TIMERS for timers, otherwise the curve
+        int lane;
+        std::size_t index;
+    };
+    static const int TIMERS = -1;
+
+    Handle newHandle(int lane, std::size_t index);
+    void remove(int lane, std::size_t index);
+
+    Lane lanes[interpolate::EASE_COUNT];
+    std::vector<Timer> timers;
+    std::unordered_map<Handle, Slot> slots;
+    Handle nextHandle = 1;
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define CONFIGURATIONS_STORE
 
 #include <map>
+#include <string>
 // A global configurations map
 class Config
 {
@@ -17,7 +18,14 @@ public:
 
     int num_players = 1;
 
-    float time_Per_Phase = 90.0;
+    // Seeds the house, spawns and clues; 0 picks one from the clock.
+    // Networked players have to agree on it.
+    unsigned long seed = 0;
+
+    // Where F5 quick-saves a match and F9 loads it back (see MatchSave);
+    // with resume set, the next match carries on from what's saved there
+    std::string save_file = "quicksave.hhs";
+    bool resume = false;
 };
 
 #endif
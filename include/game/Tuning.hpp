@@ -0,0 +1,51 @@
+#ifndef TUNING_HPP
+#define TUNING_HPP
+
+#include <string>
+#include "engine/FileWatcher.hpp"
+#include "game/sim/Match.hpp"
+////////////////
+// Tuning.hpp
+//
+// The numbers the game plays by (the same Match::Rules the headless
+// matches use: speeds, health, clue odds, item damage, the ghost) read from
+// resources/tuning.txt, so they change without a rebuild:
+//
+//     Tuning::load("../resources/tuning.txt");    // at startup
+//     every frame, on the main thread (GameEngine::onFrame):
+//         Tuning::poll();
+//     every tick, before anything reads them:
+//         Tuning::update();
+//     Tuning::get().villainHealth ...
+//
+// Saving the file while the game's running reloads it, mid-match too.
+// poll() reads the file, so the tick (maybe on the FrameWorker) never
+// waits on the disk; update() only swaps the new numbers in between
+// ticks, and bumps getVersion(); GameplayScreen hands them to its Match
+// (Match::setRules), which keeps the damage everyone's taken. A save with
+// numbers that can't be played (see Match::Rules::getProblem) is passed
+// over and the old ones stay. Without a file (or before load()) it's the
+// defaults in Match::Rules.
+////////////////
+
+class Tuning
+{
+public:
+    static bool load(const std::string& filename);
+    // Reads the file again if it's been saved, for the next update()
+    static void poll();
+    // Takes what poll() read; true if there was anything
+    static bool update();
+    static const Match::Rules& get(){ return rules; };
+    static int getVersion(){ return version; };
+private:
+    static Match::Rules rules;
+    // read by poll(), not yet taken by update()
+    static Match::Rules pending;
+    static bool hasPending;
+    static std::string filename;
+    static FileWatcher watcher;
+    static int version;
+};
+
+#endif
@@ -10,10 +10,13 @@
 #include "game/rooms/Room.hpp"
 #include "game/rooms/RoomGroup.hpp"
 #include "components/EntityGroup.hpp"
+#include "game/sim/Match.hpp"
 ////////////////
 // Character.hpp
 //
-// This is just a regular character. He has no motivations, goals, or collision checking yet.
+// This is just a regular character. He has no motivations or goals of his
+// own: where he is, how hurt he is and what he's reading are whatever his
+// seat in the Match says (see setMatch), he just looks the part.
 // He likes to go for long walks in complete and utter darkness.
 // He's very animated.
 //
@@ -36,35 +39,33 @@ public:
     void setRoomGroup(RoomGroup* group) { g = group; };
 
     void setPlayerNumber(int number){player_number = number;};
-    void setGamepadIndex(int number){gamepad_index = number;};
-    int  getGamepadIndex(){ return gamepad_index; };
     /**
-    * Captures gamepad events and updates the state of our
-    * character accordingly
+    * The match it shows a player of (seat, from 0) or, for the ghost,
+    * its villain. Read every update, so set it before init().
     */
-    virtual void onGamepadEvent(GamepadEvent e);
+    void setMatch(const Match* m, int s){ match = m; seat = s; };
     /**
     * Very simple collision checking
     */
     virtual void checkCollisions();
-    /**
-     * Rewriteable hurt method to be used by ghost and char
-     */
-    virtual void hurt();
 
     /* See GameObject Class*/
     virtual void init();
     virtual void onDraw(sf::RenderTarget& target, sf::RenderStates states) const;
     virtual void onUpdate(float dt);
+    // Changes whenever drawing the character would produce a different picture
+    std::size_t getDrawKey() const;
+    // Copies what onDraw would draw (see RenderSnapshot.hpp)
+    virtual void snapshot(EntitySnapshot& s) const;
     int player_number = -1;
+    // Which of the EntityGroup's islands it's in this tick
+    int island = -1;
     // create a hitbox at bottom half of 32x32 character
     Hitbox hbox;
     Hitbox hurtbox; // hurtbox for the sword(?)
     int health;
     int maxHealth;
     bool invul;
-    void checkClues();
-    void checkVillain();
     void attack();
     virtual bool isVillain(){return false;};
     bool readClue = false;
@@ -74,21 +75,22 @@ public:
     Config::CHARACTER character;
     bool hasItem;
     int itemDamage;
-    virtual void setItemDamage(int itemDamage);
 
 protected:
-    int gamepad_index = -1;
+    const Match* match = NULL;
+    int seat = -1;
+    // Walks and swings the way it's facing
+    void face(Match::FACING facing);
+    // After a move, walks if it went anywhere and stands still if not
+    void animate(sf::Vector2f from, float dt);
 
     // Base attributes
-    double speed = 120;
     double stealth = 100;
     double strength = 100;
     double intelligence = 100;
     RoomGroup* g;
     Room* current_room;
     EntityGroup* entity_group;
-    sf::Texture sprite_map;
-    sf::Texture death_map;
     sf::Texture pain_sprite;
     sf::Sound chara_hurt;
     sf::Sound chara_death;
@@ -104,16 +106,12 @@ protected:
     SpriteAnimation walk_down;
     SpriteAnimation walk_left;
     SpriteAnimation walk_right;
-    bool stopUp;
-    bool stopDown;
-    bool stopLeft;
-    bool stopRight;
     SpriteAnimation death_animation;
-    sf::Clock clock;
-    bool isStarted;
     bool panic;
     bool isAlive = true;
     bool isAttacking = false;
+    // the seat's swing time left last update; a new swing has more
+    float swingLeft = 0;
 };
 
 #endif
@@ -0,0 +1,59 @@
+#ifndef PLAYERHUD_HPP
+#define PLAYERHUD_HPP
+
+#include <string>
+#include <SFML/Graphics.hpp>
+#include "engine/GlyphAtlas.hpp"
+
+class Character;
+
+////////////////
+// PlayerHUD.hpp
+// The hearts and clue box drawn over a player's view. The geometry is
+// kept between frames and only rebuilt by update() when the State captured
+// from the character (health, the clue being read) changes, so a frame that changes nothing
+// just draws the cached vertex arrays. The clue box and its text share a
+// glyph atlas, so an open clue is one draw.
+////////////////
+class PlayerHUD: public sf::Drawable
+{
+    public:
+        // What the HUD shows, copied from the character after each tick
+        struct State
+        {
+            int health = 0;
+            int maxHealth = 0;
+            bool showClue = false;
+            std::string clue;
+        };
+        static void capture(const Character& c, State& state);
+
+        // size is the view's size in HUD coordinates
+        void init(sf::Vector2f size);
+        // Rebuilds whatever changed since the last call; returns true if
+        // anything did
+        bool update(const State& state);
+        // Times the geometry was rebuilt since the last call
+        unsigned int takeRebuilds();
+        // Lays out every clue in the item database ahead of time
+        static void prepareClues();
+    protected:
+        void draw(sf::RenderTarget& target, sf::RenderStates states) const;
+        void buildHearts(int health, int maxHealth);
+        void buildClue(const std::string& clue);
+
+        sf::Vector2f size;
+        const sf::Texture* heartTexture = NULL;
+        sf::VertexArray hearts;
+        GlyphAtlas* atlas = NULL;
+        // box and text
+        sf::VertexArray cluePopup;
+        // what the geometry currently shows
+        int health = -1;
+        int maxHealth = -1;
+        bool showClue = false;
+        std::string clue;
+        unsigned int rebuilds = 0;
+};
+
+#endif
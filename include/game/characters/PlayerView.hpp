@@ -6,6 +6,7 @@
 #include "engine/Engine.hpp"
 #include "game/characters/Character.hpp"
 #include "game/characters/Villain.hpp"
+#include "game/characters/PlayerHUD.hpp"
 #include "game/rooms/RoomGroup.hpp"
 #include "components/EntityGroup.hpp"
 #include "game/objects/Clue.hpp"
@@ -19,6 +20,7 @@ class PlayerView: public GameObject
 {
     public:
         PlayerView(){};
+        ~PlayerView();
         void init();
         void onUpdate(float dt);
         // void setCharacter(std::shared_ptr<Character> activeChar) {c = activeChar;};
@@ -34,28 +36,80 @@ class PlayerView: public GameObject
         void setControllerIndex(int index){};
 
         void setRoomGroup(RoomGroup* g){this->rooms = g;};
-        // A hack needed to calculate lighting
-        int numPlayers = -1;
+
+        // What the view needs to draw, copied out after each batch of ticks
+        // so drawing never touches the live characters (see RenderSnapshot.hpp)
+        struct Snapshot
+        {
+            // the character's position before and after the last tick
+            sf::Vector2f from;
+            sf::Vector2f to;
+            const Room* room = NULL;
+            bool invul = false;
+            float painAlpha = 100;
+            PlayerHUD::State hud;
+        };
+        void snapshot(Snapshot& s) const;
+        // Draws the world as this player sees it into target (the compositor
+        // layer), but only if it changed since the last call. Returns true
+        // if it redrew.
+        bool renderWorld(sf::RenderTarget& target, const Snapshot& s,
+                         const std::vector<EntitySnapshot>& entities) const;
+        // Draws the world straight to target, returns the number of draws
+        int drawWorld(sf::RenderTarget& target, const Snapshot& s,
+                      const std::vector<EntitySnapshot>& entities) const;
+        // Make the next renderWorld() redraw no matter what
+        void invalidate(){ redraw = true; };
+        // Health, pain overlay and clue box, drawn on top of the lit world
+        void drawHUD(sf::RenderTarget& target, const Snapshot& s) const;
+        sf::FloatRect getViewport() const { return v.getViewport(); };
+        const sf::View& getCamera() const { return v; };
+
+        struct RenderStats
+        {
+            // frames asked for, frames actually redrawn, drawables drawn
+            unsigned int frames = 0;
+            unsigned int renders = 0;
+            unsigned int draws = 0;
+            // GPU time of the last redraw, -1 if unknown
+            float gpuMs = -1;
+            // times the HUD geometry had to be rebuilt
+            unsigned int hudRebuilds = 0;
+        };
+        // Stats since the last call
+        RenderStats takeStats();
+        // Where the pain overlay fade runs
+        void setTweens(TweenManager* t){this->tweens = t;};
     protected:
-        float viewport_x = 0;
-        float viewport_y = 0;
-        sf::Shader shader;
-        sf::RectangleShape lighting;
         RoomGroup* rooms;
         int playernumber;
         // std::shared_ptr<Villain> g;
         // std::shared_ptr<Character> c;
         EntityGroup* entity_group;
         // std::vector<std::shared_ptr<Character>>& characters;
-        sf::View v;
+        // follows the character's interpolated position when drawing
+        mutable sf::View v;
         // Heads up display (Items, Health(?), etc)
         sf::View HUD;
         sf::RectangleShape itemBar;
-        sf::Texture heartTexture;
-        sf::RectangleShape pain;
-        void onDraw(sf::RenderTarget& target, sf::RenderStates states) const;
+        // rebuilt from Snapshot::hud when drawing
+        mutable PlayerHUD hud;
+        mutable sf::RectangleShape pain;
+        // Centres the camera on where the character is drawn this frame
+        void follow(const Snapshot& s) const;
+        std::size_t getDrawKey(const Snapshot& s, const std::vector<EntitySnapshot>& entities) const;
+        sf::FloatRect getVisibleArea() const;
+        // what the view last rendered, see renderWorld()
+        mutable std::size_t lastKey = 0;
+        mutable bool redraw = true;
+        mutable RenderStats stats;
+        mutable GpuTimer gpuTimer;
         sf::Clock clock;
-        int painCount;
+        // alpha of the pain overlay, faded out while the character is invulnerable
+        float painAlpha = 100;
+        TweenManager* tweens = NULL;
+        TweenManager::Handle painFade = 0;
+        bool wasInvul = false;
 };
 
 #endif
\ No newline at end of file
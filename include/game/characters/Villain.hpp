@@ -16,7 +16,8 @@
 //
 // This is a generic ghost.  He wants to hunt and kill the other character
 // present in the game.  He wanders the house looking for them, chases and attacks when
-// a character is seen, and then wanders once again.
+// a character is seen, and then wanders once again. All of that happens in
+// the Match (see Match::getVillain()); this is how it looks.
 //
 ////////////////
 
@@ -26,34 +27,8 @@ public:
     void init();
     void onUpdate(float dt);
     void onDraw(sf::RenderTarget& target, sf::RenderStates states) const;
-    void wander();
-    void chase();
-    void returnToCenter();
-    void setDirection();
-    void hurt();
-    void setItemDamage(int damage);
-    bool checkCharacters();
+    void snapshot(EntitySnapshot& s) const;
     bool isVillain(){return true;};
-protected:
-    int healthCut;
-    int randint;
-    int health;
-    std:: string previousString;
-    std::vector<std::string> possiblerooms;
-    int roomCenterX;
-    int roomCenterY;
-    float previousLocationX;
-    float previousLocationY;
-    bool isChasing;
-    bool started;
-    bool needsCentering;
-    bool fastSpeed;
-    sf::FloatRect roomHbox;
-    sf::FloatRect chaseHbox;
-
-    sf::Texture death_map;
-    SpriteAnimation death_animation;
-
 };
 
 #endif
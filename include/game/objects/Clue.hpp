@@ -23,6 +23,10 @@ public:
     void init();
     void onUpdate(float dt);
     void setCoordinates(int x, int y, int w, int h);
+    // Cuts the furniture out of the room's picture, so it can be drawn over
+    // characters standing behind it (call after setCoordinates)
+    void setFurniture(const Room& room);
+    void snapshot(EntitySnapshot& s) const;
     void onDraw(sf::RenderTarget& target, sf::RenderStates states) const;
     void open();
     void close();
@@ -34,7 +38,6 @@ public:
     Hitbox hbox;
     bool isOpen;
     int highLow;
-    bool activatedItem;
 
     // the written information for the player
     std::string clueSpec;
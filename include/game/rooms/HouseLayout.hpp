@@ -0,0 +1,72 @@
+#ifndef HOUSE_LAYOUT_HPP
+#define HOUSE_LAYOUT_HPP
+
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include "engine/RandomStream.hpp"
+////////////////
+// HouseLayout.hpp
+//
+// Where the rooms and doors of a house are, without any of their pictures.
+// RoomGroup builds the rooms you see from one of these; the dedicated
+// server plays on one directly.
+//
+// Rooms sit on a 20x20 grid, grown outwards from the middle one room at a
+// time. Neighbouring rooms always share a door.
+////////////////
+
+class HouseLayout
+{
+public:
+    static const int GRID = 20;
+    // A room's picture, and the walkable floor inside its walls
+    static const int ROOM_W = 512;
+    static const int ROOM_H = 384;
+    static const int DOOR = 64;
+    enum SIDE {RIGHT, DOWN, LEFT, UP};
+
+    struct Room
+    {
+        int gridX, gridY;
+        // see RoomType
+        int type;
+        sf::FloatRect area;
+        sf::FloatRect floor;
+        // index of the room through each SIDE's door, -1 for a wall
+        int next[4];
+    };
+    struct Door
+    {
+        // the doorway, overlapping both rooms' floors
+        sf::FloatRect floor;
+        // joins `from` to the room RIGHT of it, or DOWN if bottom
+        bool bottom;
+        int from, to;
+    };
+
+    // Rolls a house of count rooms, with the same rolls in the same order
+    // as it always has (so a seed still gives the same house)
+    void generate(int count, RandomStream& rng);
+    // Lays out rooms where their gridX, gridY and type say, in grid order
+    // (column by column), filling in the rest; how a saved house comes back
+    void build(const std::vector<Room>& placed);
+    std::vector<Room> rooms;
+    // the right then bottom door of each room, in room order
+    std::vector<Door> doors;
+
+    // Whether box is entirely on one room's floor or in one doorway
+    bool isInside(const sf::FloatRect& box) const;
+    // The room whose floor box is entirely on, or -1
+    int roomAt(const sf::FloatRect& box) const;
+    // The room whose floor point is on, or -1
+    int roomAt(sf::Vector2f point) const;
+    // Middle of a room's floor
+    sf::Vector2f getCentre(int room) const;
+private:
+    // room index of every grid cell, -1 where there isn't one
+    std::vector<int> cells;
+    static bool contains(const sf::FloatRect& outer, const sf::FloatRect& box);
+};
+
+#endif
@@ -18,11 +18,20 @@ public:
     std::string room_setup;
     Hitbox hbox;
     void setRoomType(int type);
-    int  getRoomType(int type) { return room_type; };
+    enum LIGHT {CANDLE, TORCH, FIREPLACE, LAMP};
+    // Makes the furniture last added to clueCoordinates give off light
+    void addLight(LIGHT kind);
+    // Appends this room's light sources in world coordinates
+    void getLights(std::vector<Light>& out) const;
+    int  getRoomType() const { return room_type; };
     bool isDoor = false;
     bool isBottom = false;
 protected:
-    int room_type;
+    // 0 (nothing) until setRoomType, like doors
+    int room_type = 0;
+    // furniture tiles, same units as clueCoordinates
+    struct LightSource {int x, y, w, h; LIGHT kind;};
+    std::vector<LightSource> lights;
 };
 
 #endif
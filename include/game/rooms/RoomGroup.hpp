@@ -6,12 +6,15 @@
 #include <time.h>
 #include <vector>
 #include "game/rooms/Room.hpp"
+#include "game/rooms/HouseLayout.hpp"
 #include "components/Hitbox.hpp"
 
 class RoomGroup: public GameObject
 {
 public:
-   void generateRoomGrid(int roomCount);
+   // A Room (and a door Room) for every room and doorway in house, which
+   // is copied
+   void build(const HouseLayout& house);
    bool isInsideRoom(sf::FloatRect hbox);
    bool inSameRoom(sf::FloatRect box1, sf::FloatRect box2);
    sf::FloatRect getRoom(sf::FloatRect hbox);
@@ -21,8 +24,13 @@ public:
    // Why have this? Just in case.
    int roomCount();
    std::vector<std::shared_ptr<Room>> rooms;
+   // Where everything in rooms is, as numbers
+   const HouseLayout& getLayout() const { return layout; };
+   // Draws the doors overlapping area, returns how many were drawn
+   int drawDoorsInArea(sf::RenderTarget& target, sf::FloatRect area) const;
 protected:
     int num_rooms = 0;
+    HouseLayout layout;
     void onDraw(sf::RenderTarget& target, sf::RenderStates states) const;
 
 };
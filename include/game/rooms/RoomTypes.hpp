@@ -0,0 +1,41 @@
+#ifndef ROOM_TYPES_HPP
+#define ROOM_TYPES_HPP
+
+#include <cstddef>
+////////////////
+// RoomTypes.hpp
+//
+// What's in each of the twelve kinds of room: its name, where the
+// furniture is (every piece hides a clue) and where players spawn.
+// Nothing here needs a window, so the dedicated server can build houses
+// too.
+//
+//     const RoomType& t = RoomType::get(room_type);
+//     for(int i = 0; i < t.furnitureCount; i++) ...
+//
+////////////////
+
+struct RoomType
+{
+    // Same order as Room::LIGHT
+    enum LIGHT {NO_LIGHT = -1, CANDLE, TORCH, FIREPLACE, LAMP};
+    // In 32 pixel tiles from the room's top left
+    struct Furniture
+    {
+        int x, y, w, h;
+        LIGHT light;
+    };
+    static const int COUNT = 12;
+
+    // "armory", "throne", ...
+    const char* name;
+    // How far below the top of the floor players spawn
+    int spawnY;
+    const Furniture* furniture;
+    int furnitureCount;
+
+    // Type 1 to COUNT; anything else is an empty room
+    static const RoomType& get(int type);
+};
+
+#endif
@@ -8,13 +8,13 @@ class CharacterIcon : public GameObject
 public:
     void init(){};
     void setColor(sf::Color color){ t.setColor(color);};
-    void setFont(std::string font){ t.setFont(*ResourceManager::getFont(font)); };
+    void setFont(std::string font){ t.setAtlas(GlyphAtlas::get(font, 30)); };
     void setPlayer(int num){ player_number = num; t.setString("P"+std::to_string(num)); };
     int  getPlayer(){return player_number; };
     void onDraw(sf::RenderTarget& ctx, sf::RenderStates states) const;
 protected:
     int player_number = -1;
-    sf::Text t;
+    ShapedText t;
     //sf::SoundBuffer buffer;
     //sf::Sound chara_sound;
 };
@@ -63,11 +63,12 @@ protected:
     std::vector<std::unique_ptr<sf::Text>> texts;
     bool changed;
     sf::RectangleShape background;
-    sf::Text teamFont;
+    ShapedText teamFont;
     sf::Texture title;
     sf::RectangleShape blackness;
     int player_num = 1;
-    int trans = 255;
+    float trans = 255;
+    Timeline fade;
     int selected_count = 0;
     sf::Sound chara_sound;
 };
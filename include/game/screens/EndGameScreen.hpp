@@ -15,15 +15,14 @@ public:
     void onDraw(sf::RenderTarget& ctx, sf::RenderStates states) const;
 
 protected:
-    sf::Text text;
-    sf::Text press_any_button;
-    sf::Clock clock;
-
+    ShapedText text;
+    ShapedText press_any_button;
     bool showing = false;
     bool can_leave = false;
-    float delay = 3;  // Wait 4 seconds
+    float delay = 3;  // Wait 3 seconds
 
     sf::Sound over;
-    int trans = 255;
+    float trans = 255;
+    Timeline fade;
     sf::RectangleShape blackness;
 };
@@ -7,6 +7,9 @@
 #include "game/objects/Clue.hpp"
 #include "game/rooms/RoomGroup.hpp"
 #include "game/characters/PlayerView.hpp"
+#include "game/sim/Match.hpp"
+#include "game/sim/MatchSave.hpp"
+#include "game/sim/MatchState.hpp"
 #include "components/EntityGroup.hpp"
 
 //////////////////////////
@@ -22,7 +25,10 @@
 //
 // There could even potentially be loading screens.
 //
-// This screen is pretty simple. All it does is show a character.
+// This screen is pretty simple. The game itself is a Match (see
+// game/sim/Match.hpp), fed each player's gamepad every tick; all the
+// screen does is show the characters, the ghost and the clues where the
+// match has them.
 //
 // Next check out src/GameplayScreen.cpp
 //////////////////////////
@@ -33,23 +39,74 @@ public:
     void init();
     void onUpdate(float dt);
     void onDraw(sf::RenderTarget& ctx, sf::RenderStates states) const;
+    // Drawn from snapshots, so ticks can run while the last frame is drawn
+    bool isPipelined() const { return true; };
+    void publish();
+    void present();
+    // Goes back to a saved Match for rollback netplay
+    bool canRollback() const { return true; };
+    void saveTick(unsigned int tick);
+    bool restoreTick(unsigned int tick);
+    // The match being played (NULL before the first one), for bots to look at
+    const Match* getMatch() const { return match.get(); };
 
 protected:
     void createViews(int numPlayers);
     void createClues();
-    int phase = 1;
+    // Opens and shuts the clues the match did
+    void showClues();
+    // Prints PlayerView::RenderStats for every view (debug mode only)
+    void reportRenderStats() const;
+    // Every light source in the house right now
+    void gatherLights(std::vector<Light>& out);
+    // QUICK_SAVE (F5) saves the match to config->save_file and QUICK_LOAD
+    // (F9) loads it back, both between ticks; not in netplay, where the
+    // others would play on without
+    void onCommand(Input::COMMAND command);
+    void quickSave();
+    void quickLoad();
+    // What's in config->save_file, if it's a match that can go on
+    bool loadSave(MatchState& state);
     int num_players = 1;
-    int hiLow;
+    // The game being played, and each seat's gamepad (seat 0 is player 1)
+    std::unique_ptr<Match> match;
+    std::vector<int> gamepads;
+    // set once GameEnd is on its way
+    bool ended = false;
+    // ticks the match has been over; in netplay a late input could still
+    // take the ending back, so it has to stand as long as a guess can
+    int endedFor = 0;
+    // the match before each of the last Lockstep::MAX_AHEAD ticks
+    // saveTick() was asked for, by tick % MAX_AHEAD
+    std::vector<MatchState> savedStates;
+    std::vector<unsigned int> savedTicks;
+    // config->save_file, opened the first time it's needed
+    MatchSave saveFile;
     // Entity 0 is the ghost
     std::map<int, std::shared_ptr <Clue>> clues;
     // A map of entities (characters)
     // Entity 0 is the ghost
     std::map<int, std::shared_ptr<Character>> entities;
-
-    sf::Clock clock;
     RoomGroup group;
     std::vector< std::unique_ptr<PlayerView> > views;
+    // draw() is const, but composing updates the layer
+    mutable Compositor compositor;
+    mutable int statsFrames = 0;
+    // furniture lights don't move, so they're collected once in init()
+    std::vector<Light> roomLights;
+    // Everything onDraw() reads, copied out by publish()
+    struct Snapshot
+    {
+        std::vector<EntitySnapshot> entities;
+        std::vector<PlayerView::Snapshot> views;
+        std::vector<Light> lights;
+    };
+    DoubleBuffer<Snapshot> snapshots;
+    // Made and loaded in init(), handed to entity_group when the match lets
+    // the ghost in
     std::shared_ptr<Villain> ghost;
+    // set by the tick that lets the ghost in, for present() to start the music
+    bool huntStarted = false;
     std::shared_ptr<Clue> clue;
     EntityGroup entity_group;
     ClueReader reader;
@@ -19,7 +19,8 @@ protected:
     sf::Sprite sprite;
     sf::Texture title;
     sf::RectangleShape blackness;
-    int trans = 255;
+    float trans = 255;
+    Timeline fade;
   // sf::Font font;
   // sf::Text t;
 };
@@ -0,0 +1,45 @@
+#ifndef BOT_MATCH_HPP
+#define BOT_MATCH_HPP
+
+#include <vector>
+#include "game/Config.hpp"
+#include "game/sim/Match.hpp"
+////////////////
+// BotMatch.hpp
+//
+// A whole Match with a MatchBot in every seat, played start to finish as
+// fast as it'll tick (nothing waits on a clock), for soak tests and
+// balance runs:
+//
+//     BotMatch::Outcome o = BotMatch::play(seed, characters, rules);
+//
+// Give the rules a timeLimitSeconds, or a match the bots can't finish
+// never ends. One call touches nothing but its own match and bots, so
+// any number run at once on different threads (see bin/HHBots.cpp).
+////////////////
+
+struct BotMatch
+{
+    struct Outcome
+    {
+        Match::RESULT result = Match::PLAYING;
+        float seconds = 0;
+        unsigned int ticks = 0;
+        int playersAlive = 0;
+        int villainHealth = 0;
+        // match time the ghost came out and the first player went down,
+        // -1 for never
+        float ghostOut = -1;
+        float firstDeath = -1;
+        // added up over the bots
+        int roomsVisited = 0;
+        int cluesRead = 0;
+        int swings = 0;
+        int itemsFound = 0;
+    };
+
+    static Outcome play(unsigned long seed, const std::vector<Config::CHARACTER>& characters,
+                        const Match::Rules& rules, float tickSeconds = 1 / 60.0f);
+};
+
+#endif
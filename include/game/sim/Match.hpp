@@ -0,0 +1,220 @@
+#ifndef MATCH_HPP
+#define MATCH_HPP
+
+#include <string>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include "engine/Input.hpp"
+#include "engine/RandomStream.hpp"
+#include "game/Config.hpp"
+#include "game/rooms/HouseLayout.hpp"
+
+struct MatchState;
+////////////////
+// Match.hpp
+//
+// One game of House Haunters with nothing drawn or played: the house, its
+// clues, the players and (once the first phase is up) the ghost, stepped
+// a tick at a time from each player's input. GameplayScreen plays on one
+// and draws what it says, and the dedicated server, the bots and the
+// balance runs play on one with nothing drawn.
+//
+//     Match match(seed, characters);
+//     match.setInput(0, actions, move);
+//     match.tick(1.0f / 60);
+//     if(match.getResult() != Match::PLAYING) ...
+//
+// These are the rules (speeds, health, invulnerability, clue odds, item
+// damage, the ghost's wandering, chasing and teleporting); Character and
+// Villain only show what happens here. It draws from its own random
+// streams, so a seed and the same inputs always play out the same way,
+// whichever thread runs it. Nothing is shared between matches.
+////////////////
+
+class Match
+{
+public:
+    enum RESULT {PLAYING, PLAYERS_WON, VILLAIN_WON, TIMED_OUT};
+    enum FACING {FACE_DOWN, FACE_LEFT, FACE_RIGHT, FACE_UP};
+    enum CLUE {WORTHLESS, VAGUE, SPECIFIC, JACKPOT};
+
+    // The numbers the game plays by
+    struct Rules
+    {
+        float playerSpeed = 120;
+        // BRO while RUN is held
+        float runMultiplier = 2;
+        // by Config::CHARACTER
+        int health[4] = {3, 3, 5, 3};
+        float invulnerableSeconds = 3;
+        // how long a swing lasts (the swipe's four frames)
+        float attackSeconds = 0.4f;
+        float attackReach = 64;
+        // out of a 0-99 roll: worthless up to 50, vague to 80, specific
+        // to 95, a jackpot above
+        int worthlessUpTo = 50;
+        int vagueUpTo = 80;
+        int specificUpTo = 95;
+        // a jackpot's item, by its clue's highLow, and bare hands
+        int itemDamage[2] = {3, 5};
+        int baseDamage = 1;
+        int villainHealth = 10;
+        // px/s, stepped in whole pixels a tick (so at 60 Hz anything from
+        // 60 to 119 is 1 px a tick)
+        float villainSpeed = 120;
+        // multiplied in when it starts chasing; divided back out by 1.5
+        // when it gives up or catches someone and by 1.25 when hurt,
+        // just like Villain does (so it slows down over a match)
+        float chaseMultiplier = 1.25f;
+        float calmDivisor = 1.5f;
+        // seconds before the ghost comes out
+        float phaseSeconds = 90;
+        // ends the match as TIMED_OUT, 0 for never
+        float timeLimitSeconds = 0;
+
+        // Every number above by its own name, health as healthBro (Sis,
+        // Dad, Mom) and itemDamage as itemDamageLow and itemDamageHigh,
+        // for setting them from outside the code (see bin/HHBalance.cpp).
+        // Each field points at either a float (real) or an int (whole).
+        struct Field
+        {
+            const char* name;
+            float* real;
+            int* whole;
+        };
+        std::vector<Field> getFields();
+        // false if there's no such name; ints are rounded
+        bool set(const std::string& name, float value);
+        bool get(const std::string& name, float& value) const;
+        // What's wrong with these numbers for playing a match (a speed or
+        // health that isn't above 0, clue odds out of order), NULL if
+        // nothing is
+        const char* getProblem() const;
+        // "name = value" lines (# starts a comment) over what's set
+        // already; false, changing nothing, if the file can't be read or
+        // the numbers it leaves have a problem
+        bool load(const std::string& filename);
+    };
+
+    struct Player
+    {
+        Config::CHARACTER character;
+        // same as Character's position; its hitbox hangs off it
+        sf::Vector2f position;
+        sf::Vector2f direction;
+        FACING facing = FACE_DOWN;
+        int health = 0;
+        float invulnerable = 0;
+        // seconds left of the current swing
+        float attacking = 0;
+        int itemDamage = 1;
+        bool hasItem = false;
+        // the clue's highLow the item came from, which picks its damage
+        int itemHighLow = 0;
+        // the clue being read, -1 for none
+        int reading = -1;
+        sf::FloatRect getHitbox() const { return sf::FloatRect(position.x - 8, position.y, 16, 16); };
+        bool isAlive() const { return health > 0; };
+    };
+    struct Villain
+    {
+        bool present = false;
+        sf::Vector2f position;
+        sf::Vector2f direction;
+        int health = 0;
+        float speed = 0;
+        bool fast = false;
+        bool chasing = false;
+        // the player being chased, -1 for none
+        int target = -1;
+        // where it's wandering to, and the side it came in by
+        sf::Vector2f heading;
+        int cameFrom = -1;
+        sf::FloatRect getHitbox() const { return sf::FloatRect(position.x, position.y + 16, 32, 16); };
+    };
+    struct Clue
+    {
+        sf::FloatRect box;
+        int room;
+        CLUE tier;
+        int highLow;
+        bool open = false;
+    };
+
+    Match(unsigned long seed, const std::vector<Config::CHARACTER>& characters, const Rules& rules);
+    Match(unsigned long seed, const std::vector<Config::CHARACTER>& characters)
+        : Match(seed, characters, Rules()) {};
+    // How many rooms the game builds for this many players
+    static int getRoomCount(int players);
+
+    // What a player is holding for the next tick
+    void setInput(int player, const Input::Actions& down, sf::Vector2f move);
+    void tick(float dt);
+
+    unsigned long getSeed() const { return seed; };
+    RESULT getResult() const { return result; };
+    float getTime() const { return time; };
+    unsigned int getTicks() const { return ticks; };
+    int getPhase() const { return phase; };
+    const Rules& getRules() const { return rules; };
+    // Plays on under new numbers (a reloaded Tuning): everyone keeps the
+    // damage they've taken and the ghost however much it's slowed down
+    void setRules(const Rules& rules);
+    const HouseLayout& getLayout() const { return layout; };
+    const std::vector<Player>& getPlayers() const { return players; };
+    const Villain& getVillain() const { return villain; };
+    const std::vector<Clue>& getClues() const { return clues; };
+    // The clue a player's close enough to read, -1 for none
+    int clueAt(int player) const;
+
+    // Everything needed to carry on from this tick (see MatchState.hpp)
+    void save(MatchState& state) const;
+    // Back to a saved tick, under this match's rules. False (leaving the
+    // match as it was) if the state doesn't hang together.
+    bool restore(const MatchState& state);
+private:
+    // a clue behind every piece of furniture, in room order
+    void placeClues();
+    void movePlayer(int p, float dt);
+    void usePlayer(int p);
+    void attackWith(int p);
+    void spawnVillain();
+    void moveVillain(float dt);
+    // the first player the ghost can see from where it is, or -1
+    int findTarget(int room) const;
+    void hurtPlayer(int p);
+    void hurtVillain(int damage);
+    // off to a random other room, sped back down by divisor if it was fast
+    void teleportVillain(float divisor);
+    // where the ghost stands in the middle of a room
+    sf::Vector2f getSpot(int room) const;
+    int villainRoom() const;
+    void pickHeading(int room);
+    // whether moving box by dx, dy walks into furniture
+    bool blocked(const sf::FloatRect& box, float dx, float dy, int room) const;
+    void checkEnd();
+
+    Rules rules;
+    unsigned long seed;
+    HouseLayout layout;
+    RandomStream spawnRng;
+    RandomStream clueRng;
+    RandomStream villainRng;
+    std::vector<Player> players;
+    std::vector<Input::State> inputs;
+    // what setInput left for the next tick
+    std::vector<Input::Actions> held;
+    std::vector<sf::Vector2f> moves;
+    Villain villain;
+    std::vector<Clue> clues;
+    // clues[firstClue[r]] to clues[firstClue[r + 1]] are in room r
+    std::vector<int> firstClue;
+    RESULT result = PLAYING;
+    int phase = 1;
+    float time = 0;
+    float phaseTime = 0;
+    unsigned int ticks = 0;
+};
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef MATCH_BOT_HPP
+#define MATCH_BOT_HPP
+
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+#include "engine/Input.hpp"
+#include "engine/RandomStream.hpp"
+#include "game/sim/Match.hpp"
+////////////////
+// MatchBot.hpp
+//
+// A computer player for one seat of a Match. Every tick it looks at the
+// match and decides what buttons it holds and where the stick points,
+// just as a Gamepad would report for a person, so whatever a pad's input
+// goes to can take a bot's instead:
+//
+//     MatchBot bot(player, seed);
+//     every tick:
+//         sf::Vector2f move;
+//         Input::Actions down = bot.think(match, dt, move);
+//         match.setInput(player, down, move);
+//
+// (or Gamepad::apply(down, move, now) to get the same gamepad events, or
+// Lockstep::Frame::pack(down, move) to send it).
+//
+// What it does, most pressing first:
+//     FLEE   the ghost's close and it can't win a fight: run from it
+//     FIGHT  the ghost's close and it's got an item or health to spare:
+//            face it and swing (ATTACK, "B")
+//     SEARCH walk up to furniture it hasn't looked behind and read the
+//            clue (USE, "A")
+//     EXPLORE once a room's searched, through the doors (by the house's
+//            door graph) to the nearest room it hasn't been in
+// Inside a room it walks from tile to tile (rooms are 32 px tiles, and
+// furniture fills whole ones) around the furniture. Anything it still
+// can't reach after a while it gives up on. It only reads the match, never changes it, and keeps no more
+// than a few vectors, so hundreds of matches of bots run side by side
+// (see bin/HHBots.cpp).
+////////////////
+
+class MatchBot
+{
+public:
+    enum TASK {EXPLORE, SEARCH, FIGHT, FLEE};
+
+    MatchBot(int player, unsigned long seed);
+    // This tick's held actions, and the stick in move
+    Input::Actions think(const Match& match, float dt, sf::Vector2f& move);
+    // think() straight into the match
+    void drive(Match& match, float dt);
+
+    int getPlayer() const { return player; };
+    TASK getTask() const { return task; };
+    int getRoomsVisited() const;
+    int getCluesRead() const { return cluesRead; };
+    int getSwings() const { return swings; };
+private:
+    // how far off the ghost is, -1 if it isn't out (or is beaten)
+    float ghostDistance(const Match& match) const;
+    void fight(const Match& match, Input::Actions& down, sf::Vector2f& move);
+    void flee(const Match& match, sf::Vector2f& move);
+    void search(const Match& match, float dt, Input::Actions& down, sf::Vector2f& move);
+    void explore(const Match& match, float dt, sf::Vector2f& move);
+    // toward the next waypoint; false once there aren't any
+    bool follow(const Match& match, float dt, sf::Vector2f& move);
+    // waypoints from room `from` to the nearest room not visited yet
+    void planRoute(const Match& match, int from);
+    // waypoints across room from tile `from` to the nearest tile that's
+    // `to`, or one next to furniture piece `to` if it's a clue; false
+    // (leaving route as it was) if there's no way
+    bool planTiles(const Match& match, int room, sf::Vector2i from, sf::Vector2i to, int clue);
+    // the unsearched clue in room nearest to the bot, -1 for none
+    int nearestClue(const Match& match, int room) const;
+    sf::Vector2f steer(sf::Vector2f to) const;
+
+    int player;
+    RandomStream rng;
+    TASK task = EXPLORE;
+    sf::Vector2f position;
+    // where it is, or was last (doorways aren't in a room)
+    int room = -1;
+    std::vector<bool> visited;
+    // clues read or given up on
+    std::vector<bool> searched;
+    std::vector<sf::Vector2f> route;
+    float legFor = 0;
+    int goal = -1;
+    float goalFor = 0;
+    float readFor = 0;
+    // what it held last tick, to let go between presses
+    Input::Actions last;
+    // stuck: how long it's barely moved, and a sidestep to get loose
+    sf::Vector2f lastPosition;
+    bool walking = false;
+    float stuckFor = 0;
+    float sidestepFor = 0;
+    sf::Vector2f sidestep;
+    int cluesRead = 0;
+    int swings = 0;
+};
+
+#endif
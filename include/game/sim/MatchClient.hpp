@@ -0,0 +1,88 @@
+#ifndef MATCH_CLIENT_HPP
+#define MATCH_CLIENT_HPP
+
+#include <SFML/Network.hpp>
+#include <vector>
+#include "engine/Lockstep.hpp"
+#include "game/sim/MatchServer.hpp"
+#include "game/sim/MatchSnapshot.hpp"
+////////////////
+// MatchClient.hpp
+//
+// One connection to a match on a MatchServer: sends the inputs of the
+// players it controls every tick and keeps the newest snapshot.
+//
+//     MatchClient client;
+//     client.open("127.0.0.1", 5000, seed, characters, 1);
+//     every tick:
+//         client.setInput(0, Lockstep::Frame::pack(actions, move));
+//         client.update();
+//         const MatchSnapshot& s = client.getSnapshot();
+//         s.entities[client.getSeat(0)] is our player
+//
+// Until the server answers it keeps asking to join. The server hands out
+// seats (which of the match's players are ours) on joining, and only
+// takes input for those. Inputs go with an ack of the newest snapshot
+// decoded, which the server deltas the next ones against.
+////////////////
+
+class MatchClient
+{
+public:
+    struct Stats
+    {
+        unsigned int bytesSent = 0;
+        unsigned int bytesReceived = 0;
+        unsigned int snapshots = 0;
+        // arrived against a base we'd already dropped
+        unsigned int undecodable = 0;
+    };
+
+    // Leaves, if it joined
+    ~MatchClient();
+    // Binds a port of its own and asks to join with seats of the players
+    // (all of them if less than 0); characters makes the match if it's new
+    bool open(const sf::IpAddress& address, unsigned short port, sf::Uint32 seed,
+              const std::vector<Config::CHARACTER>& characters, int seats = -1);
+    sf::Uint32 getSeed() const { return seed; };
+    // The seats the server gave us, once joined (maybe fewer than asked
+    // for, if others got there first)
+    int getSeatCount() const { return static_cast<int>(seats.size()); };
+    int getSeat(int i) const { return seats[i]; };
+    // What our i-th seat holds from the next send() on
+    void setInput(int i, const Lockstep::Frame& frame);
+    // receive() then send()
+    void update();
+    void receive();
+    void send();
+    // Tells the server we're gone
+    void close();
+    bool isJoined() const { return joined; };
+    bool hasSnapshot() const { return stats.snapshots > 0; };
+    const MatchSnapshot& getSnapshot() const { return latest; };
+    const Stats& getStats() const { return stats; };
+
+    // Asks one server thread for its totals, waiting up to timeout seconds
+    static bool askLoad(const sf::IpAddress& address, unsigned short port,
+                        MatchServer::Load& load, float timeout = 1);
+private:
+    static const sf::Uint32 HISTORY = 32;
+    sf::UdpSocket socket;
+    sf::IpAddress address;
+    unsigned short port = 0;
+    sf::Uint32 seed = 0;
+    std::vector<Config::CHARACTER> characters;
+    int wanted = 0;
+    std::vector<int> seats;
+    // by our seat, as many as we asked for
+    std::vector<Lockstep::Frame> frames;
+    bool joined = false;
+    double askedAt = 0;
+    // by tick % HISTORY
+    std::vector<MatchSnapshot> history;
+    MatchSnapshot latest;
+    sf::Uint32 acked = MatchServer::NO_TICK;
+    Stats stats;
+};
+
+#endif
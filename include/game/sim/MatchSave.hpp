@@ -0,0 +1,88 @@
+#ifndef MATCH_SAVE_HPP
+#define MATCH_SAVE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "game/sim/MatchState.hpp"
+////////////////
+// MatchSave.hpp
+//
+// A quick-save file for one match: MatchStates (EXACT keyframes) written
+// straight into a memory mapped file, so saving is a memcpy and loading is
+// a read of pages that are usually still cached.
+//
+//     MatchSave file;
+//     file.open("saves/match.hhs");
+//     every so often:
+//         match.save(state);
+//         file.save(state);
+//     after a crash:
+//         if(file.open("saves/match.hhs") && file.load(state))
+//             match.restore(state);
+//
+// The file holds two slots and each save goes into the older one, last
+// of all stamping it with a sequence number and a checksum, so a process
+// dying halfway through a save still leaves the one before it to load.
+// A state too big for the slots grows the file, bringing the newest save
+// along into the first slot, so growing doesn't lose it either.
+// The pages are shared with the OS, which writes them out in its own
+// time; flush() waits for that, for surviving the machine going down
+// too.
+//
+// Numbers are stored in the machine's own byte order: a save is for
+// resuming on the same kind of machine, not for passing around.
+////////////////
+
+class MatchSave
+{
+public:
+    MatchSave(){};
+    ~MatchSave();
+    MatchSave(const MatchSave&) = delete;
+    MatchSave& operator=(const MatchSave&) = delete;
+
+    // Maps filename, making an empty save there if there isn't one; false
+    // (and the file untouched) if it's something else, an older version's
+    // save included
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const { return data != NULL; };
+    const std::string& getFilename() const { return filename; };
+
+    // Over the older slot; false if the file couldn't be grown to fit it
+    bool save(const MatchState& state);
+    // The newer of the slots that are whole; false if neither is
+    bool load(MatchState& state) const;
+    // How many saves the newest slot has been through, 0 for none
+    uint32_t getSequence() const;
+    void flush();
+private:
+    struct Slot
+    {
+        uint32_t sequence;
+        uint32_t size;
+        uint32_t checksum;
+    };
+    // where slot (0 or 1) starts
+    char* slotAt(int slot) const;
+    // the slot that loads, -1 for none
+    int newest() const;
+    // sizes the file (and mapping) for slots of slotBytes, with kept (a
+    // slot, header and all, or nothing) in slot 0 and slot 1 empty
+    bool resize(uint32_t slotBytes, const std::vector<char>& kept);
+    bool mapFile(std::size_t length);
+    // where there's no mapping, the whole of buffer goes back to the file
+    bool writeBack();
+
+    std::string filename;
+    char* data = NULL;
+    std::size_t length = 0;
+    bool mapped = false;
+    int fd = -1;
+    std::vector<char> buffer;
+    BitWriter bits;
+};
+
+#endif
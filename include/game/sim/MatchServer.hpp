@@ -0,0 +1,167 @@
+#ifndef MATCH_SERVER_HPP
+#define MATCH_SERVER_HPP
+
+#include <SFML/Network.hpp>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "game/sim/Match.hpp"
+#include "game/sim/MatchSave.hpp"
+#include "game/sim/MatchSnapshot.hpp"
+////////////////
+// MatchServer.hpp
+//
+// Hosts many Matches at once for the dedicated server (bin/HHServer.cpp).
+// Each thread has its own UDP port (port, port + 1, ...) and runs every
+// match that joined on it, at a fixed tick, with nothing shared between
+// threads; put one thread on each core.
+//
+//     MatchServer server;
+//     server.start(5000, 4);
+//     while(...){ sleep(5); server.report(std::cout); }
+//
+// Clients (see MatchClient) JOIN a match by its seed, which makes it if
+// nobody's playing it yet, asking for some of its seats. JOINED tells them
+// which seats they got, the first free ones (none once the match is full:
+// they just watch). They send INPUT every tick for their seats, and input
+// for anyone else's seat is ignored. They get a SNAPSHOT back every tick,
+// delta compressed against the last one they acked. A match is dropped
+// once its clients LEAVE, or haven't sent anything for a while; a seat is
+// free again once its client is gone.
+//
+// ASK_LOAD gets a thread's LOAD back: how much of each tick it spends
+// working, which is what matches per core comes from.
+//
+// With checkpoints on, every match is quick-saved (see MatchSave) into
+// directory every so often, and a JOIN for a match that isn't running
+// but has a save there picks it up from that save, so a server that went
+// down carries on where it was once its clients rejoin.
+////////////////
+
+class MatchServer
+{
+public:
+    // first byte after the magic
+    enum MESSAGE {JOIN, JOINED, INPUT, SNAPSHOT, ASK_LOAD, LOAD, LEAVE};
+    // "HS"
+    static const sf::Uint16 MAGIC = 0x4853;
+    // a snapshot against nothing, or an ack of nothing
+    static const sf::Uint32 NO_TICK = 0xffffffff;
+    // bytes before a SNAPSHOT's bits: magic, type, seed, tick, base
+    static const std::size_t SNAPSHOT_HEADER = 15;
+
+    // One thread's work over a stretch of time
+    struct Load
+    {
+        int matches = 0;
+        int clients = 0;
+        // match ticks run, and matches that ended
+        unsigned int ticks = 0;
+        unsigned int finished = 0;
+        float seconds = 0;
+        // spent receiving, ticking and sending
+        float busySeconds = 0;
+        // ticks that started late because the last one ran long
+        unsigned int overruns = 0;
+        unsigned int bytesSent = 0;
+        unsigned int bytesReceived = 0;
+        unsigned int snapshotsSent = 0;
+        // how many matches this thread could keep up with
+        float getMatchesPerCore() const { return busySeconds > 0 ? matches * seconds / busySeconds : 0; };
+        // counters between two totals (matches and clients are later's)
+        Load since(const Load& earlier) const;
+        // what LOAD carries
+        void pack(sf::Packet& packet) const;
+        bool unpack(sf::Packet& packet);
+    };
+
+    MatchServer();
+    ~MatchServer();
+    // threads threads, on port up to port + threads - 1
+    bool start(unsigned short port, int threads);
+    void stop();
+    void setTickRate(float hz){ tickSeconds = 1 / hz; };
+    // snapshots go out every this many ticks
+    void setSnapshotInterval(int ticks){ snapshotInterval = ticks < 1 ? 1 : ticks; };
+    void setIdleTimeout(float seconds){ idleSeconds = seconds; };
+    // For new matches; false (keeping the rules it had) if their health
+    // doesn't fit in a snapshot (see MatchSnapshot::fits)
+    bool setRules(const Match::Rules& rules);
+    // Quick-saves each match in directory (which has to be there) every
+    // this many seconds; an empty directory turns it off
+    void setCheckpoints(const std::string& directory, float everySeconds);
+
+    // Each thread's Load since the last call
+    std::vector<Load> takeLoad();
+    // Adds up threads' loads (matches per core averages over them)
+    static Load total(const std::vector<Load>& loads);
+    void report(std::ostream& out);
+private:
+    // snapshots kept per client for deltas
+    static const sf::Uint32 HISTORY = 32;
+    struct Client
+    {
+        sf::IpAddress address;
+        unsigned short port;
+        sf::Uint32 acked = NO_TICK;
+        double heard = 0;
+        std::vector<MatchSnapshot> sent;
+        // the players it sends input for
+        std::vector<sf::Uint8> seats;
+        bool owns(int seat) const;
+    };
+    struct Hosted
+    {
+        sf::Uint32 seed;
+        std::unique_ptr<Match> match;
+        std::vector<Client> clients;
+        sf::Uint32 tick = 0;
+        bool ended = false;
+        // open while checkpointing
+        std::unique_ptr<MatchSave> save;
+    };
+    struct Worker
+    {
+        sf::UdpSocket socket;
+        std::thread thread;
+        // by seed
+        std::map<sf::Uint32, std::unique_ptr<Hosted>> matches;
+        double started = 0;
+        std::mutex lock;
+        // everything since started, and as of the last takeLoad(); guarded
+        // by lock
+        Load load;
+        Load taken;
+        // reused for every checkpoint
+        MatchState state;
+    };
+    void run(Worker& w);
+    void receive(Worker& w, Load& load, double now);
+    void join(Worker& w, sf::Packet& packet, const sf::IpAddress& address, unsigned short port, double now);
+    void input(Worker& w, sf::Packet& packet, const sf::IpAddress& address, unsigned short port, double now);
+    void leave(Worker& w, sf::Packet& packet, const sf::IpAddress& address, unsigned short port);
+    void sendSnapshots(Worker& w, Hosted& h, Load& load);
+    // opens h's save, resuming from it if there's one for its seed
+    void openSave(Worker& w, Hosted& h);
+    std::string getSavePath(sf::Uint32 seed) const;
+    Hosted* find(Worker& w, sf::Uint32 seed);
+    Client* findClient(Hosted& h, const sf::IpAddress& address, unsigned short port);
+    // up to count seats of h nobody has, first first
+    std::vector<sf::Uint8> freeSeats(const Hosted& h, int count) const;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> running;
+    float tickSeconds = 1 / 60.0f;
+    int snapshotInterval = 1;
+    float idleSeconds = 10;
+    Match::Rules rules;
+    std::string checkpointDirectory;
+    float checkpointSeconds = 5;
+};
+
+#endif
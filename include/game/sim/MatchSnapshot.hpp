@@ -0,0 +1,63 @@
+#ifndef MATCH_SNAPSHOT_HPP
+#define MATCH_SNAPSHOT_HPP
+
+#include <cstdint>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+#include "engine/BitStream.hpp"
+#include "game/sim/Match.hpp"
+////////////////
+// MatchSnapshot.hpp
+//
+// What a client sees of a Match each tick: where everyone is, their
+// health, and a few flags. Positions are kept in quarter pixels.
+//
+// Written as a delta against an earlier snapshot the client already has
+// (the last one it acked), so most ticks cost a bit or two for anyone
+// standing still and about three bytes for anyone walking:
+//
+//     snapshot.capture(match, tick);
+//     snapshot.write(out, acked ? &history[acked] : NULL);
+//     ...
+//     received.read(in, &history[base]);
+//
+// With no base, everything is written against zero.
+////////////////
+
+struct MatchSnapshot
+{
+    enum FLAG {INVULNERABLE = 1, ATTACKING = 2, READING = 4, HAS_ITEM = 8, CHASING = 16};
+    // what the fields are wide enough for: a player count in 3 bits (the
+    // game seats 4) and health in 4
+    static const int MAX_PLAYERS = 4;
+    static const int MAX_HEALTH = 15;
+    // false if anyone could start a match with more health than a
+    // snapshot can carry
+    static bool fits(const Match::Rules& rules);
+    // players, then the ghost once it's out
+    struct Entity
+    {
+        uint16_t x = 0;
+        uint16_t y = 0;
+        uint8_t health = 0;
+        // FLAGs, and Match::FACING above them
+        uint8_t flags = 0;
+        sf::Vector2f getPosition() const { return sf::Vector2f(x / 4.0f, y / 4.0f); };
+        Match::FACING getFacing() const { return static_cast<Match::FACING>(flags >> 5); };
+        bool operator==(const Entity& e) const { return x == e.x && y == e.y && health == e.health && flags == e.flags; };
+    };
+    uint32_t tick = 0;
+    uint8_t result = Match::PLAYING;
+    uint8_t phase = 1;
+    std::vector<Entity> entities;
+    int playerCount = 0;
+
+    void capture(const Match& match, uint32_t tick);
+    bool hasVillain() const { return static_cast<int>(entities.size()) > playerCount; };
+    // base can be NULL; the reader has to use the same one
+    void write(BitWriter& out, const MatchSnapshot* base) const;
+    // false if it didn't decode (short or corrupt)
+    bool read(BitReader& in, const MatchSnapshot* base);
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef MATCH_STATE_HPP
+#define MATCH_STATE_HPP
+
+#include <cstdint>
+#include <vector>
+#include <SFML/System/Vector2.hpp>
+#include "engine/BitStream.hpp"
+#include "engine/Input.hpp"
+#include "game/sim/Match.hpp"
+////////////////
+// MatchState.hpp
+//
+// Everything a Match is at one tick, written down: the house's room grid,
+// every clue's roll and whether it's open, the players and the ghost down
+// to their timers, what each player was holding, how far each random
+// stream has got and the phase clock. Restoring it carries on exactly
+// where it left off (see Match::save() and Match::restore()), so it's what
+// replays, save files and server hand-offs are made of. MatchSnapshot is
+// the much smaller part of this a client needs to draw a tick.
+//
+//     MatchState state;
+//     match.save(state);
+//     state.write(out, &keyframe);          // or NULL for a keyframe
+//     ...
+//     loaded.read(in, &keyframe);
+//     match.restore(loaded);
+//
+// Written as a delta against a base state (a keyframe, or the last one the
+// reader acked): anything the same as in the base costs a bit, so between
+// ticks only the walkers and the clocks are written. The room grid and the
+// clue rolls never change, so after the keyframe they're a bit each too.
+//
+// QUANTIZED keeps positions in quarter pixels, directions in 127ths,
+// timers in milliseconds and speeds in 64ths, which is plenty to look at;
+// EXACT writes every float whole, for anything that has to play on
+// from it identically.
+////////////////
+
+struct MatchState
+{
+    enum PRECISION {QUANTIZED, EXACT};
+
+    // A room by where it sits on the grid and what it is; the rest of
+    // HouseLayout follows from these
+    struct Room
+    {
+        uint8_t gridX = 0;
+        uint8_t gridY = 0;
+        uint8_t type = 1;
+        bool operator==(const Room& r) const { return gridX == r.gridX && gridY == r.gridY && type == r.type; };
+    };
+    // What isn't worked out from the furniture it sits behind
+    struct Clue
+    {
+        uint8_t tier = Match::WORTHLESS;
+        uint8_t highLow = 0;
+        bool open = false;
+    };
+    // A player's side of Match::setInput(): what they held last tick
+    // (for telling presses from holds) and what they hold for the next
+    struct Controls
+    {
+        Input::Actions last;
+        Input::Actions held;
+        sf::Vector2f move;
+    };
+
+    // all 64 bits, since the match's streams are keyed by it
+    uint64_t seed = 0;
+    uint32_t tick = 0;
+    uint8_t result = Match::PLAYING;
+    uint8_t phase = 1;
+    float time = 0;
+    float phaseTime = 0;
+    std::vector<Room> rooms;
+    // in the order Match rolls them: room by room, furniture in order
+    std::vector<Clue> clues;
+    std::vector<Match::Player> players;
+    std::vector<Controls> controls;
+    Match::Villain villain;
+    // RandomStream::getPosition() of each of the match's streams
+    uint64_t spawnDrawn = 0;
+    uint64_t clueDrawn = 0;
+    uint64_t villainDrawn = 0;
+
+    // base can be NULL; the reader has to use the same one
+    void write(BitWriter& out, const MatchState* base, PRECISION precision = QUANTIZED) const;
+    // false if it didn't decode (short or corrupt)
+    bool read(BitReader& in, const MatchState* base);
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include "HouseHaunters.hpp"
 #include <iostream>
+#include "game/Tuning.hpp"
 
 ////////////////////////
 // HouseHaunters.cpp
@@ -13,13 +14,17 @@
 void HouseHauntersGame::init()
 {
     config = std::make_shared<Config>();
+    config->seed = seed;
+    config->save_file = saveFile;
+    config->resume = resumeSave;
     this->setName("House Haunters");
     // Setup the window position and dimensions
     this->setWindowRect(100, 100, config->width, config->height);
     // Initialize the game screendisableGamepads
     std::unique_ptr<GameScreen> screen_gamestory = std::unique_ptr<GameScreen>(new GamestoryScreen());
     screen_gamestory->setConfig(config);
-    std::unique_ptr<GameScreen> screen_gameplay  = std::unique_ptr<GameScreen>(new GameplayScreen());
+    gameplay = new GameplayScreen();
+    std::unique_ptr<GameScreen> screen_gameplay  = std::unique_ptr<GameScreen>(gameplay);
     screen_gameplay->setConfig(config);
     std::unique_ptr<GameScreen> screen_gametitle = std::unique_ptr<GameScreen>(new GametitleScreen());
     screen_gametitle->setConfig(config);
@@ -35,6 +40,66 @@ void HouseHauntersGame::init()
     this->addGameScreen("GamePlay",  std::move(screen_gameplay) );
     this->addGameScreen("GameEnd",   std::move(screen_end) );
 
+    // Render every font size the screens use and lay out all the clues up
+    // front, so text never has to be rasterized or laid out mid-game
+    GlyphAtlas::get("../resources/fonts/youmurderer.ttf", 100);
+    GlyphAtlas::get("../resources/fonts/youmurderer.ttf", 30);
+    GlyphAtlas::get("../resources/fonts/Underdog-Regular.ttf", 30);
+    GlyphAtlas::get("../resources/fonts/Underdog-Regular.ttf", 24, true);
+    PlayerHUD::prepareClues();
+    // speeds, health, damage and so on; saving the file reloads it
+    Tuning::load("../resources/tuning.txt");
+
+    if(bots > 0){
+        // past every joystick and the keyboard, fed by feedBots()
+        quickStart.clear();
+        if(!watchBots)
+            quickStart.push_back(this->getKeyboardIndex());
+        botPads.clear();
+        for(int i = 0; i < bots && quickStart.size() < 4; i++){
+            botPads.push_back(sf::Joystick::Count + 1 + i);
+            quickStart.push_back(botPads.back());
+        }
+        this->setInputFeed([this](double now){ this->feedBots(now); });
+    }
+    if(!quickStart.empty()){
+        config->num_players = quickStart.size();
+        for(std::size_t i = 0; i < quickStart.size(); i++){
+            config->player_map[quickStart[i]] = i + 1;
+            config->char_map[i + 1] = static_cast<Config::CHARACTER>(i % 4);
+        }
+        this->changeGameScreen("GamePlay");
+        return;
+    }
     // start off at title screen
     this->changeGameScreen("Story");
 }
+
+void HouseHauntersGame::onFrame()
+{
+    Tuning::poll();
+}
+
+void HouseHauntersGame::feedBots(double now)
+{
+    const Match* match = gameplay->getMatch();
+    if(match && (match != botMatch || match->getTicks() < botTicks)){
+        seatBots.clear();
+        for(std::size_t i = 0; i < botPads.size(); i++)
+            seatBots.push_back(MatchBot(config->player_map[botPads[i]] - 1, match->getSeed() + i));
+        botMatch = match;
+    }
+    if(match)
+        botTicks = match->getTicks();
+    float dt = 1 / this->getTickRate();
+    for(std::size_t i = 0; i < seatBots.size(); i++){
+        Input::Actions held;
+        sf::Vector2f move;
+        // hands off the pad once the match is over, or it'd be pressing
+        // through the screens after it
+        int seat = seatBots[i].getPlayer();
+        if(match->getResult() == Match::PLAYING && seat >= 0 && seat < static_cast<int>(match->getPlayers().size()))
+            held = seatBots[i].think(*match, dt, move);
+        this->feedInput(botPads[i], held, move, now);
+    }
+}
@@ -1,5 +1,14 @@
 #include "components/EntityGroup.hpp"
+#include "game/rooms/RoomGroup.hpp"
 #include <iostream>
+
+namespace
+{
+    // further than anything moves or looks in one tick
+    const float REACH = 16;
+    // fewer characters than this aren't worth handing to other threads
+    const std::size_t PARALLEL_MIN = 32;
+}
 void EntityGroup::init()
 {   
     std::cout << characters.size() << std::endl;
@@ -10,10 +19,12 @@ void EntityGroup::init()
 // Add a character entity
 void EntityGroup::addCharacter(std::shared_ptr<Character> c)
 {
+    drawOrder.push_back(Drawn{c.get(), &c->hbox});
     characters.push_back(std::move(c));
 }
 void EntityGroup::addClue(std::shared_ptr<Clue> c)
 {
+    drawOrder.push_back(Drawn{c.get(), &c->hbox});
     clues.push_back(std::move(c));
 }
 // convert our ordered set into an array
@@ -46,34 +57,101 @@ std::shared_ptr<Clue> EntityGroup::getClue(int cnum)
     return NULL;
 }
 
-void EntityGroup::drawInArea(sf::RenderTarget& ctx, sf::FloatRect box) const
+int EntityGroup::drawInArea(sf::RenderTarget& ctx, sf::FloatRect box) const
 {
-    for(auto it = characters.begin(); it != characters.end(); it++){
-        if((*it)->hbox.intersects(box))
-            ctx.draw((**it));
+    int drawn = 0;
+    for(auto it = drawOrder.begin(); it != drawOrder.end(); it++){
+        if(it->box->intersects(box)){
+            ctx.draw(*it->object);
+            drawn++;
+        }
     }
+    return drawn;
 };
 
 
+const std::vector<Character*>& EntityGroup::getNeighbours(const Character& c) const
+{
+    static const std::vector<Character*> none;
+    // added since the last partition
+    if(c.island < 0 || c.island >= static_cast<int>(islands.size()))
+        return none;
+    return islands[c.island];
+}
+
+void EntityGroup::partition()
+{
+    areas.clear();
+    if(rooms)
+        for(auto it = rooms->rooms.begin(); it != rooms->rooms.end(); it++)
+            areas.push_back((*it)->hbox);
+    boxes.resize(characters.size());
+    for(std::size_t i = 0; i < characters.size(); i++)
+        boxes[i] = characters[i]->hbox;
+    split.partition(areas, boxes, REACH);
+    // keep the old vectors' memory
+    islands.resize(split.getCount());
+    for(std::size_t i = 0; i < islands.size(); i++){
+        islands[i].clear();
+        const std::vector<std::size_t>& members = split.getMembers(i);
+        for(auto it = members.begin(); it != members.end(); it++)
+            islands[i].push_back(characters[*it].get());
+    }
+    for(std::size_t i = 0; i < characters.size(); i++)
+        characters[i]->island = split.getIsland(i);
+}
+
+void EntityGroup::updateIsland(std::size_t i, float dt)
+{
+    for(auto it = islands[i].begin(); it != islands[i].end(); it++)
+        (*it)->update(dt);
+}
+
 // Update every entity
 void EntityGroup::onUpdate(float dt)
 {
-    for(auto it = characters.begin(); it != characters.end(); it++){
-        (*it)->update(dt);
+    partition();
+    if(jobs && jobs->getThreadCount() > 1 && islands.size() > 1 && characters.size() >= PARALLEL_MIN){
+        // each island's events are queued in island order once they're all done
+        std::vector<std::vector<base_event_type>> queued(islands.size());
+        jobs->parallelFor(islands.size(), 1, [&](std::size_t begin, std::size_t end){
+            // whatever this thread was capturing into before (a rollback's
+            // replay), which the events go on to below
+            std::vector<base_event_type>* outer = Events::captureQueued(NULL);
+            for(std::size_t i = begin; i < end; i++){
+                Events::captureQueued(&queued[i]);
+                updateIsland(i, dt);
+            }
+            Events::captureQueued(outer);
+        });
+        for(auto q = queued.begin(); q != queued.end(); q++)
+            for(auto e = q->begin(); e != q->end(); e++)
+                Events::queueEvent((*e)->getEventType(), *e);
+    }
+    else{
+        for(std::size_t i = 0; i < islands.size(); i++)
+            updateIsland(i, dt);
+    }
+    sortDrawOrder();
+}
+
+void EntityGroup::sortDrawOrder()
+{
+    for(std::size_t i = 1; i < drawOrder.size(); i++){
+        Drawn d = drawOrder[i];
+        std::size_t j = i;
+        while(j > 0 && drawOrder[j - 1].object->z_index > d.object->z_index){
+            drawOrder[j] = drawOrder[j - 1];
+            j--;
+        }
+        drawOrder[j] = d;
     }
-    // Sort our entities
-    std::sort(characters.begin(), characters.end(), [](std::shared_ptr<GameObject> a, std::shared_ptr<GameObject> b){
-        return a->z_index < b->z_index;
-    });
 }
 
 // Draw every entity
 void EntityGroup::onDraw(sf::RenderTarget& ctx, sf::RenderStates states) const
 {
-    for(auto it = characters.begin(); it != characters.end(); it++){
-        ctx.draw(**it);
-    }
-    for(auto it = clues.begin(); it != clues.end(); it++){
-        ctx.draw(**it);
+    for(auto it = drawOrder.begin(); it != drawOrder.end(); it++){
+        ctx.draw(*it->object);
     }
 }
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "components/Islands.hpp"
+
+std::size_t Islands::find(std::size_t a)
+{
+    while(parent[a] != a)
+        a = parent[a] = parent[parent[a]];
+    return a;
+}
+
+void Islands::partition(const std::vector<sf::FloatRect>& areas,
+                        const std::vector<sf::FloatRect>& boxes, float reach)
+{
+    std::size_t outside = areas.size();
+    parent.resize(areas.size() + 1);
+    for(std::size_t a = 0; a < parent.size(); a++)
+        parent[a] = a;
+    home.assign(boxes.size(), outside);
+    for(std::size_t i = 0; i < boxes.size(); i++){
+        const sf::FloatRect& b = boxes[i];
+        sf::FloatRect reaches(b.left - reach, b.top - reach, b.width + 2 * reach, b.height + 2 * reach);
+        for(std::size_t a = 0; a < areas.size(); a++){
+            if(!areas[a].intersects(reaches))
+                continue;
+            if(home[i] == outside)
+                home[i] = a;
+            else
+                parent[find(a)] = find(home[i]);
+        }
+    }
+    number.assign(areas.size() + 1, -1);
+    island.resize(boxes.size());
+    count = 0;
+    for(std::size_t i = 0; i < boxes.size(); i++){
+        std::size_t root = find(home[i]);
+        if(number[root] < 0){
+            number[root] = count++;
+            if(members.size() < count)
+                members.resize(count);
+            members[count - 1].clear();
+        }
+        members[number[root]].push_back(i);
+        island[i] = number[root];
+    }
+}
@@ -54,6 +54,14 @@ void SpriteAnimation::nextFrame(float dt)
     this->time = 0;
 }
 
+SpriteSnapshot SpriteAnimation::snapshot(const sf::Transform& parent) const
+{
+    SpriteSnapshot s;
+    s.sprite = sprite;
+    s.transform = parent * getTransform();
+    return s;
+}
+
 void SpriteAnimation::onDraw(sf::RenderTarget& target, sf::RenderStates states) const
 {
     // draw sprite
@@ -0,0 +1,64 @@
+#include "engine/BitStream.hpp"
+
+void BitWriter::write(uint32_t value, int bits)
+{
+    while(bits > 0){
+        std::size_t bit = count % 8;
+        if(bit == 0)
+            data.push_back(0);
+        // as much of value as fits in the last byte
+        int n = 8 - static_cast<int>(bit);
+        if(n > bits)
+            n = bits;
+        data.back() |= static_cast<uint8_t>((value & ((1u << n) - 1)) << bit);
+        value >>= n;
+        bits -= n;
+        count += n;
+    }
+}
+
+void BitWriter::writeSigned(int32_t value, int bits)
+{
+    uint32_t zigzag = (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    write(zigzag, bits);
+}
+
+void BitWriter::clear()
+{
+    data.clear();
+    count = 0;
+}
+
+BitReader::BitReader(const void* data, std::size_t bytes)
+    : data(static_cast<const uint8_t*>(data)), size(bytes)
+{
+}
+
+uint32_t BitReader::read(int bits)
+{
+    if(count + bits > size * 8){
+        valid = false;
+        count = size * 8;
+        return 0;
+    }
+    uint32_t value = 0;
+    int shift = 0;
+    while(bits > 0){
+        std::size_t bit = count % 8;
+        int n = 8 - static_cast<int>(bit);
+        if(n > bits)
+            n = bits;
+        uint32_t part = (data[count / 8] >> bit) & ((1u << n) - 1);
+        value |= part << shift;
+        shift += n;
+        bits -= n;
+        count += n;
+    }
+    return value;
+}
+
+int32_t BitReader::readSigned(int bits)
+{
+    uint32_t zigzag = read(bits);
+    return static_cast<int32_t>(zigzag >> 1) ^ -static_cast<int32_t>(zigzag & 1);
+}
@@ -0,0 +1,78 @@
+#include "engine/Compositor.hpp"
+#include "engine/ResourceManager.hpp"
+#include <iostream>
+
+bool Compositor::create(unsigned int width, unsigned int height)
+{
+    if(ready && size.x == width && size.y == height){
+        // a new set of views, don't let the old ones show through the gutters
+        layer.clear(sf::Color::Black);
+        return true;
+    }
+    size = sf::Vector2u(width, height);
+    ready = layer.create(width, height);
+    if(!ready){
+        std::cout << "Couldn't create the " << width << "x" << height << " compositor layer" << std::endl;
+        return false;
+    }
+    layer.clear(sf::Color::Black);
+    layer.display();
+
+    if(lightMap.create(width, height))
+        return true;
+    shader = ResourceManager::getShader("../resources/shaders/VertexShader.txt", "../resources/shaders/CompositeShader.txt");
+    lit = shader != NULL;
+    if(!lit)
+        std::cout << "Composite lighting is unavailable, views will be drawn unlit" << std::endl;
+    return true;
+}
+
+void Compositor::clearLights()
+{
+    lightMap.clear();
+    lights = 0;
+}
+
+void Compositor::addLights(const sf::View& camera, const std::vector<Light>& lights)
+{
+    lightMap.addView(camera, lights);
+}
+
+void Compositor::addViewLight(sf::FloatRect viewport, float radius)
+{
+    if(lights == MAX_VIEWS)
+        return;
+    // viewport is a fraction of the window, with y going down
+    float left = viewport.left * size.x;
+    float width = viewport.width * size.x;
+    float height = viewport.height * size.y;
+    float bottom = size.y - (viewport.top * size.y + height);
+    viewMin[lights] = sf::Vector2f(left, bottom);
+    viewMax[lights] = sf::Vector2f(left + width, bottom + height);
+    centers[lights] = sf::Vector2f(left + width / 2.0f, bottom + height / 2.0f);
+    radii[lights] = radius;
+    lights++;
+}
+
+void Compositor::compose(sf::RenderTarget& target)
+{
+    layer.display();
+    sf::Sprite frame(layer.getTexture());
+    target.setView(target.getDefaultView());
+    if(lightMap.isReady()){
+        lightMap.apply(target, layer.getTexture());
+        return;
+    }
+    if(!lit){
+        target.draw(frame);
+        return;
+    }
+    // every frame, since a reloaded shader starts with none set
+    shader->setUniform("texture", sf::Shader::CurrentTexture);
+    shader->setUniformArray("viewMin", viewMin, MAX_VIEWS);
+    shader->setUniformArray("viewMax", viewMax, MAX_VIEWS);
+    shader->setUniformArray("centers", centers, MAX_VIEWS);
+    shader->setUniformArray("radii", radii, MAX_VIEWS);
+    shader->setUniform("count", lights);
+    target.draw(frame, shader);
+}
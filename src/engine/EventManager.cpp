@@ -5,6 +5,11 @@ long Events::listener_id = 0;
 std::map< std::string, event_list > Events::listeners_map;
 std::queue< base_event_type > Events::events;
 
+namespace
+{
+    thread_local std::vector<base_event_type>* captured = NULL;
+}
+
 long Events::addEventListener(std::string type, std::function<void (base_event_type)> listener)
 { 
     // if event type not in map, add it (?)
@@ -19,9 +24,19 @@ long Events::addEventListener(std::string type, std::function<void (base_event_t
 void Events::queueEvent(std::string type, base_event_type e)
 { 
     e->setEventType(type);
-    events.push(e);
+    if(captured)
+        captured->push_back(e);
+    else
+        events.push(e);
 };
 
+std::vector<base_event_type>* Events::captureQueued(std::vector<base_event_type>* into)
+{
+    std::vector<base_event_type>* was = captured;
+    captured = into;
+    return was;
+}
+
 void Events::triggerEvent(std::string type, base_event_type e)
 {
     e->setEventType(type);
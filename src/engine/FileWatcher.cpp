@@ -0,0 +1,119 @@
+#include "engine/FileWatcher.hpp"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <sys/stat.h>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#define FILE_WATCHER_INOTIFY
+#endif
+
+namespace
+{
+    // how often wait() looks at modification times without inotify
+    const int STAT_EVERY_MS = 50;
+}
+
+FileWatcher::~FileWatcher()
+{
+#ifdef FILE_WATCHER_INOTIFY
+    if(fd >= 0)
+        close(fd);
+#endif
+}
+
+long long FileWatcher::modifiedTime(const std::string& filename)
+{
+    struct stat st;
+    if(stat(filename.c_str(), &st) != 0)
+        return -1;
+    return static_cast<long long>(st.st_mtime);
+}
+
+bool FileWatcher::watch(const std::string& filename)
+{
+    File file;
+    file.name = filename;
+    std::size_t slash = filename.rfind('/');
+    file.directory = slash == std::string::npos ? "." : filename.substr(0, slash);
+    file.base = slash == std::string::npos ? filename : filename.substr(slash + 1);
+    file.modified = modifiedTime(filename);
+#ifdef FILE_WATCHER_INOTIFY
+    if(fd < 0)
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    // the same directory twice gives back the same watch
+    int wd = fd < 0 ? -1 : inotify_add_watch(fd, file.directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if(wd < 0){
+        std::cout << "FileWatcher: couldn't watch " << file.directory << std::endl;
+        return false;
+    }
+    directories[wd] = file.directory;
+#endif
+    files.push_back(file);
+    return true;
+}
+
+std::vector<std::string> FileWatcher::poll()
+{
+    std::vector<std::string> saved;
+#ifdef FILE_WATCHER_INOTIFY
+    if(fd < 0)
+        return saved;
+    // a read gives back whole events, each a header and its name
+    alignas(inotify_event) char buffer[4096];
+    ssize_t length;
+    while((length = read(fd, buffer, sizeof(buffer))) > 0){
+        for(char* at = buffer; at < buffer + length; at += sizeof(inotify_event) + reinterpret_cast<inotify_event*>(at)->len){
+            const inotify_event* e = reinterpret_cast<const inotify_event*>(at);
+            if(e->len == 0)
+                continue;
+            auto directory = directories.find(e->wd);
+            if(directory == directories.end())
+                continue;
+            for(auto it = files.begin(); it != files.end(); it++){
+                if(it->base == e->name && it->directory == directory->second &&
+                   std::find(saved.begin(), saved.end(), it->name) == saved.end())
+                    saved.push_back(it->name);
+            }
+        }
+    }
+#else
+    compareTimes(saved);
+#endif
+    return saved;
+}
+
+std::vector<std::string> FileWatcher::wait(int timeoutMs)
+{
+#ifdef FILE_WATCHER_INOTIFY
+    if(fd >= 0){
+        pollfd p = {fd, POLLIN, 0};
+        ::poll(&p, 1, timeoutMs);
+    }
+    return poll();
+#else
+    std::vector<std::string> saved;
+    for(int waited = 0; ; waited += STAT_EVERY_MS){
+        compareTimes(saved);
+        if(!saved.empty() || waited >= timeoutMs)
+            return saved;
+        std::this_thread::sleep_for(std::chrono::milliseconds(std::min(STAT_EVERY_MS, timeoutMs - waited)));
+    }
+#endif
+}
+
+void FileWatcher::compareTimes(std::vector<std::string>& saved)
+{
+    for(auto it = files.begin(); it != files.end(); it++){
+        long long modified = modifiedTime(it->name);
+        if(modified == it->modified)
+            continue;
+        it->modified = modified;
+        if(modified >= 0)
+            saved.push_back(it->name);
+    }
+}
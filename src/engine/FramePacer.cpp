@@ -0,0 +1,120 @@
+#include "engine/FramePacer.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+bool FramePacer::parseMode(const std::string& name, MODE& mode)
+{
+    for(int m = VSYNC; m <= ADAPTIVE; m++){
+        if(name == getModeName(MODE(m))){
+            mode = MODE(m);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* FramePacer::getModeName(MODE mode)
+{
+    switch(mode){
+        case VSYNC:    return "vsync";
+        case CAPPED:   return "capped";
+        case UNCAPPED: return "uncapped";
+        case ADAPTIVE: return "adaptive";
+    }
+    return "?";
+}
+
+void FramePacer::apply(sf::Window& window)
+{
+    window.setVerticalSyncEnabled(mode == VSYNC);
+    window.setFramerateLimit(mode == CAPPED ? static_cast<unsigned int>(fps) : 0);
+    started = false;
+}
+
+void FramePacer::frameDone()
+{
+    Clock::time_point now = Clock::now();
+    if(mode == ADAPTIVE){
+        if(!started)
+            deadline = now;
+        deadline += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+        // fell behind, start over from now rather than rushing to catch up
+        if(deadline < now)
+            deadline = now;
+        else
+            waitUntil(deadline);
+        now = Clock::now();
+    }
+    if(started){
+        double ms = std::chrono::duration<double, std::milli>(now - last).count();
+        int bucket = std::min(BUCKETS - 1, static_cast<int>(ms / BUCKET_MS));
+        histogram[bucket]++;
+        frames++;
+        total += ms;
+        worst = std::max(worst, ms);
+    }
+    started = true;
+    last = now;
+}
+
+void FramePacer::waitUntil(Clock::time_point deadline)
+{
+    std::chrono::duration<double> sleep = deadline - Clock::now() - std::chrono::duration<double>(margin);
+    if(sleep.count() > 0){
+        Clock::time_point wake = Clock::now() + std::chrono::duration_cast<Clock::duration>(sleep);
+        std::this_thread::sleep_for(sleep);
+        double late = std::chrono::duration<double>(Clock::now() - wake).count() * 1.25;
+        // grow straight away after a late wakeup, shrink slowly after good ones
+        margin = late > margin ? late : margin * 0.95 + late * 0.05;
+        margin = std::max(0.0002, std::min(0.004, margin));
+    }
+    // the rest is too short to trust the scheduler with
+    while(Clock::now() < deadline)
+        std::this_thread::yield();
+}
+
+void FramePacer::reset()
+{
+    std::fill(histogram, histogram + BUCKETS, 0);
+    frames = 0;
+    total = 0;
+    worst = 0;
+}
+
+void FramePacer::report(std::ostream& out) const
+{
+    char line[128];
+    out << getModeName(mode) << " pacing: " << frames << " frames";
+    if(frames == 0){
+        out << std::endl;
+        return;
+    }
+    // percentiles are reported as the top of their bucket
+    double p[3] = {0.50, 0.95, 0.99};
+    double at[3] = {0, 0, 0};
+    unsigned int most = *std::max_element(histogram, histogram + BUCKETS);
+    for(int i = 0; i < 3; i++){
+        unsigned int seen = 0;
+        for(int b = 0; b < BUCKETS; b++){
+            seen += histogram[b];
+            if(seen >= p[i] * frames){
+                at[i] = (b + 1) * BUCKET_MS;
+                break;
+            }
+        }
+    }
+    std::snprintf(line, sizeof(line), ", mean %.2f ms, p50 %.1f, p95 %.1f, p99 %.1f, worst %.2f ms",
+                  total / frames, at[0], at[1], at[2], worst);
+    out << line << std::endl;
+    for(int b = 0; b < BUCKETS; b++){
+        if(!histogram[b])
+            continue;
+        int bar = std::max(1, static_cast<int>(40.0 * histogram[b] / most));
+        if(b == BUCKETS - 1)
+            std::snprintf(line, sizeof(line), "  %5.1f+      ms |", b * BUCKET_MS);
+        else
+            std::snprintf(line, sizeof(line), "  %5.1f-%5.1f ms |", b * BUCKET_MS, (b + 1) * BUCKET_MS);
+        out << line << std::string(bar, '#') << " " << histogram[b] << std::endl;
+    }
+}
@@ -0,0 +1,54 @@
+#include "engine/FrameWorker.hpp"
+
+FrameWorker::~FrameWorker()
+{
+    if(!thread.joinable())
+        return;
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        quit = true;
+    }
+    changed.notify_all();
+    thread.join();
+}
+
+void FrameWorker::run(std::function<void()> job)
+{
+    wait();
+    if(!thread.joinable())
+        thread = std::thread(&FrameWorker::loop, this);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->job = std::move(job);
+        busy = true;
+    }
+    changed.notify_all();
+}
+
+void FrameWorker::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this]{ return !busy; });
+}
+
+bool FrameWorker::isWorkerThread() const
+{
+    return std::this_thread::get_id() == thread.get_id();
+}
+
+void FrameWorker::loop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true){
+        changed.wait(lock, [this]{ return busy || quit; });
+        if(quit)
+            return;
+        lock.unlock();
+        job();
+        lock.lock();
+        job = nullptr;
+        busy = false;
+        changed.notify_all();
+    }
+}
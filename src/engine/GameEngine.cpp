@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <iostream>
 #include <typeinfo>       // std::bad_cast
 #include "engine/GameEngine.hpp"
+#include "engine/ResourceManager.hpp"
 
 void GameEngine::start()
 {
@@ -14,51 +16,253 @@ void GameEngine::start()
         auto e = dynamic_cast< Event<std::string>& >(*event);
         this->changeGameScreen(e.data);
     });
+    jobs.start(jobThreads);
+    std::cout << "Job system: " << jobs.getThreadCount() << " threads" << std::endl;
+    if(hotReload)
+        ResourceManager::startWatching();
     // initialize game
     this->init();
     // create window
     window.create(sf::VideoMode(this->winDim.width, this->winDim.height), this->name, sf::Style::Titlebar | sf::Style::Close);
+    // a command key held down is one command
+    window.setKeyRepeatEnabled(false);
+    pacer.apply(window);
     this->running = true;
     // create clock
     sf::Clock clock;
     sf::Time timeSinceLastUpdate = sf::Time::Zero;
-    // This will limit the game to 60fps
-    // It's hardcoded for now, but we should change it...
-    sf::Time timePerFrame = sf::seconds(1.f/60.f);
+    // The simulation runs at a fixed rate, however often frames get drawn
+    sf::Time timePerFrame = sf::seconds(1.f / tickRate);
+    bool ticked = false;
     // main game loop
     while(window.isOpen())
     {
         sf::Time dt = clock.restart();
         timeSinceLastUpdate += dt;
+        loopStats.frames++;
+        loopStats.realSeconds += dt.asSeconds();
+        loopStats.worstFrameSeconds = std::max(loopStats.worstFrameSeconds, dt.asSeconds());
         this->handleEvents();
-        while(timeSinceLastUpdate > timePerFrame)
+        if(quitting)
+            this->exit();
+        // the devices belong to the thread polling the window, so they're
+        // read here, not on the worker the ticks may run on
+        gpcontroller.poll();
+        polledAt = Input::now();
+        this->onFrame();
+        // nothing's ticking or drawing, so textures and shaders can change
+        if(hotReload)
+            ResourceManager::applyReloads();
+        int steps = 0;
+        while(timeSinceLastUpdate > timePerFrame && steps < maxSubSteps)
         {
             ready = true;
+            ticked = true;
+            steps++;
             timeSinceLastUpdate -= timePerFrame;
-            // maybe instead pass in timePerFrame as sf::Time
-
-            this->update(timePerFrame.asSeconds());
+        }
+        loopStats.ticks += steps;
+        loopStats.simSeconds += steps * timePerFrame.asSeconds();
+        if(timeSinceLastUpdate > timePerFrame){
+            // still behind: keep the part of a tick we're into and let the rest go
+            sf::Time kept = timeSinceLastUpdate % timePerFrame;
+            float dropped = (timeSinceLastUpdate - kept).asSeconds();
+            timeSinceLastUpdate = kept;
+            loopStats.behind++;
+            loopStats.droppedSeconds += dropped;
+            if(isDebugMode)
+                std::cout << "Frame took " << dt.asMilliseconds() << " ms, dropped "
+                          << static_cast<int>(dropped * 1000) << " ms of simulation" << std::endl;
+        }
+        float alpha = interpolate ? timeSinceLastUpdate.asSeconds() / timePerFrame.asSeconds() : 1;
+        float tick = timePerFrame.asSeconds();
+        if(pipelined && ready && currScene && currScene->isPipelined()){
+            // draw what the last batch published while this one runs
+            worker.run([this, steps, tick](){ this->simulate(steps, tick); });
+            this->draw();
+            pacer.frameDone();
+            this->displayed();
+            worker.wait();
+            loopStats.pipelined++;
+            if(!pendingScreen.empty()){
+                std::string s;
+                s.swap(pendingScreen);
+                this->changeGameScreen(s);
+                // that input is never shown on this screen
+                batchInput = -1;
+            }
+            else if(steps){
+                currScene->present();
+                this->presented();
+            }
+            // the next frame shows this batch
+            GameObject::interpolation = alpha;
+            continue;
+        }
+        this->simulate(steps, tick);
+        if(steps && currScene){
+            currScene->present();
+            this->presented();
         }
         // The game draws like 3 - 4 times before the game starts....
-        if(ready)
+        if(ready && (interpolate || ticked)){
+            GameObject::interpolation = alpha;
             this->draw();
+            pacer.frameDone();
+            this->displayed();
+            ticked = false;
+        }
+        else if(ready){
+            // nothing new to draw until the next tick
+            sf::sleep(timePerFrame - timeSinceLastUpdate);
+        }
         // update game statistics (running time, framerate, etc...)
         /*this->updateStats();/**/
     }
     this->running = false;
+    ResourceManager::stopWatching();
+    if(isDebugMode){
+        pacer.report(std::cout);
+        reportLoopStats();
+        if(lockstep)
+            lockstep->report(std::cout);
+    }
     
 }
 
+GameEngine::LoopStats GameEngine::takeLoopStats()
+{
+    LoopStats s = loopStats;
+    loopStats = LoopStats();
+    return s;
+}
+
+void GameEngine::reportLoopStats()
+{
+    LoopStats s = takeLoopStats();
+    std::cout << s.ticks << " ticks over " << s.frames << " frames, " << s.behind
+              << " frames behind, " << s.droppedSeconds << " s dropped, simulated "
+              << s.simSeconds << " s of " << s.realSeconds << " s, worst frame "
+              << static_cast<int>(s.worstFrameSeconds * 1000) << " ms, "
+              << s.pipelined << " frames drawn alongside a tick" << std::endl;
+    if(s.inputs)
+        std::cout << s.inputs << " inputs, sampled to displayed in "
+                  << static_cast<int>(s.inputLatencySeconds / s.inputs * 1000) << " ms on average, "
+                  << static_cast<int>(s.worstInputLatencySeconds * 1000) << " ms at worst" << std::endl;
+}
+
+void GameEngine::presented()
+{
+    shownInput = batchInput;
+    batchInput = -1;
+}
+
+void GameEngine::displayed()
+{
+    if(shownInput < 0)
+        return;
+    float latency = static_cast<float>(Input::now() - shownInput);
+    loopStats.inputs++;
+    loopStats.inputLatencySeconds += latency;
+    loopStats.worstInputLatencySeconds = std::max(loopStats.worstInputLatencySeconds, latency);
+    shownInput = -1;
+}
+
+void GameEngine::simulate(int steps, float dt)
+{
+    // notify of anything queued since the last tick (window events, screens)
+    Events::notify();
+    // a screen change waits for the render thread, so stop ticking the old screen
+    for(int i = 0; i < steps && pendingScreen.empty(); i++)
+        this->update(dt);
+    if(steps && currScene)
+        currScene->publish();
+}
+
 void GameEngine::update(float dt)
 {
-    // update controllers
-    gpcontroller.update();
+    // hand out what the controllers held when this frame read them, so a
+    // press is acted on this tick instead of next frame
+    double sampled = polledAt;
+    if(inputFeed)
+        inputFeed(Input::now());
+    if(lockstep){
+        // waiting on someone's input
+        if(!this->syncLockstep(dt))
+            return;
+        if(this->feedLockstep(sampled) > 0 && batchInput < 0)
+            batchInput = sampled;
+    }
+    else if(gpcontroller.update() > 0 && batchInput < 0)
+        batchInput = sampled;
+    this->tick(dt);
+    if(lockstep)
+        lockstep->advance();
+}
+
+void GameEngine::tick(float dt)
+{
+    Events::notify();
+    tweens.update(dt);
     if(this->currScene)
     {
         this->currScene->update(dt);
     }
 }
 
+int GameEngine::feedInput(int index, const Input::Actions& held, sf::Vector2f move, double time)
+{
+    int edges = gpcontroller.feed(index, held, move, time);
+    // timed from when it happened, not when the tick got to it
+    if(edges > 0 && (batchInput < 0 || time < batchInput))
+        batchInput = time;
+    return edges;
+}
+
+bool GameEngine::syncLockstep(float dt)
+{
+    sf::Vector2f move;
+    Input::Actions held = gpcontroller.sample(netDevice, move);
+    lockstep->submit(Lockstep::Frame::pack(held, move));
+    lockstep->receive();
+    // a guess about someone's input was wrong and the game has been put
+    // back to before it; catch up with what they really did
+    int replay = lockstep->rewind();
+    if(replay < 0){
+        // playing on would only drift further from everyone else
+        std::cout << "Netplay: couldn't go back to tick " << lockstep->getTick()
+                  << " after a wrong guess, so this machine is out of step; stopping" << std::endl;
+        this->quit();
+        return false;
+    }
+    if(replay > 0){
+        // Only the screen runs again: the tweens, sounds and events of
+        // these ticks already happened the first time round
+        std::vector<base_event_type> replayed;
+        Events::captureQueued(&replayed);
+        GameObject::replaying = true;
+        for(int i = replay; i > 0 && lockstep->ready(); i--){
+            this->feedLockstep(Input::now());
+            if(currScene)
+                currScene->update(dt);
+            lockstep->advance();
+        }
+        GameObject::replaying = false;
+        Events::captureQueued(NULL);
+    }
+    return lockstep->ready();
+}
+
+int GameEngine::feedLockstep(double time)
+{
+    int edges = 0;
+    for(int p = 0; p < lockstep->getPlayerCount(); p++){
+        const Lockstep::Frame& f = lockstep->getFrame(p);
+        edges += gpcontroller.feed(p, f.getActions(), f.getMove(), time);
+    }
+    return edges;
+}
+
 void GameEngine::draw()
 {
     window.clear(sf::Color::Black);
@@ -76,6 +280,11 @@ void GameEngine::addGameScreen(std::string id, std::unique_ptr<GameScreen> s)
 }
 void GameEngine::changeGameScreen(std::string s)
 {
+    if(worker.isWorkerThread()){
+        // the current screen may be being drawn, change between frames
+        pendingScreen = s;
+        return;
+    }
     bool canChange = true;
     std::cout << "Changing to screen: " << s << std::endl;
     if(this->currScene)
@@ -92,8 +301,25 @@ void GameEngine::changeGameScreen(std::string s)
             std::cout << "initializing scene" << std::endl;
             std::cout << this->currScene;
             this->currScene->init();
+            // so there's something to draw before the first tick
+            this->currScene->publish();
+            this->currScene->present();
         }
+        if(lockstep)
+            this->useRollback();
+    }
+}
+
+void GameEngine::useRollback()
+{
+    GameScreen* screen = currScene;
+    if(!screen || !screen->canRollback() || rollbackTicks <= 0){
+        // nothing to go back with, so every tick waits
+        lockstep->setRollback(Lockstep::Hook(), Lockstep::Restorer());
+        return;
     }
+    lockstep->setRollback([screen](sf::Uint32 t){ screen->saveTick(t); },
+                          [screen](sf::Uint32 t){ return screen->restoreTick(t); }, rollbackTicks);
 }
 
 void GameEngine::handleEvents()
@@ -101,19 +327,26 @@ void GameEngine::handleEvents()
     //mousePos = sf::Mouse::getPosition(window);
     // process events
     // TODO: Move to another function
-    sf::Event Event;
-    while(window.pollEvent(Event))
+    sf::Event event;
+    while(window.pollEvent(event))
     {
-        switch(Event.type)
+        switch(event.type)
         {
             case sf::Event::Closed:
                 this->exit();
                 break;
+            case sf::Event::KeyPressed:
+            {
+                // handed out with the next batch of ticks, before them
+                Input::COMMAND command;
+                if(GamepadController::getCommand(event.key.code, command))
+                    Events::queueEvent("command", std::make_shared< Event<Input::COMMAND> >(command));
+                break;
+            }
+            default:
+                break;
         }
     }
-
-    // notify of all events that took place last frame
-    Events::notify();
 }
 /**
 * Gives you a chance to prevent the game from exiting and/or do
@@ -1,6 +1,14 @@
 #include "engine/GameObject.hpp"
 
 int GameObject::objectCount = 0;
+float GameObject::interpolation = 1;
+bool GameObject::replaying = false;
+
+namespace
+{
+    // anything that moves further than this in one tick was placed, not moved
+    const float MAX_INTERPOLATED_STEP = 64;
+}
 
 GameObject::GameObject()
 {
@@ -9,6 +17,8 @@ GameObject::GameObject()
 // initiates update for all children
 void GameObject::update(float dt)
 {
+    prevPosition = getPosition();
+    hasPrevPosition = true;
     for(auto a = this->children.begin(); a != this->children.end(); a++){
         (*a)->update(dt);
     }
@@ -17,12 +27,28 @@ void GameObject::update(float dt)
 // Initiates the render for all children
 void GameObject::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
+    sf::Vector2f offset = getRenderPosition() - getPosition();
+    states.transform.translate(offset);
     states.transform *= this->getTransform();
     this->onDraw(target, states);
     for(auto a = this->children.begin(); a != this->children.end(); a++){
         target.draw(**a, states);
     }
 }
+sf::Vector2f GameObject::getRenderPosition() const
+{
+    return interpolate(getPreviousPosition(), getPosition());
+}
+
+sf::Vector2f GameObject::interpolate(sf::Vector2f from, sf::Vector2f to)
+{
+    if(interpolation >= 1)
+        return to;
+    sf::Vector2f step = to - from;
+    if(step.x * step.x + step.y * step.y > MAX_INTERPOLATED_STEP * MAX_INTERPOLATED_STEP)
+        return to;
+    return from + step * interpolation;
+}
 // adds children
 void GameObject::addChild(GameObjectPtr o)
 {
@@ -1,48 +1,103 @@
 #include <iostream>
 #include "engine/Gamepad.hpp"
 
-void Gamepad::setLayout(LAYOUT layout)
+namespace
 {
+    typedef Input::Binding B;
+    // how far an axis has to go to count as held (the d-pad is -100, 0 or 100)
+    const float AXIS_HELD = 50;
+    // the stick that walks
+    const sf::Joystick::Axis STICK_X = sf::Joystick::X;
+    const sf::Joystick::Axis STICK_Y = sf::Joystick::Y;
+
+    const Input::Binding KEYBOARD_BINDINGS[] = {
+        {B::KEY, sf::Keyboard::Z,      0, Input::USE},
+        {B::KEY, sf::Keyboard::X,      0, Input::ATTACK},
+        {B::KEY, sf::Keyboard::C,      0, Input::RUN},
+        {B::KEY, sf::Keyboard::V,      0, Input::GIVE_UP},
+        {B::KEY, sf::Keyboard::Up,     0, Input::UP},
+        {B::KEY, sf::Keyboard::Left,   0, Input::LEFT},
+        {B::KEY, sf::Keyboard::Right,  0, Input::RIGHT},
+        {B::KEY, sf::Keyboard::Down,   0, Input::DOWN},
+        {B::KEY, sf::Keyboard::Enter,  0, Input::START},
+    };
+    // SFML treats the d-pad as an axis for some reason....
+    const Input::Binding PS4_BINDINGS[] = {
+        {B::BUTTON, 1, 0, Input::USE},
+        {B::BUTTON, 2, 0, Input::ATTACK},
+        {B::BUTTON, 0, 0, Input::RUN},
+        {B::BUTTON, 3, 0, Input::GIVE_UP},
+        {B::BUTTON, 9, 0, Input::START},
+        {B::AXIS, sf::Joystick::PovY, -1, Input::UP},
+        {B::AXIS, sf::Joystick::PovX, -1, Input::LEFT},
+        {B::AXIS, sf::Joystick::PovX,  1, Input::RIGHT},
+        {B::AXIS, sf::Joystick::PovY,  1, Input::DOWN},
+        {B::AXIS, STICK_Y, -1, Input::UP},
+        {B::AXIS, STICK_X, -1, Input::LEFT},
+        {B::AXIS, STICK_X,  1, Input::RIGHT},
+        {B::AXIS, STICK_Y,  1, Input::DOWN},
+    };
+    // also used for pads we don't recognise
+    const Input::Binding XBOX_BINDINGS[] = {
+        {B::BUTTON, 1, 0, Input::USE},
+        {B::BUTTON, 2, 0, Input::ATTACK},
+        {B::BUTTON, 0, 0, Input::RUN},
+        {B::BUTTON, 3, 0, Input::GIVE_UP},
+        {B::BUTTON, 7, 0, Input::START},
+        {B::AXIS, sf::Joystick::PovY, -1, Input::UP},
+        {B::AXIS, sf::Joystick::PovX, -1, Input::LEFT},
+        {B::AXIS, sf::Joystick::PovX,  1, Input::RIGHT},
+        {B::AXIS, sf::Joystick::PovY,  1, Input::DOWN},
+        {B::AXIS, STICK_Y, -1, Input::UP},
+        {B::AXIS, STICK_X, -1, Input::LEFT},
+        {B::AXIS, STICK_X,  1, Input::RIGHT},
+        {B::AXIS, STICK_Y,  1, Input::DOWN},
+    };
+
+    const Input::CommandBinding COMMAND_BINDINGS[] = {
+        {sf::Keyboard::F5, Input::QUICK_SAVE},
+        {sf::Keyboard::F9, Input::QUICK_LOAD},
+    };
 
+    template<std::size_t N>
+    std::size_t count(const Input::Binding (&)[N]){ return N; }
+}
+
+void Gamepad::setLayout(LAYOUT layout)
+{
     this->layout = layout;
     switch(layout){
         case LAYOUT::KEYBOARD:
-            kbutton_map["A"]     = KBUTTON_S{sf::Keyboard::Key::Z,     false};
-            kbutton_map["B"]     = KBUTTON_S{sf::Keyboard::Key::X,     false};
-            kbutton_map["X"]     = KBUTTON_S{sf::Keyboard::Key::C,     false};
-            kbutton_map["Y"]     = KBUTTON_S{sf::Keyboard::Key::V,     false};
-            kbutton_map["UP"]    = KBUTTON_S{sf::Keyboard::Key::Up,    false};
-            kbutton_map["LEFT"]  = KBUTTON_S{sf::Keyboard::Key::Left,  false};
-            kbutton_map["RIGHT"] = KBUTTON_S{sf::Keyboard::Key::Right, false};
-            kbutton_map["DOWN"]  = KBUTTON_S{sf::Keyboard::Key::Down,  false};
+            bindings = KEYBOARD_BINDINGS;
+            bindingCount = count(KEYBOARD_BINDINGS);
             break;
         case LAYOUT::PS4:
-            button_map["A"]     = BUTTON_S{ 1,  false};
-            button_map["B"]     = BUTTON_S{ 2,  false};
-            button_map["Y"]     = BUTTON_S{ 3,  false};
-            button_map["X"]     = BUTTON_S{ 0,  false};
-            button_map["UP"]    = BUTTON_S{-1,  false};
-            button_map["LEFT"]  = BUTTON_S{-1,  false};
-            button_map["RIGHT"] = BUTTON_S{-1,  false};
-            button_map["DOWN"]  = BUTTON_S{-1,  false};
+            bindings = PS4_BINDINGS;
+            bindingCount = count(PS4_BINDINGS);
             break;
         case LAYOUT::XB360:
         case LAYOUT::XB1:
-            button_map["A"]     = BUTTON_S{ 1,  false};
-            button_map["B"]     = BUTTON_S{ 2,  false};
-            button_map["Y"]     = BUTTON_S{ 3,  false};
-            button_map["X"]     = BUTTON_S{ 0,  false};
-            button_map["UP"]    = BUTTON_S{-1,  false};
-            button_map["LEFT"]  = BUTTON_S{-1,  false};
-            button_map["RIGHT"] = BUTTON_S{-1,  false};
-            button_map["DOWN"]  = BUTTON_S{-1,  false};
-            break;
         case LAYOUT::GENERIC:
         default:
+            bindings = XBOX_BINDINGS;
+            bindingCount = count(XBOX_BINDINGS);
             break;
     };
 }
 
+void Gamepad::makeEvents()
+{
+    for(int a = 0; a < Input::ACTION_COUNT; a++){
+        for(int t = GamepadEvent::PRESSED; t <= GamepadEvent::RELEASED; t++){
+            auto event = std::make_shared<GamepadEvent>();
+            event->action = Input::ACTION(a);
+            event->type = GamepadEvent::TYPE(t);
+            event->index = controllerIndex;
+            edges[a][t] = event;
+        }
+    }
+}
+
 Gamepad::LAYOUT Gamepad::guessLayout()
 {
     // If no index for this gamepad, fail soft(?)
@@ -81,98 +136,82 @@ Gamepad::LAYOUT Gamepad::guessLayout()
     }
 }
 
-void Gamepad::update()
-{
-    if(this->layout == LAYOUT::KEYBOARD){
-        for (auto it = kbutton_map.begin(); it != kbutton_map.end(); it++)
-        {
-            std::string button = it->first;
-            bool isPressed = sf::Keyboard::isKeyPressed(it->second.button);
-
-            bool wasPressed = it->second.isDown; 
-            if( isPressed && !wasPressed ) // If button pressed, but not already pressed
-            {
-                // Send button pressed event
-                auto event = std::make_shared<GamepadEvent>();
-                event->button = button;
-                event->type = GamepadEvent::TYPE::PRESSED;
-                event->index = controllerIndex;
-                Events::queueEvent("gamepad_event", event);
-                it->second.isDown = true;
-            }
-            else if(!isPressed && wasPressed)
-            {
-                // Send button released event
-                auto event = std::make_shared<GamepadEvent>();
-                event->button = button;
-                event->type = GamepadEvent::TYPE::RELEASED;
-                event->index = controllerIndex;
-                Events::queueEvent("gamepad_event", event);
-                it->second.isDown = false;
-            }
-            else if(!isPressed)
-            {
-                it->second.isDown = false;
+void Gamepad::poll(const Input::Response& stick, double time)
+{
+    polled = sample(stick, polledMove);
+    polledAt = time;
+}
+
+int Gamepad::update()
+{
+    return apply(polled, polledMove, polledAt);
+}
+
+Input::Actions Gamepad::sample(const Input::Response& stick, sf::Vector2f& move)
+{
+    Input::Actions held;
+    bool readable = true;
+    // every axis read once, whichever bindings look at it
+    float axes[sf::Joystick::AxisCount] = {};
+    if(this->layout != LAYOUT::KEYBOARD){
+        if(!sf::Joystick::isConnected(controllerIndex)){
+            if(this->isConnected()){
+                std::cout << "CONTROLLER DISCONNECTED" << std::endl;
+                this->isConnected_b = false;
             }
+            // whatever was held comes up
+            readable = false;
         }
-    }
-    else if(!sf::Joystick::isConnected(controllerIndex)){
-        if(this->isConnected()){
-            std::cout << "CONTROLLER DISCONNECTED" << std::endl;
-            this->isConnected_b = false;
-        }
-    }
-    else{
-        if(!this->isConnected()){
+        else if(!this->isConnected()){
             this->isConnected_b = true;
             std::cout << "CONTROLLER CONNECTED AT INDEX " << controllerIndex << std::endl;
         }
-        // SFML treats the d-pad as an axis for some reason....
-        float povx = sf::Joystick::getAxisPosition(controllerIndex, sf::Joystick::PovX);
-        float povy = sf::Joystick::getAxisPosition(controllerIndex, sf::Joystick::PovY);
-
-        for (auto it = button_map.begin(); it != button_map.end(); it++)
-        {
-            std::string button = it->first;
-            bool isPressed = false;
-            // Special cases for up, down, left, and right
-            if( (button == "UP" && povy == -100)     || 
-                (button == "DOWN" && povy == 100)    ||
-                (button == "LEFT" && povx == -100)   || 
-                (button == "RIGHT" && povx == 100)  
-            )
-                isPressed = true;
-            else{
-                if(it->second.button >= 0)
-                    isPressed = sf::Joystick::isButtonPressed(controllerIndex, it->second.button);
-            }
-            bool wasPressed = it->second.isDown; 
-            if( isPressed && !wasPressed ) // If button pressed, but not already pressed
-            {
-                // Send button pressed event
-                auto event = std::make_shared<GamepadEvent>();
-                event->button = button;
-                event->type = GamepadEvent::TYPE::PRESSED;
-                event->index = controllerIndex;
-                Events::queueEvent("gamepad_event", event);
-                it->second.isDown = true;
-            }
-            else if(!isPressed && wasPressed)
-            {
-                // Send button released event
-                auto event = std::make_shared<GamepadEvent>();
-                event->button = button;
-                event->type = GamepadEvent::TYPE::RELEASED;
-                event->index = controllerIndex;
-                Events::queueEvent("gamepad_event", event);
-                it->second.isDown = false;
-            }
-            else if(!isPressed)
-            {
-                it->second.isDown = false;
-            }
+        for(int a = 0; readable && a < sf::Joystick::AxisCount; a++)
+            axes[a] = sf::Joystick::getAxisPosition(controllerIndex, sf::Joystick::Axis(a));
+    }
+    for(std::size_t i = 0; readable && i < bindingCount; i++){
+        const Input::Binding& b = bindings[i];
+        bool down = false;
+        switch(b.source){
+            case Input::Binding::KEY:
+                down = sf::Keyboard::isKeyPressed(sf::Keyboard::Key(b.code));
+                break;
+            case Input::Binding::BUTTON:
+                down = sf::Joystick::isButtonPressed(controllerIndex, b.code);
+                break;
+            case Input::Binding::AXIS:
+                down = axes[b.code] * b.side >= AXIS_HELD;
+                break;
         }
+        if(down)
+            held.set(b.action);
+    }
+    // the stick when it's off centre, whole steps from the d-pad otherwise
+    move = stick.apply(sf::Vector2f(axes[STICK_X], axes[STICK_Y]));
+    if(move == sf::Vector2f()){
+        move.x = float(held[Input::RIGHT]) - float(held[Input::LEFT]);
+        move.y = float(held[Input::DOWN]) - float(held[Input::UP]);
     }
+    return held;
+}
+
+int Gamepad::apply(const Input::Actions& held, sf::Vector2f move, double time)
+{
+    state.advance(held);
+    state.sampledAt = time;
+    state.move = move;
+    if(state.pressed.none() && state.released.none())
+        return 0;
+    // the queue is emptied every tick, so an event is never queued twice
+    for(int a = 0; a < Input::ACTION_COUNT; a++){
+        for(int t = GamepadEvent::PRESSED; t <= GamepadEvent::RELEASED; t++){
+            if(!(t == GamepadEvent::PRESSED ? state.pressed[a] : state.released[a]))
+                continue;
+            edges[a][t]->time = state.sampledAt;
+            Events::queueEvent("gamepad_event", edges[a][t]);
+        }
+    }
+    return static_cast<int>(state.pressed.count() + state.released.count());
 }
 
 int GamepadController::addGamepads()
@@ -206,11 +245,62 @@ void GamepadController::removeGamepad(int id)
     
 }
 
-void GamepadController::update()
+const Input::State& GamepadController::getState(int index) const
+{
+    static const Input::State nothing;
+    auto it = gamepads.find(index);
+    return it == gamepads.end() ? nothing : it->second.getState();
+}
+
+Input::Actions GamepadController::sample(int index, sf::Vector2f& move)
+{
+    move = sf::Vector2f();
+    auto it = gamepads.find(index);
+    if(it == gamepads.end())
+        return Input::Actions();
+    move = it->second.polledMove;
+    return it->second.polled;
+}
+
+int GamepadController::feed(int index, const Input::Actions& held, sf::Vector2f move, double time)
+{
+    auto it = gamepads.find(index);
+    if(it == gamepads.end()){
+        it = gamepads.insert(std::make_pair(index, Gamepad())).first;
+        it->second.setIndex(index);
+    }
+    it->second.fed = true;
+    return it->second.apply(held, move, time);
+}
+
+bool GamepadController::getCommand(sf::Keyboard::Key key, Input::COMMAND& command)
+{
+    for(std::size_t i = 0; i < sizeof(COMMAND_BINDINGS) / sizeof(COMMAND_BINDINGS[0]); i++){
+        if(COMMAND_BINDINGS[i].key == key){
+            command = COMMAND_BINDINGS[i].command;
+            return true;
+        }
+    }
+    return false;
+}
+
+void GamepadController::poll()
+{
+    // fed ones too: in netplay ours is sent (sample()) then fed back
+    double now = Input::now();
+    for(auto it = gamepads.begin(); it != gamepads.end(); it++)
+        it->second.poll(stick, now);
+}
+
+int GamepadController::update()
 {
+    int edges = 0;
     // try to determine disconnects and connects
     // update controller
     for(auto it = gamepads.begin(); it != gamepads.end(); it++){
-        (*it).second.update();
+        if((*it).second.fed)
+            continue;
+        edges += (*it).second.update();
     }
+    return edges;
 }
\ No newline at end of file
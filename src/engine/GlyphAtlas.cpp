@@ -0,0 +1,142 @@
+#include "engine/GlyphAtlas.hpp"
+#include "engine/ResourceManager.hpp"
+#include <algorithm>
+#include <iostream>
+
+std::map<std::string, std::unique_ptr<GlyphAtlas>> GlyphAtlas::atlases;
+
+GlyphAtlas& GlyphAtlas::get(const std::string& font, unsigned int size, bool bold)
+{
+    std::string key = font + "@" + std::to_string(size) + (bold ? "b" : "");
+    auto it = atlases.find(key);
+    if(it != atlases.end())
+        return *it->second;
+    std::unique_ptr<GlyphAtlas> atlas(new GlyphAtlas(ResourceManager::getFont(font), size, bold));
+    GlyphAtlas& ref = *atlas;
+    atlases[key] = std::move(atlas);
+    return ref;
+}
+
+GlyphAtlas::GlyphAtlas(const sf::Font* font, unsigned int size, bool bold)
+    : font(font), size(size), bold(bold)
+{
+    // asking for a glyph renders it into the font's page for this size
+    for(sf::Uint32 c = 32; c < 127; c++)
+        font->getGlyph(c, size, bold);
+    std::cout << "Glyph atlas " << size << (bold ? " bold" : "") << ": "
+              << getTexture().getSize().x << "x" << getTexture().getSize().y << std::endl;
+}
+
+const sf::Texture& GlyphAtlas::getTexture() const
+{
+    return font->getTexture(size);
+}
+
+void GlyphAtlas::prepare(const std::string& str)
+{
+    lookup(str);
+}
+
+sf::FloatRect GlyphAtlas::measure(const std::string& str)
+{
+    return lookup(str).bounds;
+}
+
+sf::FloatRect GlyphAtlas::shape(const std::string& str, sf::Vector2f position, sf::Color color,
+                                sf::VertexArray& out)
+{
+    const Shaped& s = lookup(str);
+    for(auto it = s.quads.begin(); it != s.quads.end(); it++)
+        out.append(sf::Vertex(it->position + position, color, it->texCoords));
+    return sf::FloatRect(s.bounds.left + position.x, s.bounds.top + position.y,
+                         s.bounds.width, s.bounds.height);
+}
+
+void GlyphAtlas::fill(sf::FloatRect rect, sf::Color color, sf::VertexArray& out) const
+{
+    // every page starts with a 2x2 white square (sf::Text underlines use it)
+    sf::Vector2f white(1, 1);
+    out.append(sf::Vertex(sf::Vector2f(rect.left, rect.top), color, white));
+    out.append(sf::Vertex(sf::Vector2f(rect.left + rect.width, rect.top), color, white));
+    out.append(sf::Vertex(sf::Vector2f(rect.left + rect.width, rect.top + rect.height), color, white));
+    out.append(sf::Vertex(sf::Vector2f(rect.left, rect.top + rect.height), color, white));
+}
+
+// Same layout as sf::Text (no outline, italics or extra spacing)
+const GlyphAtlas::Shaped& GlyphAtlas::lookup(const std::string& str)
+{
+    auto found = shaped.find(str);
+    if(found != shaped.end())
+        return found->second;
+
+    Shaped& s = shaped[str];
+    if(str.empty())
+        return s;
+    float whitespace = font->getGlyph(' ', size, bold).advance;
+    float lineSpacing = font->getLineSpacing(size);
+    float padding = 1;
+    float x = 0;
+    float y = static_cast<float>(size);
+    float minX = size, minY = size, maxX = 0, maxY = 0;
+    sf::Uint32 prev = 0;
+    for(std::size_t i = 0; i < str.size(); i++){
+        sf::Uint32 c = static_cast<unsigned char>(str[i]);
+        if(c == '\r')
+            continue;
+        x += font->getKerning(prev, c, size);
+        prev = c;
+        if(c == ' ' || c == '\t' || c == '\n'){
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+            if(c == ' ')
+                x += whitespace;
+            else if(c == '\t')
+                x += whitespace * 4;
+            else{
+                y += lineSpacing;
+                x = 0;
+            }
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+            continue;
+        }
+        const sf::Glyph& g = font->getGlyph(c, size, bold);
+        float left = x + g.bounds.left;
+        float top = y + g.bounds.top;
+        float right = left + g.bounds.width;
+        float bottom = top + g.bounds.height;
+        float u1 = g.textureRect.left - padding;
+        float v1 = g.textureRect.top - padding;
+        float u2 = g.textureRect.left + g.textureRect.width + padding;
+        float v2 = g.textureRect.top + g.textureRect.height + padding;
+        s.quads.push_back(sf::Vertex(sf::Vector2f(left - padding, top - padding), sf::Vector2f(u1, v1)));
+        s.quads.push_back(sf::Vertex(sf::Vector2f(right + padding, top - padding), sf::Vector2f(u2, v1)));
+        s.quads.push_back(sf::Vertex(sf::Vector2f(right + padding, bottom + padding), sf::Vector2f(u2, v2)));
+        s.quads.push_back(sf::Vertex(sf::Vector2f(left - padding, bottom + padding), sf::Vector2f(u1, v2)));
+        minX = std::min(minX, left);
+        maxX = std::max(maxX, right);
+        minY = std::min(minY, top);
+        maxY = std::max(maxY, bottom);
+        x += g.advance;
+    }
+    s.bounds = sf::FloatRect(minX, minY, maxX - minX, maxY - minY);
+    return s;
+}
+
+void ShapedText::rebuild()
+{
+    quads.clear();
+    quads.setPrimitiveType(sf::Quads);
+    bounds = sf::FloatRect();
+    if(atlas)
+        bounds = atlas->shape(str, sf::Vector2f(), color, quads);
+}
+
+void ShapedText::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    if(!atlas)
+        return;
+    states.transform *= getTransform();
+    states.texture = &atlas->getTexture();
+    target.draw(quads, states);
+}
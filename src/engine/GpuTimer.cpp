@@ -0,0 +1,109 @@
+#include "engine/GpuTimer.hpp"
+#include <SFML/OpenGL.hpp>
+#include <SFML/Window.hpp>
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+namespace
+{
+    const GLenum TIME_ELAPSED = 0x88BF;
+    const GLenum QUERY_RESULT = 0x8866;
+    const GLenum QUERY_RESULT_AVAILABLE = 0x8867;
+
+    typedef void (APIENTRY *GenQueries)(GLsizei, GLuint*);
+    typedef void (APIENTRY *DeleteQueries)(GLsizei, const GLuint*);
+    typedef void (APIENTRY *BeginQuery)(GLenum, GLuint);
+    typedef void (APIENTRY *EndQuery)(GLenum);
+    typedef void (APIENTRY *GetQueryObjectuiv)(GLuint, GLenum, GLuint*);
+
+    struct Functions
+    {
+        GenQueries genQueries = NULL;
+        DeleteQueries deleteQueries = NULL;
+        BeginQuery beginQuery = NULL;
+        EndQuery endQuery = NULL;
+        GetQueryObjectuiv getQueryObjectuiv = NULL;
+        bool loaded = false;
+        bool available = false;
+    };
+
+    // Looked up the first time a context is active (SFML shares function
+    // pointers between its contexts)
+    Functions& gl()
+    {
+        static Functions f;
+        if(!f.loaded){
+            f.loaded = true;
+            f.genQueries = reinterpret_cast<GenQueries>(sf::Context::getFunction("glGenQueries"));
+            f.deleteQueries = reinterpret_cast<DeleteQueries>(sf::Context::getFunction("glDeleteQueries"));
+            f.beginQuery = reinterpret_cast<BeginQuery>(sf::Context::getFunction("glBeginQuery"));
+            f.endQuery = reinterpret_cast<EndQuery>(sf::Context::getFunction("glEndQuery"));
+            f.getQueryObjectuiv = reinterpret_cast<GetQueryObjectuiv>(sf::Context::getFunction("glGetQueryObjectuiv"));
+            f.available = f.genQueries && f.deleteQueries && f.beginQuery && f.endQuery && f.getQueryObjectuiv &&
+                          (sf::Context::isExtensionAvailable("GL_ARB_timer_query") ||
+                           sf::Context::isExtensionAvailable("GL_EXT_timer_query"));
+        }
+        return f;
+    }
+}
+
+GpuTimer::~GpuTimer()
+{
+    if(queries[0] && gl().available)
+        gl().deleteQueries(2, queries);
+}
+
+bool GpuTimer::isAvailable()
+{
+    return gl().available;
+}
+
+void GpuTimer::begin()
+{
+    if(!gl().available || running)
+        return;
+    if(!queries[0])
+        gl().genQueries(2, queries);
+    poll();
+    // both queries still in flight, skip this measurement
+    if(pending[current])
+        return;
+    gl().beginQuery(TIME_ELAPSED, queries[current]);
+    running = true;
+}
+
+void GpuTimer::end()
+{
+    if(!running)
+        return;
+    gl().endQuery(TIME_ELAPSED);
+    pending[current] = true;
+    current = 1 - current;
+    running = false;
+}
+
+float GpuTimer::getMilliseconds()
+{
+    if(gl().available && queries[0] && !running)
+        poll();
+    return last;
+}
+
+void GpuTimer::poll()
+{
+    // oldest first, so last ends up as the newest result
+    for(int i = 0, q = current; i < 2; i++, q = 1 - q){
+        if(!pending[q])
+            continue;
+        GLuint ready = 0;
+        gl().getQueryObjectuiv(queries[q], QUERY_RESULT_AVAILABLE, &ready);
+        if(!ready)
+            continue;
+        GLuint ns = 0;
+        gl().getQueryObjectuiv(queries[q], QUERY_RESULT, &ns);
+        last = ns / 1000000.0f;
+        pending[q] = false;
+    }
+}
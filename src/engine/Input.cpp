@@ -0,0 +1,37 @@
+#include "engine/Input.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+const char* Input::getActionName(ACTION a)
+{
+    switch(a){
+        case UP:      return "UP";
+        case DOWN:    return "DOWN";
+        case LEFT:    return "LEFT";
+        case RIGHT:   return "RIGHT";
+        case USE:     return "USE";
+        case ATTACK:  return "ATTACK";
+        case RUN:     return "RUN";
+        case GIVE_UP: return "GIVE_UP";
+        case START:   return "START";
+        case ACTION_COUNT: break;
+    }
+    return "?";
+}
+
+double Input::now()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+sf::Vector2f Input::Response::apply(sf::Vector2f raw) const
+{
+    sf::Vector2f v = raw / 100.0f;
+    float length = std::sqrt(v.x * v.x + v.y * v.y);
+    if(length <= deadZone || length == 0)
+        return sf::Vector2f();
+    // rescale what's left of the throw to 0..1 so movement starts from zero
+    float t = std::min(1.0f, (length - deadZone) / std::max(0.001f, outerZone - deadZone));
+    return v * (std::pow(t, exponent) / length);
+}
@@ -1,5 +1,16 @@
 #include "engine/Interpolate.hpp"
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    const float PI = 3.14159265f;
+}
+
 interpolate::interpolate()
 {
 
@@ -93,7 +104,8 @@ float interpolate::quinticEaseInOut(float t, float b, float c, float d)
     if ((t/=d/2) < 1)
         return c/2*t*t*t*t*t + b;
 
-	return 1-(c/2*((t-=2)*(t*t*t*t) + 2)) + b;
+	t -= 2;
+	return 1-(c/2*(t*(t*t*t*t) + 2)) + b;
 }
 
 float interpolate::quadraticEaseIn(float t, float b, float c, float d)
@@ -111,7 +123,8 @@ float interpolate::quadraticEaseInOut(float t, float b, float c, float d)
     if ((t/=d/2) < 1)
         return ((c/2)*(t*t)) + b;
 
-	return 1-(-c/2 * (((--t)*(t-2)) - 1)) + b;
+	--t;
+	return 1-(-c/2 * ((t*(t-2)) - 1)) + b;
 }
 
 float interpolate::sineEaseIn(float t, float b, float c, float d)
@@ -147,7 +160,8 @@ float interpolate::circularEaseInOut(float t, float b, float c, float d)
     if ((t/=d/2) < 1)
         return -c/2 * (sqrt(1 - t*t) - 1) + b;
 
-	return 1-(c/2 * (sqrt(1 - t*(t-=2)) + 1)) + b;
+	t -= 2;
+	return 1-(c/2 * (sqrt(1 - t*t) + 1)) + b;
 }
 
 float interpolate::backEaseIn(float t, float b, float c, float d)
@@ -215,4 +229,223 @@ float interpolate::elasticEaseInOut(float t, float b, float c, float d)
     }
     float postFix =  a*pow(2,-10*(t-=1));
     return 1-(postFix * sin( (t*d-s)*(2*PI)/p )*.5f + c + b);
-}
\ No newline at end of file
+}
+/////////////////////////////////
+// Batched easing
+//
+// Each kernel below is the scalar function above written once as a template
+// so it can run on a whole register of tweens (Lanes) or on a single float
+// for the tail. Branches become a select between both sides.
+/////////////////////////////////
+namespace
+{
+#if defined(__AVX__)
+    struct Lanes
+    {
+        static const int WIDTH = 8;
+        __m256 v;
+        Lanes(__m256 v) : v(v) {};
+        Lanes(float f) : v(_mm256_set1_ps(f)) {};
+        static Lanes load(const float* p) { return _mm256_loadu_ps(p); };
+        void store(float* p) const { _mm256_storeu_ps(p, v); };
+    };
+    inline Lanes operator+(Lanes a, Lanes b) { return _mm256_add_ps(a.v, b.v); }
+    inline Lanes operator-(Lanes a, Lanes b) { return _mm256_sub_ps(a.v, b.v); }
+    inline Lanes operator*(Lanes a, Lanes b) { return _mm256_mul_ps(a.v, b.v); }
+    inline Lanes operator/(Lanes a, Lanes b) { return _mm256_div_ps(a.v, b.v); }
+    inline Lanes operator-(Lanes a) { return _mm256_xor_ps(a.v, _mm256_set1_ps(-0.0f)); }
+    inline Lanes root(Lanes a) { return _mm256_sqrt_ps(a.v); }
+    // mask of a < b
+    inline Lanes less(Lanes a, Lanes b) { return _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ); }
+    inline Lanes select(Lanes mask, Lanes a, Lanes b) { return _mm256_blendv_ps(b.v, a.v, mask.v); }
+#define INTERPOLATE_SIMD
+#elif defined(__SSE2__)
+    struct Lanes
+    {
+        static const int WIDTH = 4;
+        __m128 v;
+        Lanes(__m128 v) : v(v) {};
+        Lanes(float f) : v(_mm_set1_ps(f)) {};
+        static Lanes load(const float* p) { return _mm_loadu_ps(p); };
+        void store(float* p) const { _mm_storeu_ps(p, v); };
+    };
+    inline Lanes operator+(Lanes a, Lanes b) { return _mm_add_ps(a.v, b.v); }
+    inline Lanes operator-(Lanes a, Lanes b) { return _mm_sub_ps(a.v, b.v); }
+    inline Lanes operator*(Lanes a, Lanes b) { return _mm_mul_ps(a.v, b.v); }
+    inline Lanes operator/(Lanes a, Lanes b) { return _mm_div_ps(a.v, b.v); }
+    inline Lanes operator-(Lanes a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+    inline Lanes root(Lanes a) { return _mm_sqrt_ps(a.v); }
+    inline Lanes less(Lanes a, Lanes b) { return _mm_cmplt_ps(a.v, b.v); }
+    inline Lanes select(Lanes mask, Lanes a, Lanes b)
+    {
+        // no blendv before SSE4.1
+        return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v));
+    }
+#define INTERPOLATE_SIMD
+#endif
+
+    // Scalar versions of the helpers, used for the tail of a batch
+    inline float root(float a) { return sqrt(a); }
+    inline bool less(float a, float b) { return a < b; }
+    inline float select(bool mask, float a, float b) { return mask ? a : b; }
+
+    const float BACK = 1.70158f;
+
+    struct Linear {
+        template<class V> static V run(V t, V b, V c, V d) { return c * (t/d) + b; }
+    };
+    struct QuarticIn {
+        template<class V> static V run(V t, V b, V c, V d) { t = t/d; return c*t*t*t*t + b; }
+    };
+    struct QuarticOut {
+        template<class V> static V run(V t, V b, V c, V d) { t = t/d - V(1); return -c * (V(1) - t*t*t*t - V(1)) + b; }
+    };
+    struct QuarticInOut {
+        template<class V> static V run(V t, V b, V c, V d)
+        {
+            t = t / (d/V(2));
+            V u = t - V(2);
+            return select(less(t, V(1)), c/V(2)*t*t*t*t + b, V(1) - (-c/V(2) * (u*u*u*u - V(2))) + b);
+        }
+    };
+    struct QuinticIn {
+        template<class V> static V run(V t, V b, V c, V d) { t = t/d; return c*t*t*t*t*t + b; }
+    };
+    struct QuinticOut {
+        template<class V> static V run(V t, V b, V c, V d) { t = t/d - V(1); return c*t*(V(1) - (t*t*t*t + V(1))) + b; }
+    };
+    struct QuinticInOut {
+        template<class V> static V run(V t, V b, V c, V d)
+        {
+            t = t / (d/V(2));
+            V u = t - V(2);
+            return select(less(t, V(1)), c/V(2)*t*t*t*t*t + b, V(1) - (c/V(2)*(u*(u*u*u*u) + V(2))) + b);
+        }
+    };
+    struct QuadraticIn {
+        template<class V> static V run(V t, V b, V c, V d) { t = t/d; return c*t*t + b; }
+    };
+    struct QuadraticOut {
+        template<class V> static V run(V t, V b, V c, V d) { t = t/d; return V(1) - (-c*t*(t - V(2))) + b; }
+    };
+    struct QuadraticInOut {
+        template<class V> static V run(V t, V b, V c, V d)
+        {
+            t = t / (d/V(2));
+            V u = t - V(1);
+            return select(less(t, V(1)), ((c/V(2))*(t*t)) + b, V(1) - (-c/V(2) * ((u*(u - V(2))) - V(1))) + b);
+        }
+    };
+    struct CircularIn {
+        template<class V> static V run(V t, V b, V c, V d) { t = t/d; return -c * (root(V(1) - t*t) - V(1)) + b; }
+    };
+    struct CircularOut {
+        template<class V> static V run(V t, V b, V c, V d) { t = t/d - V(1); return V(1) - (c * root(V(1) - (t*t))) + b; }
+    };
+    struct CircularInOut {
+        template<class V> static V run(V t, V b, V c, V d)
+        {
+            t = t / (d/V(2));
+            V u = t - V(2);
+            return select(less(t, V(1)), -c/V(2) * (root(V(1) - t*t) - V(1)) + b,
+                                         V(1) - (c/V(2) * (root(V(1) - u*u) + V(1))) + b);
+        }
+    };
+    struct BackIn {
+        template<class V> static V run(V t, V b, V c, V d) { t = t/d; return c*t*t*(V(BACK + 1)*t - V(BACK)) + b; }
+    };
+    struct BackOut {
+        template<class V> static V run(V t, V b, V c, V d)
+        {
+            t = t/d - V(1);
+            return V(1) - (c*(t*t*(V(BACK + 1)*t + V(BACK)) + V(1))) + b;
+        }
+    };
+    struct BackInOut {
+        template<class V> static V run(V t, V b, V c, V d)
+        {
+            const float s = BACK * 1.525f;
+            t = t / (d/V(2));
+            V u = t - V(2);
+            return select(less(t, V(1)), c/V(2)*(t*t*(V(s + 1)*t - V(s))) + b,
+                                         V(1) - (c/V(2)*(u*u*(V(s + 1)*u + V(s)) + V(2))) + b);
+        }
+    };
+
+    template<class K> void batch(const float* t, const float* b, const float* c,
+                                 const float* d, float* out, std::size_t n)
+    {
+        std::size_t i = 0;
+#ifdef INTERPOLATE_SIMD
+        for(; i + Lanes::WIDTH <= n; i += Lanes::WIDTH)
+            K::run(Lanes::load(t + i), Lanes::load(b + i), Lanes::load(c + i), Lanes::load(d + i)).store(out + i);
+#endif
+        for(; i < n; i++)
+            out[i] = K::run(t[i], b[i], c[i], d[i]);
+    }
+
+    void scalar(interpolate::Function f, const float* t, const float* b, const float* c,
+                const float* d, float* out, std::size_t n)
+    {
+        for(std::size_t i = 0; i < n; i++)
+            out[i] = f(t[i], b[i], c[i], d[i]);
+    }
+}
+
+interpolate::Function interpolate::function(EASE curve)
+{
+    static const Function functions[EASE_COUNT] = {
+        linear,
+        expoEaseIn, expoEaseOut, expoEaseInOut,
+        cubicEaseIn, cubicEaseOut, cubicEaseInOut,
+        quarticEaseIn, quarticEaseOut, quarticEaseInOut,
+        quinticEaseIn, quinticEaseOut, quinticEaseInOut,
+        quadraticEaseIn, quadraticEaseOut, quadraticEaseInOut,
+        sineEaseIn, sineEaseOut, sineEaseInOut,
+        circularEaseIn, circularEaseOut, circularEaseInOut,
+        backEaseIn, backEaseOut, backEaseInOut,
+        elasticEaseIn, elasticEaseOut, elasticEaseInOut
+    };
+    return functions[curve];
+}
+
+void interpolate::ease(EASE curve, const float* t, const float* b, const float* c,
+                       const float* d, float* out, std::size_t n)
+{
+    switch(curve){
+        case LINEAR:            batch<Linear>(t, b, c, d, out, n); break;
+        case QUARTIC_IN:        batch<QuarticIn>(t, b, c, d, out, n); break;
+        case QUARTIC_OUT:       batch<QuarticOut>(t, b, c, d, out, n); break;
+        case QUARTIC_IN_OUT:    batch<QuarticInOut>(t, b, c, d, out, n); break;
+        case QUINTIC_IN:        batch<QuinticIn>(t, b, c, d, out, n); break;
+        case QUINTIC_OUT:       batch<QuinticOut>(t, b, c, d, out, n); break;
+        case QUINTIC_IN_OUT:    batch<QuinticInOut>(t, b, c, d, out, n); break;
+        case QUADRATIC_IN:      batch<QuadraticIn>(t, b, c, d, out, n); break;
+        case QUADRATIC_OUT:     batch<QuadraticOut>(t, b, c, d, out, n); break;
+        case QUADRATIC_IN_OUT:  batch<QuadraticInOut>(t, b, c, d, out, n); break;
+        case CIRCULAR_IN:       batch<CircularIn>(t, b, c, d, out, n); break;
+        case CIRCULAR_OUT:      batch<CircularOut>(t, b, c, d, out, n); break;
+        case CIRCULAR_IN_OUT:   batch<CircularInOut>(t, b, c, d, out, n); break;
+        case BACK_IN:           batch<BackIn>(t, b, c, d, out, n); break;
+        case BACK_OUT:          batch<BackOut>(t, b, c, d, out, n); break;
+        case BACK_IN_OUT:       batch<BackInOut>(t, b, c, d, out, n); break;
+        default:                scalar(function(curve), t, b, c, d, out, n); break;
+    }
+}
+
+bool interpolate::isVectorized(EASE curve)
+{
+#ifdef INTERPOLATE_SIMD
+    switch(curve){
+        case EXPO_IN: case EXPO_OUT: case EXPO_IN_OUT:
+        case CUBIC_IN: case CUBIC_OUT: case CUBIC_IN_OUT:
+        case SINE_IN: case SINE_OUT: case SINE_IN_OUT:
+        case ELASTIC_IN: case ELASTIC_OUT: case ELASTIC_IN_OUT:
+            return false;
+        default:
+            return curve < EASE_COUNT;
+    }
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,386 @@
+#include "engine/ItemDatabase.hpp"
+#include "rapidxml/rapidxml.hpp"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ITEM_DATABASE_MMAP
+#endif
+
+using namespace rapidxml;
+
+std::map<std::string, std::shared_ptr<ItemDatabase>> ItemDatabase::cache;
+
+namespace
+{
+    const char* EMPTY = "";
+    const char* TIER_NAMES[ItemDatabase::TIER_COUNT] = {"high", "low"};
+    const char* CLUE_NAMES[ItemDatabase::CLUE_COUNT] = {"jackpot", "specific", "vague", "worthless"};
+    const std::vector<int> NO_ITEMS;
+    const std::vector<const char*> NO_INFO;
+
+    ItemRecord blankRecord()
+    {
+        ItemRecord r;
+        r.name = EMPTY;
+        r.type = EMPTY;
+        for(int i = 0; i < ItemDatabase::CLUE_COUNT; i++)
+            r.clues[i] = EMPTY;
+        return r;
+    }
+
+    const char* childValue(xml_node<>* parent, const char* name)
+    {
+        xml_node<>* child = parent ? parent->first_node(name) : NULL;
+        return child ? child->value() : EMPTY;
+    }
+
+    // Just enough JSON to read items.json. Strings are unescaped and
+    // terminated in place, so the returned pointers live in the file buffer.
+    class JsonReader
+    {
+    public:
+        JsonReader(char* begin, char* end) : p(begin), end(end) {};
+        bool failed = false;
+
+        char peek()
+        {
+            while(p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+                p++;
+            return p < end ? *p : '\0';
+        }
+        bool consume(char c)
+        {
+            if(peek() != c)
+                return fail();
+            p++;
+            return true;
+        }
+        char* string()
+        {
+            if(!consume('"'))
+                return NULL;
+            char* out = p;
+            char* w = p;
+            while(p < end && *p != '"'){
+                char c = *p++;
+                if(c == '\\'){
+                    if(p >= end)
+                        return failString();
+                    switch(*p++){
+                        case '"':  c = '"';  break;
+                        case '\\': c = '\\'; break;
+                        case '/':  c = '/';  break;
+                        case 'b':  c = '\b'; break;
+                        case 'f':  c = '\f'; break;
+                        case 'n':  c = '\n'; break;
+                        case 'r':  c = '\r'; break;
+                        case 't':  c = '\t'; break;
+                        case 'u': {
+                            unsigned long cp;
+                            if(!hex4(cp))
+                                return failString();
+                            // surrogate pair
+                            if(cp >= 0xD800 && cp < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u'){
+                                p += 2;
+                                unsigned long low;
+                                if(!hex4(low))
+                                    return failString();
+                                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                            }
+                            w = utf8(w, cp);
+                            continue;
+                        }
+                        default:
+                            return failString();
+                    }
+                }
+                *w++ = c;
+            }
+            if(p >= end)
+                return failString();
+            p++;
+            // the writer never passes the closing quote, so this is safe
+            *w = '\0';
+            return out;
+        }
+        // Calls f(key) for every member of an object; f must consume the value
+        template<class F> bool object(F f)
+        {
+            if(!consume('{'))
+                return false;
+            if(peek() == '}')
+                return consume('}');
+            do{
+                char* key = string();
+                if(!key || !consume(':'))
+                    return false;
+                f(key);
+                if(failed)
+                    return false;
+            }while(peek() == ',' && consume(','));
+            return consume('}');
+        }
+        // Calls f() for every element of an array; f must consume the value
+        template<class F> bool array(F f)
+        {
+            if(!consume('['))
+                return false;
+            if(peek() == ']')
+                return consume(']');
+            do{
+                f();
+                if(failed)
+                    return false;
+            }while(peek() == ',' && consume(','));
+            return consume(']');
+        }
+        void skipValue()
+        {
+            switch(peek()){
+                case '"': string(); break;
+                case '{': object([this](char*){ skipValue(); }); break;
+                case '[': array([this](){ skipValue(); }); break;
+                case '\0': fail(); break;
+                default:
+                    // numbers, true, false, null
+                    while(p < end && !strchr(",}] \t\n\r", *p))
+                        p++;
+            }
+        }
+    private:
+        char* p;
+        char* end;
+        bool fail(){ failed = true; return false; }
+        char* failString(){ failed = true; return NULL; }
+        bool hex4(unsigned long& v)
+        {
+            if(end - p < 4)
+                return false;
+            v = 0;
+            for(int i = 0; i < 4; i++, p++){
+                char c = *p;
+                v <<= 4;
+                if(c >= '0' && c <= '9')      v |= c - '0';
+                else if(c >= 'a' && c <= 'f') v |= c - 'a' + 10;
+                else if(c >= 'A' && c <= 'F') v |= c - 'A' + 10;
+                else return false;
+            }
+            return true;
+        }
+        // An escape is always at least as long as its utf-8 encoding
+        char* utf8(char* w, unsigned long cp)
+        {
+            if(cp < 0x80){
+                *w++ = cp;
+            }else if(cp < 0x800){
+                *w++ = 0xC0 | (cp >> 6);
+                *w++ = 0x80 | (cp & 0x3F);
+            }else if(cp < 0x10000){
+                *w++ = 0xE0 | (cp >> 12);
+                *w++ = 0x80 | ((cp >> 6) & 0x3F);
+                *w++ = 0x80 | (cp & 0x3F);
+            }else{
+                *w++ = 0xF0 | (cp >> 18);
+                *w++ = 0x80 | ((cp >> 12) & 0x3F);
+                *w++ = 0x80 | ((cp >> 6) & 0x3F);
+                *w++ = 0x80 | (cp & 0x3F);
+            }
+            return w;
+        }
+    };
+}
+
+ItemDatabase::~ItemDatabase()
+{
+#ifdef ITEM_DATABASE_MMAP
+    if(mapped){
+        munmap(text, length);
+        return;
+    }
+#endif
+    delete[] text;
+}
+
+std::shared_ptr<const ItemDatabase> ItemDatabase::load(std::string filename)
+{
+    auto cached = cache.find(filename);
+    if(cached != cache.end())
+        return cached->second;
+
+    std::shared_ptr<ItemDatabase> db(new ItemDatabase());
+    if(!db->mapFile(filename)){
+        std::cout << "Item database " << filename << " not found!" << std::endl;
+        return NULL;
+    }
+    bool json = filename.size() >= 5 && filename.compare(filename.size() - 5, 5, ".json") == 0;
+    if(!(json ? db->parseJSON() : db->parseXML())){
+        std::cout << "Item database " << filename << " could not be parsed!" << std::endl;
+        return NULL;
+    }
+    db->buildIndex();
+    cache[filename] = db;
+    return db;
+}
+
+bool ItemDatabase::mapFile(const std::string& filename)
+{
+#ifdef ITEM_DATABASE_MMAP
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0)
+        return false;
+    struct stat st;
+    if(fstat(fd, &st) == 0 && st.st_size > 0){
+        length = st.st_size;
+        // The rest of the last page reads as zeros, which doubles as the
+        // terminator rapidxml needs. A file that fills its last page exactly
+        // has no room for one, so that case gets read into memory below.
+        if(length % sysconf(_SC_PAGESIZE) != 0){
+            // Private mapping: parsing in place writes to our copy of the pages only
+            void* m = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+            if(m != MAP_FAILED){
+                text = static_cast<char*>(m);
+                mapped = true;
+            }
+        }
+    }
+    close(fd);
+    if(mapped)
+        return true;
+#endif
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if(!file)
+        return false;
+    length = file.tellg();
+    file.seekg(0);
+    text = new char[length + 1];
+    file.read(text, length);
+    text[length] = '\0';
+    return true;
+}
+
+bool ItemDatabase::parseXML()
+{
+    // The document only lives long enough to walk it; the strings it
+    // points at are terminated in place inside our buffer
+    xml_document<> doc;
+    try{
+        doc.parse<0>(text);
+    }catch(parse_error& e){
+        std::cout << "XML error: " << e.what() << std::endl;
+        return false;
+    }
+    xml_node<>* root = doc.first_node("items");
+    if(!root)
+        return false;
+
+    for(int t = 0; t < TIER_COUNT; t++){
+        xml_node<>* list = root->first_node(TIER_NAMES[t]);
+        if(!list)
+            continue;
+        for(xml_node<>* node = list->first_node("item"); node; node = node->next_sibling("item")){
+            ItemRecord r = blankRecord();
+            r.name = childValue(node, "name");
+            r.type = childValue(node, "type");
+            xml_node<>* clues = node->first_node("clues");
+            for(int c = 0; c < CLUE_COUNT; c++)
+                r.clues[c] = childValue(clues, CLUE_NAMES[c]);
+            items[t].push_back(r);
+        }
+    }
+
+    xml_node<>* infoNode = root->first_node("info");
+    if(infoNode){
+        for(xml_node<>* type = infoNode->first_node(); type; type = type->next_sibling()){
+            std::vector<const char*>& lines = info[type->name()];
+            for(xml_node<>* line = type->first_node(); line; line = line->next_sibling())
+                lines.push_back(line->value());
+        }
+    }
+    return true;
+}
+
+bool ItemDatabase::parseJSON()
+{
+    JsonReader json(text, text + length);
+    json.object([&](char* key){
+        int tier = -1;
+        for(int t = 0; t < TIER_COUNT; t++)
+            if(strcmp(key, TIER_NAMES[t]) == 0)
+                tier = t;
+
+        if(tier >= 0){
+            json.array([&](){
+                ItemRecord r = blankRecord();
+                json.object([&](char* field){
+                    if(strcmp(field, "name") == 0)
+                        r.name = json.string();
+                    else if(strcmp(field, "type") == 0)
+                        r.type = json.string();
+                    else if(strcmp(field, "clues") == 0){
+                        json.object([&](char* clue){
+                            for(int c = 0; c < CLUE_COUNT; c++){
+                                if(strcmp(clue, CLUE_NAMES[c]) == 0){
+                                    r.clues[c] = json.string();
+                                    return;
+                                }
+                            }
+                            json.skipValue();
+                        });
+                    }
+                    else
+                        json.skipValue();
+                });
+                if(!json.failed)
+                    items[tier].push_back(r);
+            });
+        }
+        else if(strcmp(key, "info") == 0){
+            json.object([&](char* type){
+                std::vector<const char*>& lines = info[type];
+                json.array([&](){
+                    const char* line = json.string();
+                    if(line)
+                        lines.push_back(line);
+                });
+            });
+        }
+        else
+            json.skipValue();
+    });
+    return !json.failed;
+}
+
+void ItemDatabase::buildIndex()
+{
+    for(int t = 0; t < TIER_COUNT; t++){
+        types[t].clear();
+        for(int i = 0; i < (int)items[t].size(); i++)
+            types[t][items[t][i].type].push_back(i);
+    }
+}
+
+const std::vector<int>& ItemDatabase::getItemsOfType(TIER tier, const std::string& type) const
+{
+    auto it = types[tier].find(type);
+    return it == types[tier].end() ? NO_ITEMS : it->second;
+}
+
+const std::vector<const char*>& ItemDatabase::getInfo(const std::string& type) const
+{
+    auto it = info.find(type);
+    return it == info.end() ? NO_INFO : it->second;
+}
+
+std::vector<std::string> ItemDatabase::getInfoTypes() const
+{
+    std::vector<std::string> names;
+    for(auto it = info.begin(); it != info.end(); it++)
+        names.push_back(it->first);
+    return names;
+}
@@ -0,0 +1,19 @@
+#include "engine/ItemPack.hpp"
+
+// Wraps the generated tables. The records are copied by pointer, so this is
+// a handful of small allocations and no string work at all.
+std::shared_ptr<const ItemDatabase> ItemDatabase::compiled()
+{
+    static std::shared_ptr<ItemDatabase> db;
+    if(db)
+        return db;
+    db = std::shared_ptr<ItemDatabase>(new ItemDatabase());
+    for(int t = 0; t < TIER_COUNT; t++)
+        db->items[t].assign(ItemPack::ITEMS + ItemPack::TIER_START[t], ItemPack::ITEMS + ItemPack::TIER_START[t + 1]);
+    for(int i = 0; i < ItemPack::INFO_COUNT; i++){
+        const ItemPackInfo& info = ItemPack::INFO[i];
+        db->info[info.type].assign(info.lines, info.lines + info.count);
+    }
+    db->buildIndex();
+    return db;
+}
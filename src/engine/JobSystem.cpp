@@ -0,0 +1,158 @@
+#include "engine/JobSystem.hpp"
+#include <algorithm>
+
+namespace
+{
+    // which pool this thread works for, and its deque in that pool
+    thread_local const JobSystem* currentPool = NULL;
+    thread_local unsigned int currentSlot = 0;
+}
+
+JobSystem::JobSystem()
+    : queued(0)
+{
+    queues.push_back(std::unique_ptr<Queue>(new Queue()));
+}
+
+JobSystem::~JobSystem()
+{
+    stop();
+}
+
+void JobSystem::start(unsigned int threads)
+{
+    stop();
+    if(threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    quit = false;
+    while(queues.size() < threads)
+        queues.push_back(std::unique_ptr<Queue>(new Queue()));
+    for(unsigned int i = 1; i < threads; i++)
+        workers.push_back(std::thread(&JobSystem::loop, this, i));
+}
+
+void JobSystem::stop()
+{
+    if(workers.empty())
+        return;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        quit = true;
+    }
+    wake.notify_all();
+    for(auto it = workers.begin(); it != workers.end(); it++)
+        it->join();
+    workers.clear();
+    // anything left in a worker's deque goes back to the shared one
+    for(std::size_t i = 1; i < queues.size(); i++){
+        std::deque<Task>& tasks = queues[i]->tasks;
+        queues[0]->tasks.insert(queues[0]->tasks.end(), tasks.begin(), tasks.end());
+    }
+    queues.resize(1);
+}
+
+void JobSystem::run(Group& group, Job job)
+{
+    group.pending++;
+    Queue& q = *queues[getSlot()];
+    {
+        std::lock_guard<std::mutex> lock(q.mutex);
+        Task task;
+        task.job = std::move(job);
+        task.group = &group;
+        q.tasks.push_back(std::move(task));
+        queued++;
+    }
+    if(!workers.empty()){
+        // taking the lock means a worker can't miss this between checking
+        // for work and going to sleep
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        wake.notify_one();
+    }
+}
+
+void JobSystem::wait(Group& group)
+{
+    unsigned int slot = getSlot();
+    Task task;
+    while(group.pending > 0){
+        if(take(slot, task))
+            execute(task);
+        else
+            // the rest are running elsewhere
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::parallelFor(std::size_t count, std::size_t grain,
+                            const std::function<void(std::size_t, std::size_t)>& body)
+{
+    grain = std::max<std::size_t>(1, grain);
+    Group group;
+    for(std::size_t begin = grain; begin < count; begin += grain){
+        std::size_t end = std::min(count, begin + grain);
+        run(group, [&body, begin, end](){ body(begin, end); });
+    }
+    // the first chunk is ours
+    if(count > 0)
+        body(0, std::min(count, grain));
+    wait(group);
+}
+
+unsigned int JobSystem::getSlot() const
+{
+    return currentPool == this ? currentSlot : 0;
+}
+
+bool JobSystem::take(unsigned int slot, Task& task)
+{
+    // our own work newest first, it's the most likely to still be in cache
+    {
+        Queue& q = *queues[slot];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if(!q.tasks.empty()){
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+    // then the oldest job from everyone else, which tends to be the biggest
+    for(std::size_t i = 1; i < queues.size(); i++){
+        Queue& q = *queues[(slot + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if(!q.tasks.empty()){
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::execute(Task& task)
+{
+    Group* group = task.group;
+    task.job();
+    task.job = nullptr;
+    // the group may be gone as soon as this reaches zero
+    group->pending--;
+}
+
+void JobSystem::loop(unsigned int slot)
+{
+    currentPool = this;
+    currentSlot = slot;
+    Task task;
+    while(true){
+        if(take(slot, task)){
+            execute(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this]{ return queued > 0 || quit; });
+        if(quit)
+            return;
+    }
+}
@@ -0,0 +1,128 @@
+#include "engine/LightMap.hpp"
+#include "engine/ResourceManager.hpp"
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    const unsigned int FALLOFF_SIZE = 64;
+}
+
+bool LightMap::create(unsigned int width, unsigned int height, unsigned int scale)
+{
+    this->scale = scale;
+    unsigned int w = (width + scale - 1) / scale;
+    unsigned int h = (height + scale - 1) / scale;
+    ready = map.create(w, h) && scratch.create(w, h);
+    if(!ready){
+        std::cout << "Couldn't create the " << w << "x" << h << " light map" << std::endl;
+        return false;
+    }
+    // bilinear filtering when scaled back up smooths out the low resolution
+    map.setSmooth(true);
+    scratch.setSmooth(true);
+
+    // linear falloff from the centre, the same curve the old gradient shader used
+    sf::Image image;
+    image.create(FALLOFF_SIZE, FALLOFF_SIZE, sf::Color::Black);
+    float half = FALLOFF_SIZE / 2.0f;
+    for(unsigned int y = 0; y < FALLOFF_SIZE; y++){
+        for(unsigned int x = 0; x < FALLOFF_SIZE; x++){
+            float dx = (x + 0.5f - half) / half;
+            float dy = (y + 0.5f - half) / half;
+            float light = std::max(0.0f, 1.0f - std::sqrt(dx * dx + dy * dy));
+            sf::Uint8 v = static_cast<sf::Uint8>(light * 255);
+            image.setPixel(x, y, sf::Color(v, v, v));
+        }
+    }
+    falloff.loadFromImage(image);
+    falloff.setSmooth(true);
+    quads.setPrimitiveType(sf::Quads);
+
+    blurShader = ResourceManager::getShader("../resources/shaders/VertexShader.txt", "../resources/shaders/BlurShader.txt");
+    canBlur = blurShader != NULL;
+    lightShader = ResourceManager::getShader("../resources/shaders/VertexShader.txt", "../resources/shaders/LightShader.txt");
+    return true;
+}
+
+void LightMap::clear()
+{
+    if(ready)
+        map.clear(ambient);
+    drawn = 0;
+}
+
+void LightMap::addView(const sf::View& camera, const std::vector<Light>& lights)
+{
+    if(!ready)
+        return;
+    sf::FloatRect visible(camera.getCenter() - camera.getSize() / 2.0f, camera.getSize());
+    quads.clear();
+    for(auto it = lights.begin(); it != lights.end(); it++){
+        const Light& l = *it;
+        sf::FloatRect bounds(l.position.x - l.radius, l.position.y - l.radius, 2 * l.radius, 2 * l.radius);
+        if(!bounds.intersects(visible))
+            continue;
+        float right = bounds.left + bounds.width;
+        float bottom = bounds.top + bounds.height;
+        float t = FALLOFF_SIZE;
+        quads.append(sf::Vertex(sf::Vector2f(bounds.left, bounds.top), l.color, sf::Vector2f(0, 0)));
+        quads.append(sf::Vertex(sf::Vector2f(right, bounds.top), l.color, sf::Vector2f(t, 0)));
+        quads.append(sf::Vertex(sf::Vector2f(right, bottom), l.color, sf::Vector2f(t, t)));
+        quads.append(sf::Vertex(sf::Vector2f(bounds.left, bottom), l.color, sf::Vector2f(0, t)));
+    }
+    if(quads.getVertexCount() == 0)
+        return;
+    drawn += quads.getVertexCount() / 4;
+    // the viewport is a fraction of the target, so the same view works at low res
+    map.setView(camera);
+    sf::RenderStates states(sf::BlendAdd);
+    states.texture = &falloff;
+    map.draw(quads, states);
+}
+
+void LightMap::apply(sf::RenderTarget& target, const sf::Texture& scene)
+{
+    sf::Sprite frame(scene);
+    target.setView(target.getDefaultView());
+    if(!ready){
+        target.draw(frame);
+        return;
+    }
+    map.display();
+    if(canBlur)
+        blur();
+    if(lightShader){
+        // one pass over the window instead of drawing it and multiplying
+        // over it, which costs as much again as the lights on llvmpipe
+        lightShader->setUniform("texture", sf::Shader::CurrentTexture);
+        lightShader->setUniform("lightMap", map.getTexture());
+        lightShader->setUniform("lightSize", sf::Vector2f(map.getSize() * scale));
+        target.draw(frame, lightShader);
+        return;
+    }
+    target.draw(frame);
+    sf::Sprite sprite(map.getTexture());
+    sprite.setScale(scale, scale);
+    target.draw(sprite, sf::BlendMultiply);
+}
+
+// Separable blur: horizontal into scratch, then vertical back into map
+void LightMap::blur()
+{
+    sf::Vector2u size = map.getSize();
+    sf::RenderStates states(sf::BlendNone);
+    states.shader = blurShader;
+    // every frame, since a reloaded shader starts with none set
+    blurShader->setUniform("texture", sf::Shader::CurrentTexture);
+
+    scratch.setView(scratch.getDefaultView());
+    blurShader->setUniform("offset", sf::Vector2f(1.0f / size.x, 0));
+    scratch.draw(sf::Sprite(map.getTexture()), states);
+    scratch.display();
+
+    map.setView(map.getDefaultView());
+    blurShader->setUniform("offset", sf::Vector2f(0, 1.0f / size.y));
+    map.draw(sf::Sprite(scratch.getTexture()), states);
+    map.display();
+}
@@ -0,0 +1,257 @@
+#include "engine/Lockstep.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+namespace
+{
+    // first two bytes of every packet, "HH"
+    const sf::Uint16 MAGIC = 0x4848;
+    // wrongFrom when every guess so far was right
+    const sf::Uint32 NONE = 0xffffffff;
+}
+
+const sf::Uint32 Lockstep::WINDOW;
+const int Lockstep::MAX_AHEAD;
+const sf::Uint32 Lockstep::MAX_RESEND;
+
+Lockstep::Frame Lockstep::Frame::pack(const Input::Actions& down, sf::Vector2f move)
+{
+    Frame f;
+    f.down = static_cast<sf::Uint16>(down.to_ulong());
+    f.moveX = static_cast<sf::Int8>(std::lround(std::max(-1.0f, std::min(1.0f, move.x)) * 127));
+    f.moveY = static_cast<sf::Int8>(std::lround(std::max(-1.0f, std::min(1.0f, move.y)) * 127));
+    return f;
+}
+
+Lockstep::Lockstep()
+    : wrongFrom(NONE), started(Input::now()), statsSince(started)
+{
+}
+
+bool Lockstep::open(unsigned short port, int local, int players)
+{
+    if(socket.bind(port) != sf::Socket::Done){
+        std::cout << "Lockstep: couldn't listen on port " << port << std::endl;
+        return false;
+    }
+    socket.setBlocking(false);
+    this->local = local;
+    frames.assign(players, std::vector<Frame>(WINDOW));
+    used.assign(players, std::vector<Frame>(WINDOW));
+    setInputDelay(delay);
+    std::cout << "Lockstep: player " << local << " of " << players
+              << " on port " << getPort() << std::endl;
+    return true;
+}
+
+void Lockstep::addPeer(int player, const sf::IpAddress& address, unsigned short port)
+{
+    Peer peer;
+    peer.player = player;
+    peer.address = address;
+    peer.port = port;
+    peer.acked = delay;
+    peers.push_back(peer);
+    Stats::Peer s;
+    s.player = player;
+    stats.peers.push_back(s);
+}
+
+void Lockstep::setInputDelay(int ticks)
+{
+    delay = std::max(0, ticks);
+    if(tick > 0)
+        return;
+    // nobody has input for the first ticks, so they're known to be empty
+    received.assign(frames.size(), delay);
+    for(auto it = peers.begin(); it != peers.end(); it++)
+        it->acked = delay;
+}
+
+void Lockstep::setRollback(Hook save, Restorer restore, int maxAhead)
+{
+    this->save = save;
+    this->restore = restore;
+    this->maxAhead = (save && restore) ? std::max(0, std::min(maxAhead, MAX_AHEAD)) : 0;
+}
+
+void Lockstep::submit(const Frame& frame)
+{
+    // while stalled the frame for tick + delay is already in; keep it
+    if(received[local] <= tick + delay){
+        at(local, received[local]) = frame;
+        received[local]++;
+    }
+    send();
+}
+
+void Lockstep::send()
+{
+    for(std::size_t i = 0; i < peers.size(); i++){
+        Peer& peer = peers[i];
+        sf::Uint32 first = peer.acked;
+        sf::Uint32 count = std::min(MAX_RESEND, received[local] - std::min(first, received[local]));
+        sf::Packet packet;
+        packet << MAGIC << static_cast<sf::Uint8>(local) << received[peer.player]
+               << clock() << peer.stamp << first << static_cast<sf::Uint8>(count);
+        for(sf::Uint32 t = first; t < first + count; t++){
+            const Frame& f = at(local, t);
+            packet << f.down << f.moveX << f.moveY;
+        }
+        stats.peers[i].bytesSent += packet.getDataSize();
+        stats.peers[i].packetsSent++;
+        socket.send(packet, peer.address, peer.port);
+    }
+}
+
+void Lockstep::receive()
+{
+    sf::Packet packet;
+    sf::IpAddress address;
+    unsigned short port;
+    while(socket.receive(packet, address, port) == sf::Socket::Done){
+        sf::Uint16 magic = 0;
+        sf::Uint8 player = 0;
+        sf::Uint32 ack = 0;
+        float stamp = 0;
+        float echo = 0;
+        sf::Uint32 first = 0;
+        sf::Uint8 count = 0;
+        packet >> magic >> player >> ack >> stamp >> echo >> first >> count;
+        if(!packet || magic != MAGIC)
+            continue;
+        std::size_t i = 0;
+        while(i < peers.size() && peers[i].player != player)
+            i++;
+        if(i == peers.size())
+            continue;
+        Peer& peer = peers[i];
+        Stats::Peer& s = stats.peers[i];
+        s.bytesReceived += packet.getDataSize();
+        s.packetsReceived++;
+        peer.acked = std::max(peer.acked, ack);
+        if(echo >= 0){
+            float trip = clock() - echo;
+            s.roundTripSeconds += trip;
+            s.worstRoundTripSeconds = std::max(s.worstRoundTripSeconds, trip);
+            s.roundTrips++;
+        }
+        peer.stamp = std::max(peer.stamp, stamp);
+        for(sf::Uint32 t = first; t < first + count; t++){
+            Frame f;
+            packet >> f.down >> f.moveX >> f.moveY;
+            if(!packet)
+                break;
+            // only the next one we're missing; later ones come again
+            if(t != received[player] || t >= tick + WINDOW / 2)
+                continue;
+            // a tick already run on a guess
+            if(t < tick && used[player][t % WINDOW] != f)
+                wrongFrom = std::min(wrongFrom, t);
+            at(player, t) = f;
+            received[player]++;
+            int lead = static_cast<int>(t) - static_cast<int>(tick);
+            stats.leadTicks += lead;
+            stats.worstLeadTicks = stats.leadSamples ? std::min(stats.worstLeadTicks, lead) : lead;
+            stats.leadSamples++;
+        }
+    }
+}
+
+int Lockstep::rewind()
+{
+    if(wrongFrom == NONE)
+        return 0;
+    int ticks = static_cast<int>(tick - wrongFrom);
+    if(!restore(wrongFrom)){
+        wrongFrom = NONE;
+        return -1;
+    }
+    tick = wrongFrom;
+    wrongFrom = NONE;
+    stats.replayed += ticks;
+    return ticks;
+}
+
+bool Lockstep::ready()
+{
+    bool guessed = false;
+    for(std::size_t p = 0; p < frames.size(); p++){
+        if(received[p] > tick)
+            continue;
+        if(static_cast<int>(tick - received[p]) >= maxAhead){
+            stats.stalls++;
+            return false;
+        }
+        guessed = true;
+    }
+    for(std::size_t p = 0; p < frames.size(); p++){
+        Frame& f = used[p][tick % WINDOW];
+        if(received[p] > tick)
+            f = at(p, tick);
+        else
+            // whatever they were doing last
+            f = received[p] > 0 ? at(p, received[p] - 1) : Frame();
+    }
+    if(guessed){
+        save(tick);
+        stats.predicted++;
+    }
+    return true;
+}
+
+const Lockstep::Frame& Lockstep::getFrame(int player) const
+{
+    return used[player][tick % WINDOW];
+}
+
+void Lockstep::advance()
+{
+    tick++;
+    stats.ticks++;
+}
+
+float Lockstep::clock() const
+{
+    return static_cast<float>(Input::now() - started);
+}
+
+Lockstep::Stats Lockstep::takeStats()
+{
+    Stats s = stats;
+    double now = Input::now();
+    s.seconds = static_cast<float>(now - statsSince);
+    statsSince = now;
+    stats = Stats();
+    for(auto it = s.peers.begin(); it != s.peers.end(); it++){
+        Stats::Peer peer;
+        peer.player = it->player;
+        stats.peers.push_back(peer);
+    }
+    return s;
+}
+
+void Lockstep::report(std::ostream& out)
+{
+    Stats s = takeStats();
+    char line[160];
+    float seconds = std::max(0.001f, s.seconds);
+    std::snprintf(line, sizeof(line), "Lockstep: %u ticks in %.1f s, %u stalled, %u guessed, %u replayed, delay %d",
+                  s.ticks, s.seconds, s.stalls, s.predicted, s.replayed, delay);
+    out << line << std::endl;
+    if(s.leadSamples){
+        std::snprintf(line, sizeof(line), "  remote input arrived %.1f ticks early on average, %d at worst",
+                      static_cast<double>(s.leadTicks) / s.leadSamples, s.worstLeadTicks);
+        out << line << std::endl;
+    }
+    for(auto it = s.peers.begin(); it != s.peers.end(); it++){
+        std::snprintf(line, sizeof(line), "  player %d: %.0f B/s up, %.0f B/s down, %u/%u packets, round trip %.1f ms (%.1f worst)",
+                      it->player, it->bytesSent / seconds, it->bytesReceived / seconds,
+                      it->packetsSent, it->packetsReceived,
+                      it->roundTrips ? it->roundTripSeconds / it->roundTrips * 1000 : 0.0f,
+                      it->worstRoundTripSeconds * 1000);
+        out << line << std::endl;
+    }
+}
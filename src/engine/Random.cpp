@@ -30,21 +30,24 @@
  * Author            : Steve Park & Dave Geyer
  * Language          : ANSI C
  * Latest Revision   : 10-28-98
+ *
+ * The generator underneath used to be Park & Miller's Lehmer generator with
+ * 256 global streams. The streams are now RandomStream objects (Philox, see
+ * engine/RandomStream.hpp) and the variates are computed there; this file
+ * only keeps the old "select a stream, then call a function" interface
+ * working. It's not thread safe, new code should use RandomStream directly.
  * --------------------------------------------------------------------------
  */
 
 #include "engine/Random.hpp"
+#include "engine/RandomStream.hpp"
 
-#define MODULUS    2147483647 /* DON'T CHANGE THIS VALUE                  */
-#define MULTIPLIER 48271      /* DON'T CHANGE THIS VALUE                  */
-#define CHECK      399268537  /* DON'T CHANGE THIS VALUE                  */
 #define STREAMS    256        /* # of streams, DON'T CHANGE THIS VALUE    */
-#define A256       22925      /* jump multiplier, DON'T CHANGE THIS VALUE */
-#define DEFAULT    123456789  /* initial seed, use 0 < DEFAULT < MODULUS  */
-      
-static long seed[STREAMS] = {DEFAULT};  /* current state of each stream   */
-static int  stream        = 0;          /* stream index, 0 is the default */
-static int  initialized   = 0;          /* test for stream initialization */
+#define DEFAULT    123456789  /* initial seed                             */
+
+static RandomStream seed[STREAMS];          /* one generator per stream       */
+static int  stream        = 0;              /* stream index, 0 is the default */
+static int  initialized   = 0;              /* test for stream initialization */
 
 
    double Random(void)
@@ -54,46 +57,28 @@ static int  initialized   = 0;          /* test for stream initialization */
  * ----------------------------------------------------------------
  */
 {
-  const long Q = MODULUS / MULTIPLIER;
-  const long R = MODULUS % MULTIPLIER;
-        long t;
-
-  t = MULTIPLIER * (seed[stream] % Q) - R * (seed[stream] / Q);
-  if (t > 0) 
-    seed[stream] = t;
-  else 
-    seed[stream] = t + MODULUS;
-  return ((double) seed[stream] / MODULUS);
+  return seed[stream].random();
 }
 
 
    void PlantSeeds(long x)
 /* ---------------------------------------------------------------------
  * Use this function to set the state of all the random number generator 
- * streams by "planting" a sequence of states (seeds), one per stream, 
- * with all states dictated by the state of the default stream. 
- * The sequence of planted states is separated one from the next by 
- * 8,367,782 calls to Random().
+ * streams. Every stream shares the seed x (interpreted as in PutSeed) and
+ * gets its own stream id, so the streams never overlap.
  * ---------------------------------------------------------------------
  */
 {
-  const long Q = MODULUS / A256;
-  const long R = MODULUS % A256;
-        int  j;
-        int  s;
+  int j;
+  int s;
 
   initialized = 1;
   s = stream;                            /* remember the current stream */
   SelectStream(0);                       /* change to stream 0          */
   PutSeed(x);                            /* set seed[0]                 */
   stream = s;                            /* reset the current stream    */
-  for (j = 1; j < STREAMS; j++) {
-    x = A256 * (seed[j - 1] % Q) - R * (seed[j - 1] / Q);
-    if (x > 0)
-      seed[j] = x;
-    else
-      seed[j] = x + MODULUS;
-   }
+  for (j = 0; j < STREAMS; j++)
+    seed[j] = RandomStream(seed[0].getSeed(), j);
 }
 
 
@@ -101,38 +86,26 @@ static int  initialized   = 0;          /* test for stream initialization */
 /* ---------------------------------------------------------------
  * Use this function to set the state of the current random number 
  * generator stream according to the following conventions:
- *    if x > 0 then x is the state (unless too large)
- *    if x < 0 then the state is obtained from the system clock
- *    if x = 0 then the state is to be supplied interactively
+ *    if x > 0 then x is the state
+ *    if x <= 0 then the state is obtained from the system clock
+ * (x = 0 used to prompt for a seed on stdin, which could hang the game)
  * ---------------------------------------------------------------
  */
 {
-  char ok = 0;
-
-  if (x > 0)
-    x = x % MODULUS;                       /* correct if x is too large  */
-  if (x < 0)                                 
-    x = ((unsigned long) time((time_t *) NULL)) % MODULUS;              
-  if (x == 0)                                
-    while (!ok) {
-      printf("\nEnter a positive integer seed (9 digits or less) >> ");
-      scanf("%ld", &x);
-      ok = (0 < x) && (x < MODULUS);
-      if (!ok)
-        printf("\nInput out of range ... try again\n");
-    }
-  seed[stream] = x;
+  if (x <= 0)
+    x = (long) time((time_t *) NULL);
+  seed[stream] = RandomStream((unsigned long) x, stream);
 }
 
 
    void GetSeed(long *x)
 /* ---------------------------------------------------------------
- * Use this function to get the state of the current random number 
+ * Use this function to get the seed of the current random number 
  * generator stream.                                                   
  * ---------------------------------------------------------------
  */
 {
-  *x = seed[stream];
+  *x = (long) seed[stream].getSeed();
 }
 
 
@@ -152,206 +125,34 @@ static int  initialized   = 0;          /* test for stream initialization */
    void TestRandom(void)
 /* ------------------------------------------------------------------
  * Use this (optional) function to test for a correct implementation.
+ * Checks the Philox4x32-10 known answer vectors from Random123.
  * ------------------------------------------------------------------    
  */
 {
-  long   i;
-  long   x;
-  double u;
-  char   ok = 0;  
+  unsigned int x[4];
+  char ok;
 
-  SelectStream(0);                  /* select the default stream */
-  PutSeed(1);                       /* and set the state to 1    */
-  for(i = 0; i < 10000; i++)
-    u = Random();
-  GetSeed(&x);                      /* get the new state value   */
-  ok = (x == CHECK);                /* and check for correctness */
-
-  SelectStream(1);                  /* select stream 1                 */ 
-  PlantSeeds(1);                    /* set the state of all streams    */
-  GetSeed(&x);                      /* get the state of stream 1       */
-  ok = ok && (x == A256);           /* x should be the jump multiplier */    
+  RandomStream::block(0, 0, 0, x);
+  ok = (x[0] == 0x6627e8d5u) && (x[1] == 0xe169c58du) && (x[2] == 0xbc57ac4cu) && (x[3] == 0x9b00dbd8u);
+  RandomStream::block(~0ULL, ~0ULL, ~0ULL, x);
+  ok = ok && (x[0] == 0x408f276du) && (x[1] == 0x41c83b0eu) && (x[2] == 0xa20bc7c6u) && (x[3] == 0x6d5451fdu);
   if (ok)
     printf("\n The implementation of rngs.c is correct.\n\n");
   else
     printf("\n\a ERROR -- the implementation of rngs.c is not correct.\n\n");
 }
 
-   long Bernoulli(double p)
-/* ========================================================
- * Returns 1 with probability p or 0 with probability 1 - p. 
- * NOTE: use 0.0 < p < 1.0                                   
- * ========================================================
- */ 
-{
-  return ((Random() < (1.0 - p)) ? 0 : 1);
-}
-
-   long Binomial(long n, double p)
-/* ================================================================ 
- * Returns a binomial distributed integer between 0 and n inclusive. 
- * NOTE: use n > 0 and 0.0 < p < 1.0
- * ================================================================
- */
-{ 
-  long i, x = 0;
-
-  for (i = 0; i < n; i++)
-    x += Bernoulli(p);
-  return (x);
-}
-
-   long Equilikely(long a, long b)
-/* ===================================================================
- * Returns an equilikely distributed integer between a and b inclusive. 
- * NOTE: use a < b
- * ===================================================================
- */
-{
-  return (a + (long) ((b - a + 1) * Random()));
-}
-
-   long Geometric(double p)
-/* ====================================================
- * Returns a geometric distributed non-negative integer.
- * NOTE: use 0.0 < p < 1.0
- * ====================================================
- */
-{
-  return ((long) (log(1.0 - Random()) / log(p)));
-}
-
-   long Pascal(long n, double p)
-/* ================================================= 
- * Returns a Pascal distributed non-negative integer. 
- * NOTE: use n > 0 and 0.0 < p < 1.0
- * =================================================
- */
-{ 
-  long i, x = 0;
-
-  for (i = 0; i < n; i++)
-    x += Geometric(p);
-  return (x);
-}
-
-   long Poisson(double m)
-/* ================================================== 
- * Returns a Poisson distributed non-negative integer. 
- * NOTE: use m > 0
- * ==================================================
- */
-{ 
-  double t = 0.0;
-  long   x = 0;
-
-  while (t < m) {
-    t += Exponential(1.0);
-    x++;
-  }
-  return (x - 1);
-}
-
-   double Uniform(double a, double b)
-/* =========================================================== 
- * Returns a uniformly distributed real number between a and b. 
- * NOTE: use a < b
- * ===========================================================
- */
-{ 
-  return (a + (b - a) * Random());
-}
-
-   double Exponential(double m)
-/* =========================================================
- * Returns an exponentially distributed positive real number. 
- * NOTE: use m > 0.0
- * =========================================================
- */
-{
-  return (-m * log(1.0 - Random()));
-}
-
-   double Erlang(long n, double b)
-/* ================================================== 
- * Returns an Erlang distributed positive real number.
- * NOTE: use n > 0 and b > 0.0
- * ==================================================
- */
-{ 
-  long   i;
-  double x = 0.0;
-
-  for (i = 0; i < n; i++) 
-    x += Exponential(b);
-  return (x);
-}
-
-   double Normal(double m, double s)
-/* ========================================================================
- * Returns a normal (Gaussian) distributed real number.
- * NOTE: use s > 0.0
- *
- * Uses a very accurate approximation of the normal idf due to Odeh & Evans, 
- * J. Applied Statistics, 1974, vol 23, pp 96-97.
- * ========================================================================
- */
-{ 
-  const double p0 = 0.322232431088;     const double q0 = 0.099348462606;
-  const double p1 = 1.0;                const double q1 = 0.588581570495;
-  const double p2 = 0.342242088547;     const double q2 = 0.531103462366;
-  const double p3 = 0.204231210245e-1;  const double q3 = 0.103537752850;
-  const double p4 = 0.453642210148e-4;  const double q4 = 0.385607006340e-2;
-  double u, t, p, q, z;
-
-  u   = Random();
-  if (u < 0.5)
-    t = sqrt(-2.0 * log(u));
-  else
-    t = sqrt(-2.0 * log(1.0 - u));
-  p   = p0 + t * (p1 + t * (p2 + t * (p3 + t * p4)));
-  q   = q0 + t * (q1 + t * (q2 + t * (q3 + t * q4)));
-  if (u < 0.5)
-    z = (p / q) - t;
-  else
-    z = t - (p / q);
-  return (m + s * z);
-}
-
-   double Lognormal(double a, double b)
-/* ==================================================== 
- * Returns a lognormal distributed positive real number. 
- * NOTE: use b > 0.0
- * ====================================================
- */
-{
-  return (exp(a + b * Normal(0.0, 1.0)));
-}
-
-   double Chisquare(long n)
-/* =====================================================
- * Returns a chi-square distributed positive real number. 
- * NOTE: use n > 0
- * =====================================================
- */
-{ 
-  long   i;
-  double z, x = 0.0;
-
-  for (i = 0; i < n; i++) {
-    z  = Normal(0.0, 1.0);
-    x += z * z;
-  }
-  return (x);
-}
-
-   double Student(long n)
-/* =========================================== 
- * Returns a student-t distributed real number.
- * NOTE: use n > 0
- * ===========================================
- */
-{
-  return (Normal(0.0, 1.0) / sqrt(Chisquare(n) / n));
-}
-
+long   Bernoulli(double p)         { return seed[stream].bernoulli(p); }
+long   Binomial(long n, double p)  { return seed[stream].binomial(n, p); }
+long   Equilikely(long a, long b)  { return seed[stream].equilikely(a, b); }
+long   Geometric(double p)         { return seed[stream].geometric(p); }
+long   Pascal(long n, double p)    { return seed[stream].pascal(n, p); }
+long   Poisson(double m)           { return seed[stream].poisson(m); }
+
+double Uniform(double a, double b) { return seed[stream].uniform(a, b); }
+double Exponential(double m)       { return seed[stream].exponential(m); }
+double Erlang(long n, double b)    { return seed[stream].erlang(n, b); }
+double Normal(double m, double s)  { return seed[stream].normal(m, s); }
+double Lognormal(double a, double b){ return seed[stream].lognormal(a, b); }
+double Chisquare(long n)           { return seed[stream].chisquare(n); }
+double Student(long n)             { return seed[stream].student(n); }
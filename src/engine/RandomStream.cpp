@@ -0,0 +1,264 @@
+#include "engine/RandomStream.hpp"
+#include <map>
+#include <math.h>
+#include <mutex>
+
+namespace
+{
+    // Philox constants, DON'T CHANGE THESE
+    const uint32_t M0 = 0xD2511F53;
+    const uint32_t M1 = 0xCD9E8D57;
+    const uint32_t W0 = 0x9E3779B9;
+    const uint32_t W1 = 0xBB67AE85;
+
+    std::mutex registry_mutex;
+    uint64_t master_seed = 123456789;
+
+    std::map<std::string, RandomStream>& registry()
+    {
+        static std::map<std::string, RandomStream> streams;
+        return streams;
+    }
+
+    // FNV-1a, turns a stream name into a stream id
+    uint64_t hashName(const std::string& name)
+    {
+        uint64_t h = 14695981039346656037ULL;
+        for(auto it = name.begin(); it != name.end(); it++){
+            h ^= (unsigned char)*it;
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+
+    inline double toUniform(uint32_t x)
+    {
+        // centre of one of 2^32 equal bins, so never 0 or 1
+        return (x + 0.5) * (1.0 / 4294967296.0);
+    }
+}
+
+RandomStream::RandomStream(uint64_t seed, uint64_t id) : key(seed), id(id)
+{
+}
+
+RandomStream& RandomStream::get(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    auto it = registry().find(name);
+    if(it == registry().end())
+        it = registry().insert(std::make_pair(name, RandomStream(master_seed, hashName(name)))).first;
+    return it->second;
+}
+
+void RandomStream::seedAll(uint64_t seed)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    master_seed = seed;
+    for(auto it = registry().begin(); it != registry().end(); it++)
+        it->second.seed(seed);
+}
+
+uint64_t RandomStream::getMasterSeed()
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    return master_seed;
+}
+
+uint64_t RandomStream::getNameId(const std::string& name)
+{
+    return hashName(name);
+}
+
+void RandomStream::seed(uint64_t seed)
+{
+    key = seed;
+    counter = 0;
+    used = 4;
+}
+
+void RandomStream::setPosition(uint64_t position)
+{
+    counter = position / 4;
+    used = position % 4;
+    if(used == 0){
+        used = 4;
+        return;
+    }
+    block(counter++, id, key, buffer);
+}
+
+void RandomStream::block(uint64_t counter, uint64_t id, uint64_t key, uint32_t out[4])
+{
+    uint32_t c0 = (uint32_t)counter, c1 = (uint32_t)(counter >> 32);
+    uint32_t c2 = (uint32_t)id,      c3 = (uint32_t)(id >> 32);
+    uint32_t k0 = (uint32_t)key,     k1 = (uint32_t)(key >> 32);
+    for(int round = 0; round < 10; round++){
+        if(round > 0){
+            k0 += W0;
+            k1 += W1;
+        }
+        uint64_t p0 = (uint64_t)M0 * c0;
+        uint64_t p1 = (uint64_t)M1 * c2;
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c0 = n0;
+        c1 = (uint32_t)p1;
+        c2 = n2;
+        c3 = (uint32_t)p0;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+uint32_t RandomStream::next()
+{
+    if(used == 4){
+        block(counter++, id, key, buffer);
+        used = 0;
+    }
+    return buffer[used++];
+}
+
+double RandomStream::random()
+{
+    return toUniform(next());
+}
+
+void RandomStream::fill(uint32_t* out, std::size_t n)
+{
+    // finish the buffered block, then write whole blocks straight into out
+    while(n > 0 && used < 4){
+        *out++ = buffer[used++];
+        n--;
+    }
+    for(; n >= 4; n -= 4, out += 4)
+        block(counter++, id, key, out);
+    while(n-- > 0)
+        *out++ = next();
+}
+
+void RandomStream::fill(double* out, std::size_t n)
+{
+    uint32_t bits[64];
+    while(n > 0){
+        std::size_t count = n < 64 ? n : 64;
+        fill(bits, count);
+        for(std::size_t i = 0; i < count; i++)
+            out[i] = toUniform(bits[i]);
+        out += count;
+        n -= count;
+    }
+}
+
+/* ----------------------------------------------------------------------
+ * The distributions below are straight ports of rvgs.c by Steve Park &
+ * Dave Geyer (see Random.cpp for the table of means and variances).
+ * ----------------------------------------------------------------------
+ */
+
+long RandomStream::bernoulli(double p)
+{
+    return ((random() < (1.0 - p)) ? 0 : 1);
+}
+
+long RandomStream::binomial(long n, double p)
+{
+    long x = 0;
+    for(long i = 0; i < n; i++)
+        x += bernoulli(p);
+    return x;
+}
+
+long RandomStream::equilikely(long a, long b)
+{
+    return (a + (long) ((b - a + 1) * random()));
+}
+
+long RandomStream::geometric(double p)
+{
+    return ((long) (log(1.0 - random()) / log(p)));
+}
+
+long RandomStream::pascal(long n, double p)
+{
+    long x = 0;
+    for(long i = 0; i < n; i++)
+        x += geometric(p);
+    return x;
+}
+
+long RandomStream::poisson(double m)
+{
+    double t = 0.0;
+    long   x = 0;
+    while (t < m) {
+        t += exponential(1.0);
+        x++;
+    }
+    return (x - 1);
+}
+
+double RandomStream::uniform(double a, double b)
+{
+    return (a + (b - a) * random());
+}
+
+double RandomStream::exponential(double m)
+{
+    return (-m * log(1.0 - random()));
+}
+
+double RandomStream::erlang(long n, double b)
+{
+    double x = 0.0;
+    for(long i = 0; i < n; i++)
+        x += exponential(b);
+    return x;
+}
+
+double RandomStream::normal(double m, double s)
+{
+    // Odeh & Evans approximation of the normal idf
+    const double p0 = 0.322232431088;     const double q0 = 0.099348462606;
+    const double p1 = 1.0;                const double q1 = 0.588581570495;
+    const double p2 = 0.342242088547;     const double q2 = 0.531103462366;
+    const double p3 = 0.204231210245e-1;  const double q3 = 0.103537752850;
+    const double p4 = 0.453642210148e-4;  const double q4 = 0.385607006340e-2;
+    double u, t, p, q, z;
+
+    u   = random();
+    if (u < 0.5)
+        t = sqrt(-2.0 * log(u));
+    else
+        t = sqrt(-2.0 * log(1.0 - u));
+    p   = p0 + t * (p1 + t * (p2 + t * (p3 + t * p4)));
+    q   = q0 + t * (q1 + t * (q2 + t * (q3 + t * q4)));
+    if (u < 0.5)
+        z = (p / q) - t;
+    else
+        z = t - (p / q);
+    return (m + s * z);
+}
+
+double RandomStream::lognormal(double a, double b)
+{
+    return (exp(a + b * normal(0.0, 1.0)));
+}
+
+double RandomStream::chisquare(long n)
+{
+    double z, x = 0.0;
+    for(long i = 0; i < n; i++){
+        z  = normal(0.0, 1.0);
+        x += z * z;
+    }
+    return x;
+}
+
+double RandomStream::student(long n)
+{
+    return (normal(0.0, 1.0) / sqrt(chisquare(n) / n));
+}
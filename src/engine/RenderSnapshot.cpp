@@ -0,0 +1,15 @@
+#include "engine/RenderSnapshot.hpp"
+#include "engine/GameObject.hpp"
+
+sf::Vector2f EntitySnapshot::getRenderPosition() const
+{
+    return GameObject::interpolate(previous, current);
+}
+
+void EntitySnapshot::draw(sf::RenderTarget& target) const
+{
+    sf::Transform offset;
+    offset.translate(getRenderPosition() - current);
+    for(auto it = sprites.begin(); it != sprites.end(); it++)
+        target.draw(it->sprite, offset * it->transform);
+}
@@ -1,15 +1,44 @@
 #include "engine/ResourceManager.hpp"
+#include "engine/FileWatcher.hpp"
+#include "engine/Input.hpp"
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 
 std::map<std::string, sf::Font> ResourceManager::fonts_cache;
 std::map<std::string, sf::Texture> ResourceManager::textures_cache;
 std::map< std::string, sf::SoundBuffer > ResourceManager::sound_cache;
+std::map< std::pair<std::string, std::string>, std::unique_ptr<sf::Shader> > ResourceManager::shader_cache;
+std::atomic<bool> ResourceManager::watching(false);
+std::thread ResourceManager::watcher;
+std::mutex ResourceManager::reloadMutex;
+std::vector<ResourceManager::Watched> ResourceManager::toWatch;
+std::vector<ResourceManager::Reload> ResourceManager::reloads;
+
+namespace
+{
+    // how long the watching thread waits on a save before looking for
+    // new files to watch (or being stopped)
+    const int WAIT_MS = 50;
+
+    bool readFile(const std::string& name, std::string& out)
+    {
+        std::ifstream file(name, std::ios::binary);
+        if(!file)
+            return false;
+        std::ostringstream text;
+        text << file.rdbuf();
+        out = text.str();
+        return true;
+    }
+}
 
 sf::Font* ResourceManager::getFont(std::string name)
 {
     if(!fonts_cache.count(name))
     {
-        // load the fonts 
+        // load the fonts
         sf::Font f;
         if(f.loadFromFile(name)){
             fonts_cache[name] = f;
@@ -42,6 +71,141 @@ sf::Texture* ResourceManager::getTexture(std::string name)
         }else{
             std::cout << "Texture " << name << " not found!" << std::endl;
         };
+        watch({name, "", false});
     }
     return &(textures_cache[name]);
-}
\ No newline at end of file
+}
+
+sf::Shader* ResourceManager::getShader(std::string vertex, std::string fragment)
+{
+    std::pair<std::string, std::string> key(vertex, fragment);
+    auto found = shader_cache.find(key);
+    if(found != shader_cache.end())
+        return found->second.get();
+    std::unique_ptr<sf::Shader> shader;
+    if(sf::Shader::isAvailable()){
+        shader.reset(new sf::Shader());
+        if(shader->loadFromFile(vertex, fragment))
+            watch({vertex, fragment, true});
+        else{
+            std::cout << "Shader " << vertex << " + " << fragment << " didn't compile!" << std::endl;
+            shader.reset();
+        }
+    }
+    sf::Shader* s = shader.get();
+    shader_cache[key] = std::move(shader);
+    return s;
+}
+
+void ResourceManager::watch(const Watched& file)
+{
+    if(!watching)
+        return;
+    std::lock_guard<std::mutex> lock(reloadMutex);
+    toWatch.push_back(file);
+}
+
+void ResourceManager::startWatching()
+{
+    if(watching)
+        return;
+    {
+        std::lock_guard<std::mutex> lock(reloadMutex);
+        for(auto it = textures_cache.begin(); it != textures_cache.end(); it++)
+            toWatch.push_back({it->first, "", false});
+        for(auto it = shader_cache.begin(); it != shader_cache.end(); it++)
+            if(it->second)
+                toWatch.push_back({it->first.first, it->first.second, true});
+    }
+    watching = true;
+    watcher = std::thread(watchLoop);
+}
+
+void ResourceManager::stopWatching()
+{
+    if(!watching)
+        return;
+    watching = false;
+    watcher.join();
+    std::lock_guard<std::mutex> lock(reloadMutex);
+    toWatch.clear();
+    reloads.clear();
+}
+
+void ResourceManager::watchLoop()
+{
+    FileWatcher files;
+    std::vector<Watched> watched;
+    while(watching){
+        {
+            std::lock_guard<std::mutex> lock(reloadMutex);
+            for(auto it = toWatch.begin(); it != toWatch.end(); it++){
+                files.watch(it->vertex);
+                if(it->shader)
+                    files.watch(it->fragment);
+                watched.push_back(*it);
+            }
+            toWatch.clear();
+        }
+        std::vector<std::string> saved = files.wait(WAIT_MS);
+        if(saved.empty())
+            continue;
+        double now = Input::now();
+        for(auto it = watched.begin(); it != watched.end(); it++){
+            if(std::find(saved.begin(), saved.end(), it->vertex) == saved.end() &&
+               (!it->shader || std::find(saved.begin(), saved.end(), it->fragment) == saved.end()))
+                continue;
+            // the slow part (decoding a png) happens here, not between frames
+            Reload r;
+            r.file = *it;
+            r.saved = now;
+            if(!it->shader && !r.image.loadFromFile(it->vertex)){
+                std::cout << "Couldn't reload " << it->vertex << ", keeping the old one" << std::endl;
+                continue;
+            }
+            if(it->shader && (!readFile(it->vertex, r.vertexSource) || !readFile(it->fragment, r.fragmentSource))){
+                std::cout << "Couldn't reload " << it->fragment << ", keeping the old one" << std::endl;
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(reloadMutex);
+            reloads.push_back(std::move(r));
+        }
+    }
+}
+
+int ResourceManager::applyReloads()
+{
+    std::vector<Reload> ready;
+    {
+        std::lock_guard<std::mutex> lock(reloadMutex);
+        if(reloads.empty())
+            return 0;
+        ready.swap(reloads);
+    }
+    int swapped = 0;
+    for(auto it = ready.begin(); it != ready.end(); it++){
+        const Watched& file = it->file;
+        if(!file.shader){
+            // same size: straight over the pixels, without a new GL texture
+            sf::Texture& t = textures_cache[file.vertex];
+            if(t.getSize() == it->image.getSize())
+                t.update(it->image);
+            else
+                t.loadFromImage(it->image);
+        }
+        else{
+            // a failed compile wipes out the shader it's compiled into, so
+            // make sure of it on a spare first
+            sf::Shader test;
+            if(!test.loadFromMemory(it->vertexSource, it->fragmentSource)){
+                std::cout << file.fragment << " didn't compile, keeping the old one" << std::endl;
+                continue;
+            }
+            shader_cache[std::make_pair(file.vertex, file.fragment)]->loadFromMemory(it->vertexSource, it->fragmentSource);
+        }
+        swapped++;
+        std::cout << "Reloaded " << (file.shader ? file.fragment : file.vertex) << " "
+                  << static_cast<int>((Input::now() - it->saved) * 1000) << " ms after it was saved" << std::endl;
+    }
+    return swapped;
+}
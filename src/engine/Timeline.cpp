@@ -0,0 +1,63 @@
+#include "engine/Timeline.hpp"
+
+Timeline& Timeline::then(float* target, interpolate::EASE curve, float start, float end, float duration)
+{
+    last = nextStart();
+    return with(target, curve, start, end, duration);
+}
+
+Timeline& Timeline::with(float* target, interpolate::EASE curve, float start, float end, float duration)
+{
+    if(tweens)
+        steps.push_back(tweens->add(target, curve, start, end, duration, last));
+    this->end = std::max(this->end, last + duration);
+    return *this;
+}
+
+Timeline& Timeline::call(std::function<void()> f)
+{
+    last = nextStart();
+    if(tweens)
+        steps.push_back(tweens->schedule(last, f));
+    end = std::max(end, last);
+    return *this;
+}
+
+Timeline& Timeline::wait(float seconds)
+{
+    next = (next >= 0 ? next : end) + seconds;
+    return *this;
+}
+
+Timeline& Timeline::at(float seconds)
+{
+    next = seconds;
+    return *this;
+}
+
+void Timeline::cancel()
+{
+    if(tweens)
+        for(auto it = steps.begin(); it != steps.end(); it++)
+            tweens->cancel(*it);
+    steps.clear();
+    last = 0;
+    end = 0;
+    next = -1;
+}
+
+bool Timeline::isActive() const
+{
+    if(tweens)
+        for(auto it = steps.begin(); it != steps.end(); it++)
+            if(tweens->isActive(*it))
+                return true;
+    return false;
+}
+
+float Timeline::nextStart()
+{
+    float start = next >= 0 ? next : end;
+    next = -1;
+    return start;
+}
@@ -0,0 +1,152 @@
+#include "engine/TweenManager.hpp"
+
+TweenManager::Handle TweenManager::add(float* target, interpolate::EASE curve, float start, float end, float duration, float delay)
+{
+    Lane& lane = lanes[curve];
+    Handle h = newHandle(curve, lane.handle.size());
+
+    lane.elapsed.push_back(-std::max(delay, 0.0f));
+    lane.start.push_back(start);
+    lane.change.push_back(end - start);
+    // the curves divide by the duration
+    lane.duration.push_back(duration > 0 ? duration : 1e-6f);
+    lane.value.push_back(start);
+    lane.target.push_back(target);
+    lane.handle.push_back(h);
+    lane.done.push_back(std::function<void()>());
+    if(target && delay <= 0)
+        *target = start;
+    return h;
+}
+
+TweenManager::Handle TweenManager::schedule(float delay, std::function<void()> f)
+{
+    Timer timer;
+    timer.remaining = delay;
+    timer.handle = newHandle(TIMERS, timers.size());
+    timer.done = f;
+    timers.push_back(timer);
+    return timer.handle;
+}
+
+void TweenManager::onComplete(Handle h, std::function<void()> f)
+{
+    auto it = slots.find(h);
+    if(it == slots.end())
+        return;
+    if(it->second.lane == TIMERS)
+        timers[it->second.index].done = f;
+    else
+        lanes[it->second.lane].done[it->second.index] = f;
+}
+
+void TweenManager::cancel(Handle h)
+{
+    auto it = slots.find(h);
+    if(it != slots.end())
+        remove(it->second.lane, it->second.index);
+}
+
+void TweenManager::update(float dt)
+{
+    // callbacks run after every lane is done, so they're free to add or cancel tweens
+    std::vector<std::function<void()>> finished;
+    for(int l = 0; l < interpolate::EASE_COUNT; l++){
+        Lane& lane = lanes[l];
+        std::size_t n = lane.handle.size();
+        if(n == 0)
+            continue;
+
+        float* elapsed = lane.elapsed.data();
+        float* value = lane.value.data();
+        const float* duration = lane.duration.data();
+        for(std::size_t i = 0; i < n; i++){
+            elapsed[i] = std::min(elapsed[i] + dt, duration[i]);
+            // delayed tweens sit at their start
+            value[i] = std::max(elapsed[i], 0.0f);
+        }
+
+        interpolate::ease(static_cast<interpolate::EASE>(l), value, lane.start.data(),
+                          lane.change.data(), duration, value, n);
+
+        for(std::size_t i = 0; i < n; i++)
+            if(lane.target[i] && elapsed[i] >= 0)
+                *lane.target[i] = value[i];
+
+        // walk backwards so swap-removal doesn't skip anything
+        for(std::size_t i = n; i-- > 0;){
+            if(lane.elapsed[i] >= lane.duration[i]){
+                if(lane.done[i])
+                    finished.push_back(lane.done[i]);
+                remove(l, i);
+            }
+        }
+    }
+    // after the tweens, so a callback at the end of a tween sees its last value
+    for(std::size_t i = timers.size(); i-- > 0;){
+        timers[i].remaining -= dt;
+        if(timers[i].remaining <= 0){
+            if(timers[i].done)
+                finished.push_back(timers[i].done);
+            remove(TIMERS, i);
+        }
+    }
+    for(auto it = finished.begin(); it != finished.end(); it++)
+        (*it)();
+}
+
+void TweenManager::clear()
+{
+    for(int l = 0; l < interpolate::EASE_COUNT; l++)
+        lanes[l] = Lane();
+    timers.clear();
+    slots.clear();
+}
+
+TweenManager::Handle TweenManager::newHandle(int lane, std::size_t index)
+{
+    Handle h = nextHandle++;
+    if(nextHandle == 0)
+        nextHandle = 1;
+    Slot slot;
+    slot.lane = lane;
+    slot.index = index;
+    slots[h] = slot;
+    return h;
+}
+
+// Swaps the last tween of the lane into index
+void TweenManager::remove(int l, std::size_t index)
+{
+    if(l == TIMERS){
+        slots.erase(timers[index].handle);
+        if(index != timers.size() - 1){
+            timers[index] = std::move(timers.back());
+            slots[timers[index].handle].index = index;
+        }
+        timers.pop_back();
+        return;
+    }
+    Lane& lane = lanes[l];
+    std::size_t last = lane.handle.size() - 1;
+    slots.erase(lane.handle[index]);
+    if(index != last){
+        lane.elapsed[index] = lane.elapsed[last];
+        lane.start[index] = lane.start[last];
+        lane.change[index] = lane.change[last];
+        lane.duration[index] = lane.duration[last];
+        lane.value[index] = lane.value[last];
+        lane.target[index] = lane.target[last];
+        lane.handle[index] = lane.handle[last];
+        lane.done[index] = std::move(lane.done[last]);
+        slots[lane.handle[index]].index = index;
+    }
+    lane.elapsed.pop_back();
+    lane.start.pop_back();
+    lane.change.pop_back();
+    lane.duration.pop_back();
+    lane.value.pop_back();
+    lane.target.pop_back();
+    lane.handle.pop_back();
+    lane.done.pop_back();
+}
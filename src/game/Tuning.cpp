@@ -0,0 +1,46 @@
+#include "game/Tuning.hpp"
+#include <iostream>
+
+Match::Rules Tuning::rules;
+Match::Rules Tuning::pending;
+bool Tuning::hasPending = false;
+std::string Tuning::filename;
+FileWatcher Tuning::watcher;
+int Tuning::version = 0;
+
+bool Tuning::load(const std::string& filename)
+{
+    // a line taken out of the file goes back to its default
+    Match::Rules loaded;
+    if(!loaded.load(filename))
+        return false;
+    if(Tuning::filename != filename){
+        Tuning::filename = filename;
+        watcher.watch(filename);
+    }
+    rules = loaded;
+    version++;
+    return true;
+}
+
+void Tuning::poll()
+{
+    if(watcher.poll().empty())
+        return;
+    Match::Rules loaded;
+    if(!loaded.load(filename))
+        return;
+    pending = loaded;
+    hasPending = true;
+}
+
+bool Tuning::update()
+{
+    if(!hasPending)
+        return false;
+    rules = pending;
+    hasPending = false;
+    version++;
+    std::cout << "Tuning: reloaded " << filename << std::endl;
+    return true;
+}
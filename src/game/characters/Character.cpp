@@ -1,7 +1,9 @@
+#include <algorithm>
 #include <vector>
 #include <iostream>
 #include <string>
 #include <set>
+#include <cmath>
 #include "game/characters/Character.hpp"
 #include "game/characters/Villain.hpp"
 
@@ -23,17 +25,12 @@ void Character::init()
             // -- speed
             // intelligence *= 2;
             // speed /= 1.2;
-            health = 3;
-            maxHealth = 3;
             sprite_location = 0;
             break;
         case Config::CHARACTER::SIS:
             std::cout << "SIS" << std::endl;
             // ++ stealth
             // -- strength
-            health = 3;
-            maxHealth = 3;
-
             sprite_location = 1;
             // stealth *= 2;
             // strength /= 2;
@@ -42,100 +39,29 @@ void Character::init()
             std::cout << "BRO" << std::endl;
             // ++ speed
             // -- stealth
-            health = 3;
-            maxHealth = 3;
             sprite_location = 2;
             // speed *= 1.3;
             // stealth /= 2;
             break;
         case Config::CHARACTER::DAD:
             std::cout << "DAD" << std::endl;
-            health = 5;
-            maxHealth = 5;
             sprite_location = 3;
             break;
     }
-    hasItem = false;
-    itemDamage = 1;
-    // int sprite_location = static_cast<int>(character);
-    
-    // Wow
-    int random_room = rand() % g->roomCount();
-    Room* room = g->getRoom(random_room);
-
-    if(room->room_setup == "armory"){
-        this->setPosition(
-            room->hbox.left + 20 + (32 * player_number),
-            room->hbox.top + 160);
-    }
-    else if(room->room_setup == "throne"){
-        this->setPosition(
-        room->hbox.left + 20 + (32 * player_number),
-        room->hbox.top + 160);
-    }
-    else if(room->room_setup == "grave"){
-        this->setPosition(
-        room->hbox.left + 20 + (32 * player_number),
-        room->hbox.top + 128);
-    }
-    else if(room->room_setup == "parlor"){
-        this->setPosition(
-        room->hbox.left + 20 + (32 * player_number),
-        room->hbox.top + 128);
-    }
-    else if(room->room_setup == "lounge"){
-        this->setPosition(
-        room->hbox.left + 20 + (32 * player_number),
-        room->hbox.top + 160);
-    }
-    else if(room->room_setup == "kitchen"){
-        this->setPosition(
-        room->hbox.left + 20 + (32 * player_number),
-        room->hbox.top + 160);
-    }
-    else if(room->room_setup == "lion"){
-        this->setPosition(
-        room->hbox.left + 20 + (32 * player_number),
-        room->hbox.top + 160);
-    }
-    else if(room->room_setup == "barrels"){
-        this->setPosition(
-        room->hbox.left + 20 + (32 * player_number),
-        room->hbox.top + 160);
-    }
-    else if(room->room_setup == "dungeon"){
-        this->setPosition(
-        room->hbox.left + 20 + (32 * player_number),
-        room->hbox.top + 256);
-    }
-    else if(room->room_setup == "bedroom"){
-        this->setPosition(
-        room->hbox.left + 20 + (32 * player_number),
-        room->hbox.top + 160);
-    }
-    else if(room->room_setup == "wood_bedroom"){
-        this->setPosition(
-        room->hbox.left + 20 + (32 * player_number),
-        room->hbox.top + 128);
-    }
-    else if(room->room_setup == "bathroom"){
-        this->setPosition(
-        room->hbox.left + 20 + (32 * player_number),
-        room->hbox.top + 96);
-    }else{
-        this->setPosition(
-            room->hbox.left + 20 + (32 * player_number),
-            room->hbox.top + 160
-        );
-    }
-    // this->setPosition(g->rooms.front()->getPosition().x + 20 + (32 * player_number), g->rooms.front()->getPosition().y + 20);
+    // the match says where it starts and how much it can take
+    const Match::Player& p = match->getPlayers()[seat];
+    health = p.health;
+    maxHealth = match->getRules().health[character];
+    hasItem = p.hasItem;
+    itemDamage = p.itemDamage;
+    this->setPosition(p.position);
     // 1p width, height
     // 2p width/2 height
     // 3p, 4p width/2 height/2
     // v.setViewport(sf::FloatRect(0.f, 0.f, 0.5f, 1.f));
     // v.setViewport(sf::FloatRect(0.f, 0.f, 0.5f, 1.f));
     // load the sprite map
-    sprite_map = *ResourceManager::getTexture("../resources/sprites/character_sheet.png");
+    sf::Texture& sprite_map = *ResourceManager::getTexture("../resources/sprites/character_sheet.png");
     // add animation frames
     int x = ((sprite_location) % 2);
     int y = ((sprite_location) / 2);
@@ -173,8 +99,7 @@ void Character::init()
     walk_up.addFrames(up_frames, 32, 32);
     // set death sprite
     std::vector< std::vector<int> > death_frame = { {0} };
-    death_map.loadFromFile("../resources/sprites/grave.png");
-    death_animation.setSpriteSheet(death_map);
+    death_animation.setSpriteSheet(*ResourceManager::getTexture("../resources/sprites/grave.png"));
     death_animation.addFrames(death_frame, 32, 32);
     // set damage animation
     // set default animation
@@ -188,135 +113,86 @@ void Character::init()
     invul = false;
 }
 
-void Character::setItemDamage(int damaging){
-    itemDamage = damaging;
-}
-void Character::checkVillain(){
-    std::vector<std::shared_ptr<Character>> entities = entity_group->getCharacters();
-    for(auto it = entities.begin(); it != entities.end(); it++){
-        std::shared_ptr<Character> c = *it;
-        // std::cout << this->hbox.left + this->hbox.width + 32;
-        // std::cout << " ";
-        if(c->isVillain() == true){
-            if((c->hbox) == this->hbox){continue;}
-            c->setItemDamage(itemDamage);
-            // std::cout << c->hbox.left << std::endl;
-            if(curr == &walk_right && this->hbox.left + this->hbox.width + 64 > c->hbox.left &&
-                this->hbox.left + this->hbox.width < c->hbox.left &&
-            c->hbox.top >= this->hbox.top - 32&& c->hbox.top <= this->hbox.top + 32){
-                std::cout << "hiyah" << std::endl;
-                c->hurt();
-            }
-            if(curr == &walk_left && this->hbox.left - 64 < c->hbox.left + c->hbox.width &&
-                this->hbox.left > c->hbox.left + c->hbox.width &&
-                c->hbox.top >= this->hbox.top - 32 && c->hbox.top <= this->hbox.top + 32){
-                std::cout << "hiyah" << std::endl;
-                c->hurt();
-            }
-            if(curr == &walk_up && this->hbox.top - 64 < c->hbox.top + c->hbox.height &&
-                this->hbox.top > c->hbox.top + c->hbox.height &&
-            c->hbox.left >= this->hbox.left - 32 && c->hbox.top <= this->hbox.left + 32){
-                std::cout << "hiyah" << std::endl;
-                c->hurt();
-             }
-            if(curr == &walk_down && this->hbox.top + this->hbox.height + 64 > c->hbox.top &&
-                this->hbox.top + this->hbox.height < c->hbox.top &&
-                c->hbox.left >= this->hbox.left - 20 && c->hbox.top <= this->hbox.left + 36){
-                std::cout << "hiyah" << std::endl;
-                c->hurt();
-            }
-            // std::cout << c->health << std::endl;
-        }
-    }
-}
-void Character::checkClues(){
-    std::vector<std::shared_ptr<Clue>> entities = entity_group->getClues();
-    // std::cout << entities.size() << std::endl;
-    for(auto it = entities.begin(); it != entities.end(); it++){
-        std::shared_ptr<Clue> c = *it;
-
-        if(c->hbox.intersects(this->hbox)){
-            // std::cout << c->hbox.top + c->hbox.height - this->hbox.top << std::endl;
-            if(this->hbox.left + this->hbox.width - c->hbox.left >= 0 && this->hbox.left + this->hbox.width - c->hbox.left <= 4){
-                this->stopRight = true;
-                // std::cout << "stop right" << std::endl;
-            }
-            else if(c->hbox.left + c->hbox.width - this->hbox.left >= 0 && c->hbox.left + c->hbox.width - this->hbox.left <= 4){
-                this->stopLeft = true;
-                // std::cout << "stop left" << std::endl;
-            }
-            else if(c->hbox.top + c->hbox.height - this->hbox.top >= 0 && c->hbox.top + c->hbox.height - this->hbox.top <= 4){
-                this->stopUp = true;
-                // std::cout << "stop up" << std::endl;
-            }
-            else if(this->hbox.top + this->hbox.height - c->hbox.top >= 0 && this->hbox.top + this->hbox.height - c->hbox.top <= 4){
-                this->stopDown = true;
-                // std::cout << "stop down" << std::endl;
-            }
-            this->currentClue = c;
-            this->hbox.setColor(sf::Color::Green);
-            atClue = true;
+void Character::face(Match::FACING facing)
+{
+    // swing the way it's facing
+    switch(facing){
+        case Match::FACE_LEFT:
+            curr = &walk_left;
+            attack_anim.setRotation(180);
+            attack_anim.setPosition(16, 32);
+            break;
+        case Match::FACE_RIGHT:
+            curr = &walk_right;
+            attack_anim.setRotation(0);
+            attack_anim.setPosition(16, 0);
+            break;
+        case Match::FACE_UP:
+            curr = &walk_up;
+            attack_anim.setRotation(-90);
+            attack_anim.setPosition(0, 16);
+            break;
+        case Match::FACE_DOWN:
+            curr = &walk_down;
+            attack_anim.setRotation(90);
+            attack_anim.setPosition(32, 16);
             break;
-        }
-        else{
-            this->stopLeft = false;
-            this->stopRight = false;
-            this->stopUp = false;
-            this->stopDown = false;
-            this->currentClue = NULL;
-            atClue = false;
-            // std::cout << "in the else " << readClue << std::endl;
-        }
     }
 }
 
 void Character::onUpdate(float dt)
 {
-    float dx = this->direction.x * speed * dt;
-    float dy = this->direction.y * speed * dt;
-
-    // check if inside any room
-    if(g->isInsideRoom(sf::FloatRect(hbox.left + dx, hbox.top + dy, hbox.width, hbox.height)) && health > 0){
-        this->checkClues();
-        if(this->stopLeft == true && dx < 0){
-            dx = 0;
-        }
-        if(this->stopRight == true && dx > 0){
-            dx = 0;
+    const Match::Player& p = match->getPlayers()[seat];
+    sf::Vector2f from = this->getPosition();
+    this->setPosition(p.position);
+    this->direction = p.direction;
+    // maxHealth follows a reloaded Tuning
+    maxHealth = match->getRules().health[character];
+    hasItem = p.hasItem;
+    itemDamage = p.itemDamage;
+    this->invul = p.invulnerable > 0;
+    if(p.health < health && !replaying){
+        if(p.health > 0){
+            chara_hurt.play();
+            ghost_sound.play();
         }
-        if(this->stopUp == true && dy < 0){
-            dy = 0;
-        }
-        if(this->stopDown == true && dy > 0){
-            dy = 0;
+        else{
+            chara_death.play();
         }
-        this->move(dx, dy);
-    };
-    if(invul == true && isStarted == false){
-        this->clock.restart();
-        isStarted = true;
     }
+    health = p.health;
+    if(p.attacking > swingLeft)
+        this->attack();
+    swingLeft = p.attacking;
 
-    // std::cout << (int) clock.getElapsedTime().asSeconds() << std::endl;
-    if(this->clock.getElapsedTime().asSeconds() >= 3 && this->invul == true){
-        std::cout << "invul removed" << std::endl;
-        this->invul = false;
-        isStarted = false;
+    // what the HUD shows: the clue being read, or else the one in reach
+    int reachable = match->clueAt(seat);
+    readClue = p.reading >= 0;
+    atClue = reachable >= 0;
+    this->currentClue = entity_group->getClue(readClue ? p.reading : reachable);
 
-    }
+    // a rollback (see GameScreen::canRollback) can take a death back
+    if(!this->isAlive && health > 0)
+        this->isAlive = true;
     if(this->isAlive && health <= 0){
         curr = &death_animation;
         this->isAlive = false;
         auto e = std::make_shared< Event<bool> >("true");
         Events::queueEvent("player_died", e);
     }
+    if(this->isAlive)
+        this->face(p.facing);
 
     this->z_index = this->getPosition().y;
 
     this->checkCollisions();
+    this->animate(from, dt);
+}
 
+void Character::animate(sf::Vector2f from, float dt)
+{
     // if we're not moving don't animate anything
-    if(dx == 0 && dy == 0){
+    if(this->getPosition() == from){
         curr->stop();
     }else{
         curr->play();
@@ -334,11 +210,11 @@ void Character::onUpdate(float dt)
 void Character::checkCollisions()
 {
     this->hbox.setColor(sf::Color::Yellow);
-    std::vector<std::shared_ptr<Character>> entities = entity_group->getCharacters();
+    const std::vector<Character*>& entities = entity_group->getNeighbours(*this);
     // // check proximity to other entities or whatever
     for(auto it = entities.begin(); it != entities.end(); it++){
-        std::shared_ptr<Character> c = *it;
-        if(c.get() == this)
+        Character* c = *it;
+        if(c == this)
             continue;
         if(this->hbox.intersects(c->hbox)){
             this->hbox.setColor(sf::Color::Red);
@@ -346,20 +222,6 @@ void Character::checkCollisions()
     }
 }
 
-void Character::hurt(){
-    this->health--;
-    this->invul = true;
-    if(health > 0){
-        chara_hurt.play();
-        ghost_sound.play();
-    }
-    else{
-        std::cout << "should play death" << std::endl;
-
-        chara_death.play();
-    }
-}
-
 void Character::attack(){
     if(!(this->isAttacking)){
         this->isAttacking = true;
@@ -368,13 +230,47 @@ void Character::attack(){
             attack_anim.stop();
             this->isAttacking = false;
         });
-        this->checkVillain();
     }
 }
 
 /**
 * Draws the characters
 */
+void Character::snapshot(EntitySnapshot& s) const
+{
+    s.box = hbox;
+    s.previous = getPreviousPosition();
+    s.current = getPosition();
+    s.drawKey = getDrawKey();
+    s.sprites.clear();
+    // same order as onDraw
+    if(isAttacking)
+        s.sprites.push_back(attack_anim.snapshot(getTransform()));
+    if(curr)
+        s.sprites.push_back(curr->snapshot(getTransform()));
+}
+
+std::size_t Character::getDrawKey() const
+{
+    std::hash<float> h;
+    std::size_t key = h(getPosition().x);
+    key = key * 31 + h(getPosition().y);
+    key = key * 31 + std::hash<const void*>()(curr);
+    if(curr){
+        const sf::IntRect& frame = curr->getFrameRect();
+        key = key * 31 + frame.left;
+        key = key * 31 + frame.top;
+        key = key * 31 + h(curr->getPosition().x);
+        key = key * 31 + h(curr->getPosition().y);
+    }
+    if(isAttacking){
+        const sf::IntRect& frame = attack_anim.getFrameRect();
+        key = key * 31 + frame.left + 1;
+        key = key * 31 + frame.top;
+    }
+    return key;
+}
+
 void Character::onDraw(sf::RenderTarget& target, sf::RenderStates states) const
 {
     if(isAttacking)
@@ -384,129 +280,3 @@ void Character::onDraw(sf::RenderTarget& target, sf::RenderStates states) const
     // draw the hitbox
     target.draw(hbox);
 }
-
-void Character::onGamepadEvent(GamepadEvent e)
-{
-    if(health > 0){
-        switch(e.type){
-            case GamepadEvent::TYPE::RELEASED:
-                // in c++ you can't switch/case a string
-                if((e.button == "UP") || (e.button == "DOWN"))
-                    this->direction.y = 0;
-                else if((e.button == "LEFT") || (e.button == "RIGHT"))
-                    this->direction.x = 0;
-                else if(e.button == "X"){
-                    if(character == Config::CHARACTER::BRO){
-                        // stop running
-                        this->speed /= 2;
-                    }
-                }
-                if(this->direction.y <= -1) {
-                    curr = &walk_up;
-                }
-                if(this->direction.y >= 1) {
-                    curr = &walk_down;
-                }
-                if(this->direction.x <= -1) {
-                    curr = &walk_left;
-                }
-                if(this->direction.x >= 1) {
-                    curr = &walk_right;
-                }
-                if(e.button=="A"){
-                    if(readClue == true){
-                        if(this->currentClue != NULL){
-                            readClue = false; // open clue
-                            this->currentClue->close();
-                        }
-                    }
-                }
-                break;
-            case GamepadEvent::TYPE::PRESSED:
-                if(e.button == "UP"){
-                    // check if a y velocity
-                    curr = &walk_up;
-                    if(stopUp == false){
-                        attack_anim.setRotation(-90);
-                        attack_anim.setPosition(0, 16);
-                        this->direction.y = -1;
-                    }
-                    else{
-                        this->direction.y = 0;
-                    }
-
-                }
-                if(e.button == "DOWN"){
-                    curr = &walk_down;
-                    if(stopDown == false){
-                        attack_anim.setRotation(90);
-                        attack_anim.setPosition(32, 16);
-                        this->direction.y = 1;
-                    }
-                    else{
-                        this->direction.y = 0;
-                    }
-                }
-                if(e.button == "LEFT"){
-                    curr = &walk_left;
-                    if(stopLeft == false){
-                        attack_anim.setRotation(180);
-                        attack_anim.setPosition(16, 32);
-                        this->direction.x = -1;
-                    }
-                    else{
-                        this->direction.x = 0;
-                    }
-                }
-                if(e.button == "RIGHT"){
-                    curr = &walk_right;
-                    if(stopRight == false){
-                        attack_anim.setRotation(0);
-                        attack_anim.setPosition(16, 0);
-                        this->direction.x = 1;
-                    }
-                    else{
-                        this->direction.x = 0;
-                    }
-                }
-                if(e.button == "Y"){
-                    this->health = 0;
-                }
-                if(e.button == "B"){
-                    this->attack();
-                }
-
-                if(e.button == "X"){ // run
-                    if(character == Config::CHARACTER::BRO){
-                        this->speed *= 2;
-                    }
-                }
-
-                if(e.button == "A"){ // perform an action
-                    std::cout << this->currentClue << std::endl;
-                    if(readClue == false){
-                        if(this->currentClue != NULL){
-                            readClue = true; // open clue
-                            this->currentClue->open();
-                            if(this->currentClue->setClue == this->currentClue->clueJackpot && hasItem == false &&
-                            this->currentClue->activatedItem == false){
-                                if(this->currentClue->highLow == 1){
-                                    itemDamage = 5;
-                                    hasItem = true;
-                                }
-                                else{
-                                    itemDamage = 3;
-                                    hasItem = true;
-                                }
-                                std:: cout << "item damage: ";
-                                std::cout << itemDamage << std::endl;
-                            }
-                        }
-                    }
-
-                }
-
-                break;
-        }
-    }
-}
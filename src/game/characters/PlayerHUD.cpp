@@ -0,0 +1,109 @@
+#include "game/characters/PlayerHUD.hpp"
+#include "game/characters/Character.hpp"
+#include "game/objects/Clue.hpp"
+#include "engine/ItemDatabase.hpp"
+#include <iostream>
+
+namespace
+{
+    const char* CLUE_FONT = "../resources/fonts/Underdog-Regular.ttf";
+    const unsigned int CLUE_SIZE = 24;
+}
+
+void PlayerHUD::init(sf::Vector2f size)
+{
+    this->size = size;
+    heartTexture = ResourceManager::getTexture("../resources/sprites/heart.png");
+    hearts.setPrimitiveType(sf::Quads);
+    cluePopup.setPrimitiveType(sf::Quads);
+    atlas = &GlyphAtlas::get(CLUE_FONT, CLUE_SIZE, true);
+
+    health = maxHealth = -1;
+    showClue = false;
+    clue.clear();
+    cluePopup.clear();
+}
+
+void PlayerHUD::prepareClues()
+{
+    GlyphAtlas& atlas = GlyphAtlas::get(CLUE_FONT, CLUE_SIZE, true);
+    std::shared_ptr<const ItemDatabase> db = ItemDatabase::compiled();
+    for(int tier = 0; tier < ItemDatabase::TIER_COUNT; tier++){
+        for(int i = 0; i < db->getItemCount(ItemDatabase::TIER(tier)); i++){
+            const ItemRecord& item = db->getItem(ItemDatabase::TIER(tier), i);
+            for(int c = 0; c < ItemDatabase::CLUE_COUNT; c++)
+                atlas.prepare(item.clues[c]);
+        }
+    }
+    std::cout << "Prepared " << atlas.getShapedCount() << " clue strings" << std::endl;
+}
+
+void PlayerHUD::capture(const Character& c, State& state)
+{
+    state.health = c.health;
+    state.maxHealth = c.maxHealth;
+    state.showClue = c.readClue && c.atClue;
+    if(state.showClue && c.currentClue != NULL)
+        state.clue = c.currentClue->setClue;
+    else
+        state.clue.clear();
+}
+
+bool PlayerHUD::update(const State& state)
+{
+    bool changed = false;
+    if(state.health != health || state.maxHealth != maxHealth){
+        buildHearts(state.health, state.maxHealth);
+        changed = true;
+    }
+    if(state.showClue != showClue || state.clue != clue){
+        showClue = state.showClue;
+        buildClue(state.clue);
+        changed = true;
+    }
+    if(changed)
+        rebuilds++;
+    return changed;
+}
+
+unsigned int PlayerHUD::takeRebuilds()
+{
+    unsigned int r = rebuilds;
+    rebuilds = 0;
+    return r;
+}
+
+void PlayerHUD::buildHearts(int health, int maxHealth)
+{
+    this->health = health;
+    this->maxHealth = maxHealth;
+    hearts.clear();
+    // 300x300 frames in the sheet (full, then empty at 600) drawn at a tenth
+    for(int i = 0; i < maxHealth; i++){
+        float u = health > i ? 0 : 600;
+        sf::Vector2f p(i * 30, 0);
+        hearts.append(sf::Vertex(p, sf::Vector2f(u, 0)));
+        hearts.append(sf::Vertex(p + sf::Vector2f(30, 0), sf::Vector2f(u + 300, 0)));
+        hearts.append(sf::Vertex(p + sf::Vector2f(30, 30), sf::Vector2f(u + 300, 300)));
+        hearts.append(sf::Vertex(p + sf::Vector2f(0, 30), sf::Vector2f(u, 300)));
+    }
+}
+
+void PlayerHUD::buildClue(const std::string& clue)
+{
+    this->clue = clue;
+    cluePopup.clear();
+    // background box, then the (already laid out) text on top of it
+    atlas->fill(sf::FloatRect(20, size.y - 60, size.x - 40, 40), sf::Color::Black, cluePopup);
+    atlas->shape(clue, sf::Vector2f(30, size.y - 55), sf::Color::White, cluePopup);
+}
+
+void PlayerHUD::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    states.texture = heartTexture;
+    target.draw(hearts, states);
+    if(showClue){
+        states.texture = &atlas->getTexture();
+        target.draw(cluePopup, states);
+    }
+}
@@ -2,69 +2,57 @@
 #include <iostream>
 #include "game/characters/PlayerView.hpp"
 
+PlayerView::~PlayerView()
+{
+    // the fade writes into painAlpha
+    if(tweens)
+        tweens->cancel(painFade);
+}
+
 void PlayerView::init()
 {
-    if (!sf::Shader::isAvailable())
-	{
-		std::cout << "Shaders are not available on this machine." << std::endl;
-    }else{
-        // lighting.setPosition(0, 0);
-        lighting.setFillColor(sf::Color(0,0,0,0));
-        if(shader.loadFromFile("../resources/shaders/VertexShader.txt", "../resources/shaders/GradientShader.txt"))
-        {
-            lighting.setFillColor(sf::Color::Black);
-            std::cout << "Position : " << lighting.getPosition().x << " " << lighting.getPosition().y;
-            std::cout << ", Dimensions : "  << lighting.getSize().x << " " << lighting.getSize().y;
-            std::cout << ", Viewport : " << viewport_x << " " << viewport_y  << std::endl;;
-            shader.setUniform("windowHeight", lighting.getSize().y);
-            // Hack
-            if(numPlayers >= 3)
-                shader.setUniform("center", sf::Vector2f(
-                    viewport_x + lighting.getSize().x / 2.0f, 
-                    viewport_y - lighting.getSize().y / 2.0f));
-            else 
-                shader.setUniform("center", sf::Vector2f(
-                    viewport_x + lighting.getSize().x / 2.0f, 
-                    lighting.getSize().y / 2.0f));
-            shader.setUniform("radius", std::min(lighting.getSize().y, lighting.getSize().x) / 2.2f);
-            shader.setUniform("expand", 0.0f);
-        }
-    }
-    
     itemBar.setSize(sf::Vector2f(20, 20));
     itemBar.setOutlineColor(sf::Color::White);
     itemBar.setFillColor(sf::Color::Transparent);
     itemBar.setOutlineThickness(2);
     //pain.setFillColor(sf::Color::Red);
-    painCount = 100;
-    pain.setFillColor(sf::Color(255, 0, 0, painCount));
-
-    heartTexture = *ResourceManager::getTexture("../resources/sprites/heart.png");
-
-    // setup event listeners (lazy method)
-    Events::addEventListener("gamepad_event", [=](base_event_type e){
-        // We'll need to delete this listener in the destructor or we'll have segfaults/undefined behavior eventually
-        // Cast to gamepad event
-        auto gpe = dynamic_cast< GamepadEvent& >(*e);
-        // Check that the index matches our player
-        if(gpe.index == entity_group->getCharacter(playernumber)->getGamepadIndex()){
-            // Call our listener function personally
-            entity_group->getCharacter(playernumber)->onGamepadEvent(gpe);
-        }
-    });
+    painAlpha = 100;
 
+    hud.init(sf::Vector2f(viewDimensions.width, viewDimensions.height));
+    // the player's gamepad goes to the match, not through here (see
+    // GameplayScreen::onUpdate)
 }
 
 void PlayerView::onUpdate(float dt)
 {
-    v.setCenter(entity_group->getCharacter(playernumber)->getPosition());
     bool invul = entity_group->getCharacter(playernumber)->invul;
-    if(invul && painCount > 0){
-        pain.setFillColor(sf::Color(255, 0, 0, painCount));
-        painCount--;
+    // a rollback's ticks run again don't flash the pain a second time
+    if(replaying){
+        wasInvul = invul;
+        return;
+    }
+    if(invul && !wasInvul && tweens){
+        // fade out over 100 ticks, like the old once-per-frame counter did
+        tweens->cancel(painFade);
+        painFade = tweens->add(&painAlpha, interpolate::LINEAR, 100, 0, 100 / 60.0f);
     }
-    else if(!invul)
-       painCount = 100;
+    else if(!invul && wasInvul){
+        if(tweens)
+            tweens->cancel(painFade);
+        painAlpha = 100;
+    }
+    wasInvul = invul;
+}
+
+void PlayerView::snapshot(Snapshot& s) const
+{
+    std::shared_ptr<Character> c = entity_group->getCharacter(playernumber);
+    s.from = c->getPreviousPosition();
+    s.to = c->getPosition();
+    s.room = rooms ? rooms->getRoomInside(c->hbox) : NULL;
+    s.invul = c->invul;
+    s.painAlpha = painAlpha;
+    PlayerHUD::capture(*c, s.hud);
 }
 
 void PlayerView::setView(sf::FloatRect dimensions, sf::FloatRect viewport)
@@ -76,80 +64,105 @@ void PlayerView::setView(sf::FloatRect dimensions, sf::FloatRect viewport)
     HUD.setViewport(viewport);
     itemBar.setPosition(viewport.left + dimensions.width - 40, viewport.top + dimensions.height - 40);
     pain.setSize(sf::Vector2f(dimensions.width, dimensions.height));
-    lighting.setPosition(0, 0);
-    viewport_x = 720 * viewport.left; 
-    viewport_y = 480 * viewport.top;
-    lighting.setSize({dimensions.width, dimensions.height});
+    redraw = true;
 }
 
-void PlayerView::onDraw(sf::RenderTarget& target, sf::RenderStates states) const
+std::size_t PlayerView::getDrawKey(const Snapshot& s, const std::vector<EntitySnapshot>& entities) const
 {
-    // draw the current view
-    target.setView(v);
-
-    //
-    if(rooms){
-        Room* room = rooms->getRoomInside(entity_group->getCharacter(playernumber)->hbox);
-        // Now this just draws the doors lol
-        if(NULL != room){
-            target.draw(*room);
-            target.draw(*rooms);
-            // draw the entities in the current room
-            if(entity_group){
-                entity_group->drawInArea(target, room->hbox);
-            }
+    std::hash<float> h;
+    std::size_t key = h(v.getCenter().x);
+    key = key * 31 + h(v.getCenter().y);
+    key = key * 31 + std::hash<const void*>()(s.room);
+    if(s.room){
+        for(auto it = entities.begin(); it != entities.end(); it++){
+            if(!it->box.intersects(s.room->hbox))
+                continue;
+            sf::Vector2f p = it->getRenderPosition();
+            key = key * 1099511628211ULL + it->drawKey;
+            key = key * 31 + h(p.x);
+            key = key * 31 + h(p.y);
         }
     }
-    // draw the HUD
-    target.setView(HUD);
-    target.draw(lighting, &shader);
-    // target.draw(itemBar);
-    if(entity_group->getCharacter(playernumber)->invul == true){
-        // pain.setFillColor(sf::Color(255, 0, 0, painCount));
-        // painCount--;
-        target.draw(pain);
-    }
-    // std::cout << entity_group->getCharacter(playernumber)->maxHealth << std::endl;
-    for(int i = 0; i < entity_group->getCharacter(playernumber)->maxHealth; i++){
-        sf::Sprite heart;
-        heart.setTexture(heartTexture);
-        if(entity_group->getCharacter(playernumber)->health > i){
-            heart.setTextureRect(sf::IntRect(0, 0, 300, 300));
-        }
-        else{
-            heart.setTextureRect(sf::IntRect(600, 0, 300, 300));
+    return key;
+}
+
+int PlayerView::drawWorld(sf::RenderTarget& target, const Snapshot& s,
+                          const std::vector<EntitySnapshot>& entities) const
+{
+    follow(s);
+    target.setView(v);
+    int draws = 0;
+    if(rooms && s.room){
+        target.draw(*s.room);
+        // only the doors this view can see
+        draws += 1 + rooms->drawDoorsInArea(target, getVisibleArea());
+        // draw the entities in the current room
+        for(auto it = entities.begin(); it != entities.end(); it++){
+            if(it->box.intersects(s.room->hbox)){
+                it->draw(target);
+                draws++;
+            }
         }
-        heart.scale(sf::Vector2f(0.1, 0.1));
-        heart.setPosition(i * 30, 0);
-        target.draw(heart);
     }
+    return draws;
+}
 
-    // draw a clue
-    if(entity_group->getCharacter(playernumber)->readClue == true && entity_group->getCharacter(playernumber)->atClue == true){
-        // background box
-        sf::RectangleShape bgBox;
-        sf::Vector2f v(viewDimensions.width - 40, 40);
-        bgBox.setSize(v);
-        bgBox.setFillColor(sf::Color::Black);
-        bgBox.setPosition(20, viewDimensions.height - 60);
+void PlayerView::follow(const Snapshot& s) const
+{
+    v.setCenter(GameObject::interpolate(s.from, s.to));
+}
 
-        // text
-        std::string t;
-        if(entity_group->getCharacter(playernumber)->currentClue != NULL){
-            t = entity_group->getCharacter(playernumber)->currentClue->setClue;
-        }
+bool PlayerView::renderWorld(sf::RenderTarget& target, const Snapshot& s,
+                             const std::vector<EntitySnapshot>& entities) const
+{
+    stats.frames++;
+    follow(s);
+    std::size_t key = getDrawKey(s, entities);
+    if(!redraw && key == lastKey)
+        return false;
+    redraw = false;
+    lastKey = key;
 
-        sf::Text clueText;
-        clueText.setFont(*ResourceManager::getFont("../resources/fonts/Underdog-Regular.ttf"));
-        if(t != ""){
-            clueText.setString(t);
-        }
-        clueText.setCharacterSize(24);
-        clueText.setColor(sf::Color::White);
-        clueText.setStyle(sf::Text::Bold);
-        clueText.setPosition(30, viewDimensions.height - 55);
+    target.setActive(true);
+    gpuTimer.begin();
+    // the layer keeps last frame's picture, so wipe our part of it first
+    target.setView(v);
+    sf::RectangleShape background(v.getSize());
+    background.setPosition(v.getCenter() - v.getSize() / 2.0f);
+    background.setFillColor(sf::Color::Black);
+    target.draw(background);
+    int draws = 1 + drawWorld(target, s, entities);
+    gpuTimer.end();
+    // queries belong to the layer's context, so read them while it's active
+    float gpuMs = gpuTimer.getMilliseconds();
+    if(gpuMs >= 0)
+        stats.gpuMs = gpuMs;
 
-        target.draw(bgBox);
-        target.draw(clueText);
+    stats.renders++;
+    stats.draws += draws;
+    return true;
+}
+
+PlayerView::RenderStats PlayerView::takeStats()
+{
+    RenderStats s = stats;
+    s.hudRebuilds = hud.takeRebuilds();
+    stats = RenderStats();
+    return s;
+}
+
+sf::FloatRect PlayerView::getVisibleArea() const
+{
+    return sf::FloatRect(v.getCenter() - v.getSize() / 2.0f, v.getSize());
+}
+
+void PlayerView::drawHUD(sf::RenderTarget& target, const Snapshot& s) const
+{
+    target.setView(HUD);
+    if(s.invul){
+        pain.setFillColor(sf::Color(255, 0, 0, s.painAlpha));
+        target.draw(pain);
     }
+    hud.update(s.hud);
+    target.draw(hud);
 }
@@ -6,18 +6,44 @@
 
 void Clue::init()
 {
-    SelectStream(1); // used for random
-    int rand = Equilikely(0, 2); //lower and upper bound
     this->setPosition(xPos, yPos);
 
     hbox = Hitbox(xPos, yPos, width, height); // x y w h
     hbox.follow(this);
     hbox.init();
     this->hbox.setColor(sf::Color::Yellow);
+    // in front of anyone whose feet are above the furniture's top edge
+    z_index = yPos;
 
     isOpen = false;
 }
 
+void Clue::setFurniture(const Room& room)
+{
+    const sf::Texture* texture = room.room_sprite.getTexture();
+    if(!texture)
+        return;
+    sf::Vector2f corner = room.rect.getPosition();
+    sprite.setTexture(*texture);
+    sprite.setTextureRect(sf::IntRect(xPos - corner.x, yPos - corner.y, width, height));
+}
+
+void Clue::snapshot(EntitySnapshot& s) const
+{
+    s.box = hbox;
+    s.previous = getPosition();
+    s.current = getPosition();
+    // furniture never changes
+    s.drawKey = static_cast<std::size_t>(clue_number) + 1;
+    s.sprites.clear();
+    if(sprite.getTexture()){
+        SpriteSnapshot furniture;
+        furniture.sprite = sprite;
+        furniture.transform = getTransform();
+        s.sprites.push_back(furniture);
+    }
+}
+
 void Clue::setCoordinates(int x, int y, int w, int h){
     this->xPos = x;
     this->yPos = y;
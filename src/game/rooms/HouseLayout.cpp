@@ -0,0 +1,139 @@
+#include "game/rooms/HouseLayout.hpp"
+#include <cmath>
+
+namespace
+{
+    // rooms overlap by their walls
+    const int STEP_X = HouseLayout::ROOM_W - 64;
+    const int STEP_Y = HouseLayout::ROOM_H - 90;
+}
+
+void HouseLayout::generate(int count, RandomStream& rng)
+{
+    rooms.clear();
+    doors.clear();
+    // 1 is a room, 0 is somewhere one could go next to a room
+    int grid[GRID][GRID];
+    for(int i = 0; i < GRID; i++)
+        for(int j = 0; j < GRID; j++)
+            grid[i][j] = -1;
+    int cx = (GRID - 1) / 2,
+        cy = (GRID - 1) / 2;
+    grid[cx][cy]   = 1;
+    grid[cx-1][cy] = 0;
+    grid[cx+1][cy] = 0;
+    grid[cx][cy-1] = 0;
+    grid[cx][cy+1] = 0;
+    int generated = 1;
+    while(generated != count){
+        int x = rng.equilikely(0, GRID - 1);
+        int y = rng.equilikely(0, GRID - 1);
+        if(grid[x][y] != 0)
+            continue;
+        grid[x][y] = 1;
+        if(x != 0 && grid[x-1][y] != 1){ grid[x-1][y] = 0; }
+        if(x != GRID - 1 && grid[x+1][y] != 1){ grid[x+1][y] = 0; }
+        if(y != 0 && grid[x][y-1] != 1){ grid[x][y-1] = 0; }
+        if(y != GRID - 1 && grid[x][y+1] != 1){ grid[x][y+1] = 0; }
+        generated++;
+    }
+    std::vector<Room> made;
+    for(int i = 0; i < GRID; i++){
+        for(int j = 0; j < GRID; j++){
+            if(grid[i][j] != 1)
+                continue;
+            Room r;
+            r.gridX = i;
+            r.gridY = j;
+            // rolled as each room is made, in this order
+            r.type = rng.equilikely(1, 12);
+            made.push_back(r);
+        }
+    }
+    build(made);
+}
+
+void HouseLayout::build(const std::vector<Room>& placed)
+{
+    rooms.clear();
+    doors.clear();
+    cells.assign(GRID * GRID, -1);
+    for(auto it = placed.begin(); it != placed.end(); it++){
+        Room r = *it;
+        r.area = sf::FloatRect(STEP_X * r.gridX, STEP_Y * r.gridY, ROOM_W, ROOM_H);
+        r.floor = sf::FloatRect(r.area.left + 32, r.area.top + 64, ROOM_W - 64, ROOM_H - 96);
+        for(int s = 0; s < 4; s++)
+            r.next[s] = -1;
+        cells[r.gridX * GRID + r.gridY] = static_cast<int>(rooms.size());
+        rooms.push_back(r);
+    }
+    for(std::size_t n = 0; n < rooms.size(); n++){
+        Room& r = rooms[n];
+        int right = r.gridX + 1 < GRID ? cells[(r.gridX + 1) * GRID + r.gridY] : -1;
+        int down = r.gridY + 1 < GRID ? cells[r.gridX * GRID + r.gridY + 1] : -1;
+        if(right >= 0){
+            Door d;
+            d.floor = sf::FloatRect(r.area.left + ROOM_W - DOOR, r.area.top + ROOM_H / 2 - DOOR / 2, DOOR, DOOR);
+            d.bottom = false;
+            d.from = static_cast<int>(n);
+            d.to = right;
+            doors.push_back(d);
+            r.next[RIGHT] = right;
+            rooms[right].next[LEFT] = static_cast<int>(n);
+        }
+        if(down >= 0){
+            Door d;
+            d.floor = sf::FloatRect(r.area.left + ROOM_W / 2 - DOOR / 2, r.area.top + ROOM_H - DOOR, DOOR, DOOR);
+            d.bottom = true;
+            d.from = static_cast<int>(n);
+            d.to = down;
+            doors.push_back(d);
+            r.next[DOWN] = down;
+            rooms[down].next[UP] = static_cast<int>(n);
+        }
+    }
+}
+
+bool HouseLayout::contains(const sf::FloatRect& outer, const sf::FloatRect& box)
+{
+    return box.top >= outer.top && box.top + box.height <= outer.top + outer.height &&
+           box.left >= outer.left && box.left + box.width <= outer.left + outer.width;
+}
+
+bool HouseLayout::isInside(const sf::FloatRect& box) const
+{
+    if(roomAt(box) >= 0)
+        return true;
+    for(auto it = doors.begin(); it != doors.end(); it++)
+        if(contains(it->floor, box))
+            return true;
+    return false;
+}
+
+int HouseLayout::roomAt(const sf::FloatRect& box) const
+{
+    int r = roomAt(sf::Vector2f(box.left, box.top));
+    return r >= 0 && contains(rooms[r].floor, box) ? r : -1;
+}
+
+int HouseLayout::roomAt(sf::Vector2f point) const
+{
+    // floors don't overlap, so only one cell can hold it
+    int i = static_cast<int>(std::floor((point.x - 32) / STEP_X));
+    int j = static_cast<int>(std::floor((point.y - 64) / STEP_Y));
+    if(i < 0 || j < 0 || i >= GRID || j >= GRID || cells.empty())
+        return -1;
+    int r = cells[i * GRID + j];
+    if(r < 0)
+        return -1;
+    const sf::FloatRect& f = rooms[r].floor;
+    bool in = point.x >= f.left && point.x <= f.left + f.width &&
+              point.y >= f.top && point.y <= f.top + f.height;
+    return in ? r : -1;
+}
+
+sf::Vector2f HouseLayout::getCentre(int room) const
+{
+    const sf::FloatRect& f = rooms[room].floor;
+    return sf::Vector2f(f.left + f.width / 2, f.top + f.height / 2);
+}
@@ -1,6 +1,7 @@
 #include <vector>
 #include <iostream>
 #include "game/rooms/Room.hpp"
+#include "game/rooms/RoomTypes.hpp"
 
 void Room::init()
 {
@@ -36,410 +37,58 @@ void Room::init()
 void Room::setRoomType(int type)
 {
     std::cout << "Room type " << type << std::endl;
-    switch(type){
-      case 1:
-        room_setup = "armory";
-        //spears
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //hay?
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(8);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //chest
-        clueCoordinates.push_back(4);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //table
-        clueCoordinates.push_back(6);
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //bookshelf
-        clueCoordinates.push_back(11);
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //chest
-        clueCoordinates.push_back(11);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //chest
-        clueCoordinates.push_back(14);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);  
-      break;
-      case 2:
-        room_setup = "throne";
-        //queen
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-        //pedestal
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(5);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-        //column
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //column
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(8);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(3);
-        //column
-        clueCoordinates.push_back(13);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //column
-        clueCoordinates.push_back(13);
-        clueCoordinates.push_back(8);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(3);
-      break;
-      case 3:
-        room_setup = "grave";
-        //stump
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-        //columnleafy
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(3);
-        //column
-        clueCoordinates.push_back(11);
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(3);
-        //grave
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(5);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //rock
-        clueCoordinates.push_back(12);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-      break;
-      case 4:
-        room_setup = "parlor";
-        //chest
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //dresser
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(1 );
-        //table
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(3);
-        //plant1
-        clueCoordinates.push_back(6);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //plant2
-        clueCoordinates.push_back(9);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //plant3
-        clueCoordinates.push_back(6);
-        clueCoordinates.push_back(9);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //plant4
-        clueCoordinates.push_back(9);
-        clueCoordinates.push_back(9);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //couch
-        clueCoordinates.push_back(11);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-        //piano
-        clueCoordinates.push_back(11);
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(3);
-      break;
-      case 5:
-        room_setup = "lounge";
-        //candle
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //fireplace
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(1);
-        //couch
-        clueCoordinates.push_back(8);
-        clueCoordinates.push_back(5);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-        //table
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(4);
-        clueCoordinates.push_back(2);
-        //china
-        clueCoordinates.push_back(11);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(1);
-      break;
-      case 6:
-        room_setup = "kitchen";
-        //furniture
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(5);
-        clueCoordinates.push_back(1);
-        //tablechairs
-        clueCoordinates.push_back(6);
-        clueCoordinates.push_back(5);
-        clueCoordinates.push_back(5);
-        clueCoordinates.push_back(2);
-        //kitchenstoveshit
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(11);
-        clueCoordinates.push_back(4);
-        clueCoordinates.push_back(1); 
-      break;
-      case 7:
-        room_setup = "lion";
-        //vase
-        clueCoordinates.push_back(5);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //chair
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //lion
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(4);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(3);
-        //clock
-        clueCoordinates.push_back(13);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-      break;
-      case 8:
-        room_setup = "barrels";
-        //barrels
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(1);
-        //chairleft
-        clueCoordinates.push_back(5);
-        clueCoordinates.push_back(5);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //table
-        clueCoordinates.push_back(6);
-        clueCoordinates.push_back(4);
-        clueCoordinates.push_back(4);
-        clueCoordinates.push_back(4);
-        //chairright
-        clueCoordinates.push_back(10);
-        clueCoordinates.push_back(5);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //candle1
-        clueCoordinates.push_back(6);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //candle2
-        clueCoordinates.push_back(9);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-      break;
-      case 9:
-        room_setup = "dungeon";
-        //torch1
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(4);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //torch2
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //torch3
-        clueCoordinates.push_back(14);
-        clueCoordinates.push_back(4);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //torch4
-        clueCoordinates.push_back(14);
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //chest
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //cauldron
-        clueCoordinates.push_back(5);
-        clueCoordinates.push_back(5);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //bones
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(10);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //tablechair
-        clueCoordinates.push_back(9);
-        clueCoordinates.push_back(6);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(1);
-        //water
-        clueCoordinates.push_back(9);
-        clueCoordinates.push_back(10);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //bed
-        clueCoordinates.push_back(10);
-        clueCoordinates.push_back(9);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(2);
-      break;
-      case 10:
-        room_setup = "bedroom";
-        //chest
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(8);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //dresser1
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(1);
-        //dresser2
-        clueCoordinates.push_back(10);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(4);
-        clueCoordinates.push_back(1);
-        //bed
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(5);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(3);
-        //endtable
-        clueCoordinates.push_back(10);
-        clueCoordinates.push_back(6);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //clock
-        clueCoordinates.push_back(13);
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(3);
-      break;
-      case 11:
-        room_setup = "wood_bedroom";
-        //table
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(3);
-        //clock
-        clueCoordinates.push_back(5);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //chair
-        clueCoordinates.push_back(10);
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-        //lamp
-        clueCoordinates.push_back(10);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-        //bed
-        clueCoordinates.push_back(11);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-        clueCoordinates.push_back(2);
-      break;
-      case 12:
-        room_setup = "bathroom";
-        //candle1
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //candle2
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //candle3
-        clueCoordinates.push_back(14);
-        clueCoordinates.push_back(3);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //candle4
-        clueCoordinates.push_back(14);
-        clueCoordinates.push_back(7);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(2);
-        //water
-        clueCoordinates.push_back(4);
-        clueCoordinates.push_back(4);
-        clueCoordinates.push_back(8);
-        clueCoordinates.push_back(5);
-        //pail
-        clueCoordinates.push_back(12);
-        clueCoordinates.push_back(5);
-        clueCoordinates.push_back(1);
-        clueCoordinates.push_back(1);
-
-      break;
+    room_type = type;
+    const RoomType& t = RoomType::get(type);
+    room_setup = t.name;
+    for(int i = 0; i < t.furnitureCount; i++){
+        const RoomType::Furniture& f = t.furniture[i];
+        clueCoordinates.push_back(f.x);
+        clueCoordinates.push_back(f.y);
+        clueCoordinates.push_back(f.w);
+        clueCoordinates.push_back(f.h);
+        if(f.light != RoomType::NO_LIGHT)
+            addLight(LIGHT(f.light));
     }
     std::string location = "../resources/roompng/room_" + std::to_string(type) + ".png";
     // std::cout << location << std::endl;
     room_sprite.setTexture(*ResourceManager::getTexture(location));
 }
 
+void Room::addLight(LIGHT kind)
+{
+    auto it = clueCoordinates.end();
+    LightSource light;
+    light.h = *--it;
+    light.w = *--it;
+    light.y = *--it;
+    light.x = *--it;
+    light.kind = kind;
+    lights.push_back(light);
+}
+
+void Room::getLights(std::vector<Light>& out) const
+{
+    for(auto it = lights.begin(); it != lights.end(); it++){
+        // centre of the furniture, in the same tile units as the clues
+        sf::Vector2f centre = rect.getPosition() +
+            sf::Vector2f(32 * it->x + 16 * it->w, 32 * it->y + 16 * it->h);
+        switch(it->kind){
+          case CANDLE:
+            out.push_back(Light(centre, 72, sf::Color(255, 190, 110)));
+            break;
+          case TORCH:
+            out.push_back(Light(centre, 110, sf::Color(255, 150, 70)));
+            break;
+          case FIREPLACE:
+            out.push_back(Light(centre, 170, sf::Color(255, 120, 50)));
+            break;
+          case LAMP:
+            out.push_back(Light(centre, 120, sf::Color(255, 220, 160)));
+            break;
+        }
+    }
+}
+
 void Room::onDraw(sf::RenderTarget& target, sf::RenderStates states) const
 {
     // states.transform *= this->getTransform();
@@ -0,0 +1,144 @@
+#include "game/rooms/RoomTypes.hpp"
+
+namespace
+{
+    typedef RoomType::Furniture F;
+    const RoomType::LIGHT NONE = RoomType::NO_LIGHT;
+
+    const F ARMORY[] = {
+        { 1,  2, 1, 1, NONE               }, // spears
+        { 2,  8, 1, 2, NONE               }, // hay?
+        { 4,  3, 1, 1, NONE               }, // chest
+        { 6,  7, 1, 1, NONE               }, // table
+        {11,  7, 1, 2, NONE               }, // bookshelf
+        {11,  3, 1, 1, NONE               }, // chest
+        {14,  2, 1, 2, NONE               }, // chest
+    };
+
+    const F THRONE[] = {
+        { 7,  3, 2, 2, NONE               }, // queen
+        { 7,  5, 2, 2, NONE               }, // pedestal
+        { 2,  2, 1, 1, NONE               }, // column
+        { 2,  8, 1, 3, NONE               }, // column
+        {13,  2, 1, 1, NONE               }, // column
+        {13,  8, 1, 3, NONE               }, // column
+    };
+
+    const F GRAVE[] = {
+        { 1,  2, 2, 2, NONE               }, // stump
+        { 3,  7, 1, 3, NONE               }, // columnleafy
+        {11,  7, 1, 3, NONE               }, // column
+        { 7,  5, 1, 2, NONE               }, // grave
+        {12,  3, 2, 2, NONE               }, // rock
+    };
+
+    const F PARLOR[] = {
+        { 1,  3, 1, 2, NONE               }, // chest
+        { 3,  2, 2, 1, NONE               }, // dresser
+        { 2,  7, 3, 3, NONE               }, // table
+        { 6,  2, 1, 1, NONE               }, // plant1
+        { 9,  2, 1, 1, NONE               }, // plant2
+        { 6,  9, 1, 2, NONE               }, // plant3
+        { 9,  9, 1, 2, NONE               }, // plant4
+        {11,  3, 2, 2, NONE               }, // couch
+        {11,  7, 3, 3, NONE               }, // piano
+    };
+
+    const F LOUNGE[] = {
+        { 1,  7, 1, 2, RoomType::CANDLE   }, // candle
+        { 3,  2, 3, 1, RoomType::FIREPLACE}, // fireplace
+        { 8,  5, 2, 2, NONE               }, // couch
+        { 7,  7, 4, 2, NONE               }, // table
+        {11,  2, 2, 1, NONE               }, // china
+    };
+
+    const F KITCHEN[] = {
+        { 1,  2, 5, 1, NONE               }, // furniture
+        { 6,  5, 5, 2, NONE               }, // tablechairs
+        { 1, 11, 4, 1, NONE               }, // kitchenstoveshit
+    };
+
+    const F LION[] = {
+        { 5,  2, 1, 1, NONE               }, // vase
+        { 3,  3, 1, 1, NONE               }, // chair
+        { 7,  4, 2, 3, NONE               }, // lion
+        {13,  2, 1, 1, NONE               }, // clock
+    };
+
+    const F BARRELS[] = {
+        { 2,  2, 2, 1, NONE               }, // barrels
+        { 5,  5, 1, 2, NONE               }, // chairleft
+        { 6,  4, 4, 4, NONE               }, // table
+        {10,  5, 1, 2, NONE               }, // chairright
+        { 6,  2, 1, 1, RoomType::CANDLE   }, // candle1
+        { 9,  2, 1, 1, RoomType::CANDLE   }, // candle2
+    };
+
+    const F DUNGEON[] = {
+        { 1,  4, 1, 1, RoomType::TORCH    }, // torch1
+        { 1,  7, 1, 2, RoomType::TORCH    }, // torch2
+        {14,  4, 1, 1, RoomType::TORCH    }, // torch3
+        {14,  7, 1, 2, RoomType::TORCH    }, // torch4
+        { 2,  3, 1, 1, NONE               }, // chest
+        { 5,  5, 1, 1, NONE               }, // cauldron
+        { 3, 10, 1, 1, NONE               }, // bones
+        { 9,  6, 3, 1, NONE               }, // tablechair
+        { 9, 10, 1, 1, NONE               }, // water
+        {10,  9, 3, 2, NONE               }, // bed
+    };
+
+    const F BEDROOM[] = {
+        { 1,  8, 1, 2, NONE               }, // chest
+        { 2,  2, 3, 1, NONE               }, // dresser1
+        {10,  2, 4, 1, NONE               }, // dresser2
+        { 7,  5, 2, 3, NONE               }, // bed
+        {10,  6, 1, 1, NONE               }, // endtable
+        {13,  7, 1, 3, NONE               }, // clock
+    };
+
+    const F WOOD_BEDROOM[] = {
+        { 1,  7, 2, 3, NONE               }, // table
+        { 5,  2, 1, 1, NONE               }, // clock
+        {10,  7, 2, 2, NONE               }, // chair
+        {10,  2, 1, 1, RoomType::LAMP     }, // lamp
+        {11,  2, 2, 2, NONE               }, // bed
+    };
+
+    const F BATHROOM[] = {
+        { 1,  3, 1, 2, RoomType::CANDLE   }, // candle1
+        { 1,  7, 1, 2, RoomType::CANDLE   }, // candle2
+        {14,  3, 1, 2, RoomType::CANDLE   }, // candle3
+        {14,  7, 1, 2, RoomType::CANDLE   }, // candle4
+        { 4,  4, 8, 5, NONE               }, // water
+        {12,  5, 1, 1, NONE               }, // pail
+    };
+
+    template<std::size_t N>
+    int count(const F (&)[N]){ return static_cast<int>(N); }
+
+    // indexed by type - 1
+    const RoomType TYPES[] = {
+        {"armory",       160, ARMORY,       count(ARMORY)},
+        {"throne",       160, THRONE,       count(THRONE)},
+        {"grave",        128, GRAVE,        count(GRAVE)},
+        {"parlor",       128, PARLOR,       count(PARLOR)},
+        {"lounge",       160, LOUNGE,       count(LOUNGE)},
+        {"kitchen",      160, KITCHEN,      count(KITCHEN)},
+        {"lion",         160, LION,         count(LION)},
+        {"barrels",      160, BARRELS,      count(BARRELS)},
+        {"dungeon",      256, DUNGEON,      count(DUNGEON)},
+        {"bedroom",      160, BEDROOM,      count(BEDROOM)},
+        {"wood_bedroom", 128, WOOD_BEDROOM, count(WOOD_BEDROOM)},
+        {"bathroom",      96, BATHROOM,     count(BATHROOM)},
+    };
+
+    // doors, and anything HouseLayout didn't roll
+    const RoomType NOTHING = {"", 160, NULL, 0};
+}
+
+const RoomType& RoomType::get(int type)
+{
+    if(type < 1 || type > COUNT)
+        return NOTHING;
+    return TYPES[type - 1];
+}
@@ -133,25 +133,22 @@ void CharacterScreen::init()
   background.setSize(sf::Vector2f(720, 480));
   background.setFillColor(sf::Color(30, 30, 30));
 
-  teamFont.setFont(*ResourceManager::getFont("../resources/fonts/Underdog-Regular.ttf"));
+  teamFont.setAtlas(GlyphAtlas::get("../resources/fonts/Underdog-Regular.ttf", 24, true));
   teamFont.setString("MAKE YOUR TEAM");
-  teamFont.setCharacterSize(24);
-  //teamFont.setColor(sf::Color::White);
-  teamFont.setStyle(sf::Text::Bold);
   teamFont.setPosition(250, 50);
 
 
   blackness.setSize(sf::Vector2f(720, 480));
   blackness.setFillColor(sf::Color(0, 0, 0, trans));
+  fade.cancel();
+  fade = Timeline(&engine->getTweens());
+  fade.then(&trans, interpolate::LINEAR, 255, 50, FADE_IN_TIME);
 }
 
 void CharacterScreen::onUpdate(float dt)
 {
-  // title screen emerges from darkness
-  if (trans > 50) {
-    trans -= dt/60;
-    blackness.setFillColor(sf::Color(0, 0, 0, trans));
-  }
+  // title screen emerges from darkness (see init)
+  blackness.setFillColor(sf::Color(0, 0, 0, trans));
   // Set the positions of the texts
   for(auto it = char_selections.begin(); it != char_selections.end(); it++){
     (*it)->update(dt);
@@ -188,7 +185,7 @@ void CharacterScreen::onGamepadEvent(GamepadEvent e)
       int replace_index = -1;
       bool found = false;
 
-      if(e.button == "RIGHT"){
+      if(e.action == Input::RIGHT){
         int index = 0;
         for(auto it = char_selections.begin(); it != char_selections.end(); it++){
           if(!found && (*it)->hasPlayer(player)){
@@ -203,7 +200,7 @@ void CharacterScreen::onGamepadEvent(GamepadEvent e)
           index++;
         }
       }
-      else if(e.button == "LEFT"){
+      else if(e.action == Input::LEFT){
         int index = char_selections.size() - 1;
         for(auto it = char_selections.rbegin(); it != char_selections.rend(); it++){
           if(!found && (*it)->hasPlayer(player)){
@@ -219,7 +216,7 @@ void CharacterScreen::onGamepadEvent(GamepadEvent e)
         }
       }
 
-      else if(e.button == "A" || e.button == "START"){
+      else if(e.action == Input::USE || e.action == Input::START){
         chara_sound.play();
         if(selected_count == player_num){
           auto event = std::make_shared< Event<std::string> >("GamePlay");
@@ -249,7 +246,7 @@ void CharacterScreen::onGamepadEvent(GamepadEvent e)
           }
         }
       }
-      else if(e.button == "B"){
+      else if(e.action == Input::ATTACK){
         for(auto it = char_selections.begin(); it != char_selections.end(); it++){
           if((*it)->isSelected()){
             if((*it)->hasPlayer(player)){
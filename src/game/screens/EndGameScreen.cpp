@@ -2,21 +2,19 @@
 #include <iostream>
 
 void EndGameScreen::init() {
-    clock.restart();
     trans = 255;
     // Reset some things
     this->showing = false;
     this->can_leave = false;
     // Game over string
+    text.setAtlas(GlyphAtlas::get("../resources/fonts/youmurderer.ttf", 100));
     text.setString("Game Over");
-    text.setFont(*ResourceManager::getFont("../resources/fonts/youmurderer.ttf"));
-    text.setCharacterSize(100);
     sf::FloatRect pos = text.getLocalBounds();
     text.setPosition(720/2, 480/2);
     text.setOrigin(pos.left + pos.width / 2, pos.top + pos.height / 2);
     // Press any button string
+    press_any_button.setAtlas(GlyphAtlas::get("../resources/fonts/youmurderer.ttf", 30));
     press_any_button.setString("Press Any Button");
-    press_any_button.setFont(*ResourceManager::getFont("../resources/fonts/youmurderer.ttf"));
     sf::FloatRect pos2 = press_any_button.getLocalBounds();
     press_any_button.setPosition(720/2, 480/2 + pos.top + pos.height + 20);
     press_any_button.setOrigin(pos2.left + pos2.width / 2, pos2.top + pos2.height / 2);
@@ -29,17 +27,19 @@ void EndGameScreen::init() {
     over.play();
     blackness.setSize(sf::Vector2f(720, 480));
     blackness.setFillColor(sf::Color(0, 0, 0, trans));
+
+    // fade in, and let players leave once the prompt shows up
+    fade.cancel();
+    fade = Timeline(&engine->getTweens());
+    fade.then(&trans, interpolate::LINEAR, 255, 50, FADE_IN_TIME)
+        .at(delay).call([this](){
+            this->showing = true;
+            this->can_leave = true;
+        });
 }
 
 void EndGameScreen::onUpdate(float dt){
-  if (trans > 50) {
-    trans -= dt/60;
-    blackness.setFillColor(sf::Color(0, 0, 0, trans));
-  }
-  if(!showing && clock.getElapsedTime().asSeconds() >= delay){
-      showing = true;
-      can_leave = true;
-  }
+  blackness.setFillColor(sf::Color(0, 0, 0, trans));
 };
 
 void EndGameScreen::onGamepadEvent(GamepadEvent gpe){
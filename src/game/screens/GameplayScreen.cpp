@@ -1,120 +1,124 @@
 #include "game/screens/GameplayScreen.hpp"
-#include "engine/Random.hpp"
+#include "engine/RandomStream.hpp"
 #include "engine/ClueReader.hpp"
 #include "game/characters/Character.hpp"
 #include "game/characters/Villain.hpp"
 #include "game/objects/Clue.hpp"
-#include "game/objects/Clue.hpp"
+#include "game/Tuning.hpp"
 #include <iostream>
 
 void GameplayScreen::init()
 {
     hunt.setBuffer(*ResourceManager::getSoundBuffer("../resources/music/start.ogg"));
 
-    clock.restart();
+    compositor.create(config->width, config->height);
+    // one seed per match; house, spawns, villain and clues each draw from their own stream
+    unsigned long seed = config->seed ? config->seed : time(NULL);
+    // carrying on from a save: its house, its players, where they'd got to
+    MatchState resumed;
+    bool resuming = config->resume && !engine->isNetworked() && this->loadSave(resumed);
+    config->resume = false;
+    if(resuming){
+        seed = resumed.seed;
+        config->num_players = static_cast<int>(resumed.players.size());
+        for(std::size_t p = 0; p < resumed.players.size(); p++)
+            config->char_map[static_cast<int>(p) + 1] = resumed.players[p].character;
+    }
+    RandomStream::seedAll(seed);
     this->views.clear();
     entity_group = EntityGroup();
-    switch(num_players){
-        case 1:
-        group.generateRoomGrid(20);
-        break;
-        case 2:
-        group.generateRoomGrid(40);
-        break;
-        case 3:
-        group.generateRoomGrid(60);
-        break;
-        case 4:
-        group.generateRoomGrid(100);
-        break;
-    }
+    num_players = config->num_players;
+    std::vector<Config::CHARACTER> characters;
+    for(int p = 1; p <= num_players; p++)
+        characters.push_back(config->char_map[p]);
+    match = std::unique_ptr<Match>(new Match(seed, characters, Tuning::get()));
+    if(resuming && match->restore(resumed))
+        std::cout << "Carrying on from " << config->save_file << ", tick " << match->getTicks() << std::endl;
+    ended = false;
+    endedFor = 0;
+    savedStates.assign(Lockstep::MAX_AHEAD, MatchState());
+    savedTicks.assign(Lockstep::MAX_AHEAD, 0);
+    // nothing saved yet: no slot holds the tick its place stands for
+    for(std::size_t i = 0; i < savedTicks.size(); i++)
+        savedTicks[i] = static_cast<unsigned int>(i) + 1;
+    // the rooms are drawn from the house the match plays in
+    group.build(match->getLayout());
 
     this->createClues();
-    num_players = config->num_players;
+    roomLights.clear();
+    for(auto it = group.rooms.begin(); it != group.rooms.end(); it++)
+        (*it)->getLights(roomLights);
     // If we let the playerview set its own viewport
     // then we end up running the same code over and over inside PlayerView#init
     this->createViews(num_players);
+    entity_group.setRoomGroup(&group);
+    entity_group.setJobs(&engine->getJobs());
     entity_group.init();
-    // Create the ghost (this could easily be another function)
-    // this->createVillain()
-    // ghost = std::make_shared<Villain>();
-    // ghost->setPlayerNumber(-1);
-    // ghost->setRoomGroup(&group);
-    // ghost->setEntities(&entity_group);
-    // entity_group.addCharacter(std::move(ghost));
-    Events::addEventListener("player_died", [=](base_event_type e){
-      // We'll need to delete this listener in the destructor or we'll have segfaults/undefined behavior eventually
-      // Cast to gamepad event
-      if(--num_players == 0){
-        std::cout << "All players died" << std::endl;
-        auto event = std::make_shared< Event<std::string> >("GameEnd");
-        Events::clearAll("gamepad_event");
-        Events::queueEvent("change_screen", event);
-      };
-
-
+    // The ghost is made here, on the main thread, where its textures can be
+    // loaded: the tick that lets it in may be running on the FrameWorker.
+    ghost = std::make_shared<Villain>();
+    ghost->setPlayerNumber(-1);
+    ghost->setMatch(match.get(), -1);
+    ghost->setRoomGroup(&group);
+    ghost->setEntities(&entity_group);
+    ghost->init();
+    huntStarted = false;
+    // F5 and F9, seen by the window (see Input::COMMAND)
+    Events::clearAll("command");
+    Events::addEventListener("command", [=](base_event_type e){
+        auto c = dynamic_cast< Event<Input::COMMAND>& >(*e);
+        this->onCommand(c.data);
     });
     // std::cout << group.rooms.size() << std::endl;
 }
 
 void GameplayScreen::createClues()
 {
-    PlantSeeds(-1); // for random in clue reader
-    reader.readFile("../resources/items.xml");
+    reader.useCompiledItems();
     reader.selectItems();
-    // std::cout << group.rooms.size() << std::endl;
-    for(auto it = group.rooms.begin(); it != group.rooms.end(); it++){
-        std::shared_ptr<Room> r = *it;
-        // std::cout << r->room_setup << std::endl;
-        // std::cout << r->clueCoordinates.size() << std:: endl;
-        for(auto j = r->clueCoordinates.begin(); j != r->clueCoordinates.end(); j++){
-            clue = std::make_shared<Clue>();
-            clue->setRoomGroup(&group);
-            clue->setEntities(&entity_group);
-            // std::cout << "success" << std::endl;
-            hiLow = rand() % 2;
-            clue->clueJackpot = reader.getCluesJackpot()[hiLow];
-            clue->clueSpec = reader.getCluesSpec()[hiLow];
-            clue->clueVague = reader.getCluesVague()[hiLow];
-            clue->clueWorthless = reader.getCluesWorthless()[hiLow];
-            clue->highLow = hiLow;
-            int randint = rand() % 100;
-            if (randint <= 50){
+    // the match rolled every clue; this just finds the words for them
+    const std::vector<Match::Clue>& rolled = match->getClues();
+    for(std::size_t i = 0; i < rolled.size(); i++){
+        const Match::Clue& c = rolled[i];
+        clue = std::make_shared<Clue>();
+        clue->setRoomGroup(&group);
+        clue->setEntities(&entity_group);
+        clue->setClueNumber(static_cast<int>(i));
+        clue->clueJackpot = reader.getCluesJackpot()[c.highLow];
+        clue->clueSpec = reader.getCluesSpec()[c.highLow];
+        clue->clueVague = reader.getCluesVague()[c.highLow];
+        clue->clueWorthless = reader.getCluesWorthless()[c.highLow];
+        clue->highLow = c.highLow;
+        switch(c.tier){
+            case Match::WORTHLESS:
                 clue->setClue = clue->clueWorthless;
-            }
-            else if(randint <= 80){
+                break;
+            case Match::VAGUE:
                 clue->setClue = clue->clueVague;
-            }
-            else if(randint <= 95){
+                break;
+            case Match::SPECIFIC:
                 clue->setClue = clue->clueSpec;
-            }
-            else{
+                break;
+            case Match::JACKPOT:
                 clue->setClue = clue->clueJackpot;
-                clue->activatedItem = false;
-            }
-            int x = (*it)->rect.getPosition().x + (32 * (*j));
-            // std::cout << x;
-            // std::cout << " ";
-            j++;
-            int y = (*it)->rect.getPosition().y + (32 * (*j));
-            // std::cout << y;
-            // std::cout << " ";
-            j++;
-            int width = 32 * (*j);
-            // std::cout << width;
-            // std::cout << " ";
-            j++;
-            int height = 32 * (*j);
-            // std::cout << height << std::endl;
-            clue->setCoordinates(x, y, width, height);
-            clue->init();
-            entity_group.addClue(std::move(clue));
+                break;
         }
+        clue->setCoordinates(c.box.left, c.box.top, c.box.width, c.box.height);
+        clue->setFurniture(*group.getRoom(c.room));
+        clue->init();
+        entity_group.addClue(std::move(clue));
     }
-    for(int i = 0; i < reader.getCluesSpec().size(); i++){
-
-        // add clues to our clue entity group
+}
 
+void GameplayScreen::showClues()
+{
+    const std::vector<Match::Clue>& rolled = match->getClues();
+    const std::vector<std::shared_ptr<Clue>> shown = entity_group.getClues();
+    for(std::size_t i = 0; i < rolled.size() && i < shown.size(); i++){
+        if(rolled[i].open && !shown[i]->isOpen)
+            shown[i]->open();
+        else if(!rolled[i].open && shown[i]->isOpen)
+            shown[i]->close();
     }
 }
 
@@ -142,6 +146,7 @@ void GameplayScreen::createViews(int numPlayers)
 
     // Maybe turn this object into an "EntitiesGroup" obj
     std::shared_ptr<Character> character;
+    gamepads.clear();
 
     for(int i=0; i < numPlayers; i++)
     {
@@ -149,7 +154,7 @@ void GameplayScreen::createViews(int numPlayers)
         int x = i % 2;
         int y = i / 2;
         int playernum = i + 1; // Player Numbers start at 1
-        // Find the gamepad by the player number
+        // Find the gamepad by the player number, for the match to play by
         int gamepad_index = -1;
         for(auto it = config->player_map.begin(); it != config->player_map.end(); it++){
             if( it->second == playernum ){
@@ -157,11 +162,11 @@ void GameplayScreen::createViews(int numPlayers)
                 break;
             }
         }
+        gamepads.push_back(gamepad_index);
 
         view = std::unique_ptr<PlayerView>(new PlayerView());
         view->setRoomGroup(&group);
-        // Quick hack
-        view->numPlayers = numPlayers;
+        view->setTweens(&engine->getTweens());
         // Define player view (using math)
         view->setView(
             sf::FloatRect(0, 0, 720 * ratio_w, 480 * ratio_h),
@@ -171,10 +176,10 @@ void GameplayScreen::createViews(int numPlayers)
         character = std::make_shared<Character>();
         character->setRoomGroup(&group);
         character->setPlayerNumber(playernum);
+        character->setMatch(match.get(), i);
         character->setEntities(&entity_group);
         // Hope that it isn't possible for this to throw an error!
         character->setCharacter(config->char_map[playernum]);
-        character->setGamepadIndex(gamepad_index);
         // Add player to our entities map
         entity_group.addCharacter(std::move(character));
         view->setEntities(&entity_group);
@@ -188,33 +193,210 @@ void GameplayScreen::createViews(int numPlayers)
 
 void GameplayScreen::onUpdate(float dt)
 {
+    // between ticks, so nothing's halfway through reading the numbers; not
+    // in netplay, where the other machines wouldn't see the change
+    if(!engine->isNetworked()){
+        if(Tuning::update())
+            match->setRules(Tuning::get());
+    }
+    // each seat plays what its gamepad holds this tick (in netplay, what
+    // everyone's machine agreed it held)
+    for(std::size_t p = 0; p < gamepads.size(); p++){
+        const Input::State& in = engine->getInput(gamepads[p]);
+        match->setInput(static_cast<int>(p), in.down, in.move);
+    }
+    match->tick(dt);
+    this->showClues();
+    if(ghost && match->getVillain().present){
+        // the music starts in present(), on the main thread
+        huntStarted = true;
+        std::cout << "phase ends" << std::endl;
+        entity_group.addCharacter(std::move(ghost));
+    }
+
     for(auto it = views.begin(); it != views.end(); it++)
         (*it)->update(dt);
     // Update the rooms (not really necessary though)
     group.update(dt);
+    // everyone catches up with the match
     entity_group.update(dt);
 
-    // std::cout << clock.getElapsedTime().asSeconds() << std::endl;
-    if (clock.getElapsedTime().asSeconds() >= config -> time_Per_Phase) {
-        if(phase == 1){
-            hunt.play();
-
-            std::cout << "phase ends" << std::endl;
-            ghost = std::make_shared<Villain>();
-            ghost->setPlayerNumber(-1);
-            ghost->setRoomGroup(&group);
-            ghost->setEntities(&entity_group);
-            ghost->init();
-            entity_group.addCharacter(std::move(ghost));
-            phase++;
-        }
-        clock.restart();
+    if(match->getResult() != Match::PLAYING)
+        endedFor++;
+    if(endedFor > (engine->isNetworked() ? Lockstep::MAX_AHEAD : 0) && !ended){
+        ended = true;
+        std::cout << (match->getResult() == Match::PLAYERS_WON ? "The ghost is gone" : "All players died") << std::endl;
+        auto event = std::make_shared< Event<std::string> >("GameEnd");
+        Events::clearAll("gamepad_event");
+        Events::clearAll("command");
+        Events::queueEvent("change_screen", event);
+    }
+}
+
+void GameplayScreen::saveTick(unsigned int tick)
+{
+    std::size_t slot = tick % savedStates.size();
+    match->save(savedStates[slot]);
+    savedTicks[slot] = tick;
+}
+
+bool GameplayScreen::restoreTick(unsigned int tick)
+{
+    std::size_t slot = tick % savedStates.size();
+    if(savedTicks[slot] != tick){
+        std::cout << "GameplayScreen: nothing saved for tick " << tick << " to go back to" << std::endl;
+        return false;
+    }
+    if(!match->restore(savedStates[slot])){
+        std::cout << "GameplayScreen: the state saved for tick " << tick << " didn't restore" << std::endl;
+        return false;
     }
+    // the ticks run again from here catch the characters up
+    if(match->getResult() == Match::PLAYING)
+        endedFor = 0;
+    return true;
+}
+
+void GameplayScreen::onCommand(Input::COMMAND command)
+{
+    if(engine->isNetworked() || ended)
+        return;
+    switch(command){
+        case Input::QUICK_SAVE:
+            this->quickSave();
+            break;
+        case Input::QUICK_LOAD:
+            this->quickLoad();
+            break;
+        default:
+            break;
+    }
+}
+
+void GameplayScreen::quickSave()
+{
+    MatchState state;
+    match->save(state);
+    if((!saveFile.isOpen() && !saveFile.open(config->save_file)) || !saveFile.save(state)){
+        std::cout << "Couldn't save the match to " << config->save_file << std::endl;
+        return;
+    }
+    std::cout << "Saved the match at tick " << match->getTicks() << " to " << config->save_file << std::endl;
+}
+
+void GameplayScreen::quickLoad()
+{
+    MatchState state;
+    if(!this->loadSave(state)){
+        std::cout << "Nothing to load in " << config->save_file << std::endl;
+        return;
+    }
+    // the rooms and clues on screen are this match's, so only a save of
+    // this house with these players will do
+    if(state.seed != match->getSeed() || state.players.size() != gamepads.size()){
+        std::cout << config->save_file << " is from another match" << std::endl;
+        return;
+    }
+    if(!match->restore(state))
+        return;
+    // the characters and clues catch up on their next update
+    this->showClues();
+    endedFor = 0;
+    std::cout << "Loaded the match at tick " << match->getTicks() << " from " << config->save_file << std::endl;
+}
+
+bool GameplayScreen::loadSave(MatchState& state)
+{
+    if(!saveFile.isOpen() && !saveFile.open(config->save_file))
+        return false;
+    return saveFile.load(state) && state.result == Match::PLAYING;
+}
+
+void GameplayScreen::publish()
+{
+    Snapshot& s = snapshots.back();
+    // back to front, furniture included
+    const std::vector<EntityGroup::Drawn>& order = entity_group.getDrawOrder();
+    s.entities.resize(order.size());
+    for(std::size_t i = 0; i < order.size(); i++)
+        order[i].object->snapshot(s.entities[i]);
+    s.views.resize(views.size());
+    for(std::size_t i = 0; i < views.size(); i++)
+        views[i]->snapshot(s.views[i]);
+    gatherLights(s.lights);
+}
 
+void GameplayScreen::present()
+{
+    snapshots.swap();
+    if(huntStarted){
+        huntStarted = false;
+        hunt.play();
+    }
 }
 
 void GameplayScreen::onDraw(sf::RenderTarget& ctx, sf::RenderStates states) const
 {
-    for(auto it = views.begin(); it != views.end(); it++)
-        ctx.draw(**it);
+    const Snapshot& frame = snapshots.front();
+    // nothing published since init() yet
+    if(frame.views.size() != views.size())
+        return;
+    if(!compositor.isReady()){
+        for(std::size_t i = 0; i < views.size(); i++){
+            views[i]->drawWorld(ctx, frame.views[i], frame.entities);
+            views[i]->drawHUD(ctx, frame.views[i]);
+        }
+        return;
+    }
+    // views only redraw their part of the layer when something in it changed
+    compositor.clearLights();
+    for(std::size_t i = 0; i < views.size(); i++){
+        views[i]->renderWorld(compositor.getLayer(), frame.views[i], frame.entities);
+        sf::FloatRect vp = views[i]->getViewport();
+        compositor.addLights(views[i]->getCamera(), frame.lights);
+        compositor.addViewLight(vp, std::min(vp.width * config->width, vp.height * config->height) / 2.2f);
+    }
+    compositor.compose(ctx);
+    for(std::size_t i = 0; i < views.size(); i++)
+        views[i]->drawHUD(ctx, frame.views[i]);
+
+    if(engine->getDebugMode() && ++statsFrames == 600){
+        statsFrames = 0;
+        reportRenderStats();
+    }
+}
+
+void GameplayScreen::gatherLights(std::vector<Light>& lights)
+{
+    lights = roomLights;
+    // the lantern lights as much of the view as the old single light did
+    float lantern = 0;
+    if(!views.empty()){
+        sf::Vector2f size = views.front()->getCamera().getSize();
+        lantern = std::min(size.x, size.y) / 2.2f;
+    }
+    std::vector<std::shared_ptr<Character>> characters = entity_group.getCharacters();
+    for(auto it = characters.begin(); it != characters.end(); it++){
+        std::shared_ptr<Character> c = *it;
+        if(c->isVillain()){
+            if(match->getVillain().present)
+                lights.push_back(Light(c->getPosition(), 80, sf::Color(120, 220, 170)));
+        }
+        else if(c->health > 0)
+            lights.push_back(Light(c->getPosition(), lantern, sf::Color(255, 235, 200)));
+    }
+}
+
+void GameplayScreen::reportRenderStats() const
+{
+    int i = 0;
+    for(auto it = views.begin(); it != views.end(); it++, i++){
+        PlayerView::RenderStats s = (*it)->takeStats();
+        std::cout << "view " << i << ": redrew " << s.renders << "/" << s.frames << " frames, "
+                  << (s.renders ? s.draws / s.renders : 0) << " draws per redraw, "
+                  << "HUD rebuilt " << s.hudRebuilds << " times";
+        if(s.gpuMs >= 0)
+            std::cout << ", " << s.gpuMs << " ms GPU";
+        std::cout << std::endl;
+    }
 }
@@ -20,6 +20,9 @@ void GamestoryScreen::init()
   blackness.setSize(sf::Vector2f(720, 480));
 
   blackness.setFillColor(sf::Color(0, 0, 0, trans));
+  fade.cancel();
+  fade = Timeline(&engine->getTweens());
+  fade.then(&trans, interpolate::LINEAR, 255, 50, FADE_IN_TIME);
 
   // this->engine->changeGameScreen("GamePlay");
 
@@ -37,12 +40,8 @@ void GamestoryScreen::init()
 }
 
 void GamestoryScreen::onUpdate(float dt){
-  // title screen emerges from darkness
-
-  if (trans > 50) {
-    trans -= dt/60;
-    blackness.setFillColor(sf::Color(0, 0, 0, trans));
-  }
+  // story screen emerges from darkness (see init)
+  blackness.setFillColor(sf::Color(0, 0, 0, trans));
 };
 
 void GamestoryScreen::onGamepadEvent(GamepadEvent e){
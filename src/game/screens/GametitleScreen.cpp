@@ -25,6 +25,9 @@ void GametitleScreen::init()
   blackness.setSize(sf::Vector2f(720, 480));
 
   blackness.setFillColor(sf::Color(0, 0, 0, trans));
+  fade.cancel();
+  fade = Timeline(&engine->getTweens());
+  fade.then(&trans, interpolate::LINEAR, 255, 50, FADE_IN_TIME);
 
   // this->engine->changeGameScreen("GamePlay");
 
@@ -42,12 +45,8 @@ void GametitleScreen::init()
 }
 
 void GametitleScreen::onUpdate(float dt){
-  // title screen emerges from darkness
-
-  if (trans > 50) {
-    trans -= dt/60;
-    blackness.setFillColor(sf::Color(0, 0, 0, trans));
-  }
+  // title screen emerges from darkness (see init)
+  blackness.setFillColor(sf::Color(0, 0, 0, trans));
 };
 
 void GametitleScreen::onGamepadEvent(GamepadEvent e){
@@ -0,0 +1,41 @@
+#include "game/sim/BotMatch.hpp"
+#include "game/sim/MatchBot.hpp"
+
+BotMatch::Outcome BotMatch::play(unsigned long seed, const std::vector<Config::CHARACTER>& characters,
+                                 const Match::Rules& rules, float tickSeconds)
+{
+    Match match(seed, characters, rules);
+    std::vector<MatchBot> bots;
+    for(std::size_t p = 0; p < characters.size(); p++)
+        bots.push_back(MatchBot(static_cast<int>(p), seed));
+    Outcome o;
+    while(match.getResult() == Match::PLAYING){
+        for(auto it = bots.begin(); it != bots.end(); it++)
+            it->drive(match, tickSeconds);
+        match.tick(tickSeconds);
+        if(o.ghostOut < 0 && match.getVillain().present)
+            o.ghostOut = match.getTime();
+        if(o.firstDeath < 0){
+            const std::vector<Match::Player>& players = match.getPlayers();
+            for(auto it = players.begin(); it != players.end(); it++)
+                if(!it->isAlive())
+                    o.firstDeath = match.getTime();
+        }
+    }
+
+    o.result = match.getResult();
+    o.seconds = match.getTime();
+    o.ticks = match.getTicks();
+    o.villainHealth = match.getVillain().present ? match.getVillain().health : rules.villainHealth;
+    const std::vector<Match::Player>& players = match.getPlayers();
+    for(std::size_t p = 0; p < players.size(); p++){
+        if(players[p].isAlive())
+            o.playersAlive++;
+        if(players[p].hasItem)
+            o.itemsFound++;
+        o.roomsVisited += bots[p].getRoomsVisited();
+        o.cluesRead += bots[p].getCluesRead();
+        o.swings += bots[p].getSwings();
+    }
+    return o;
+}
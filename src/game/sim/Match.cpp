@@ -0,0 +1,639 @@
+#include "game/sim/Match.hpp"
+#include "game/rooms/RoomTypes.hpp"
+#include "game/sim/MatchState.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+    sf::FloatRect moved(sf::FloatRect box, float dx, float dy)
+    {
+        box.left += dx;
+        box.top += dy;
+        return box;
+    }
+    int opposite(int side)
+    {
+        return (side + 2) % 4;
+    }
+    std::string trimmed(const std::string& s)
+    {
+        std::size_t first = s.find_first_not_of(" \t\r");
+        if(first == std::string::npos)
+            return "";
+        return s.substr(first, s.find_last_not_of(" \t\r") - first + 1);
+    }
+}
+
+Match::Match(unsigned long seed, const std::vector<Config::CHARACTER>& characters, const Rules& rules)
+    : rules(rules),
+      seed(seed),
+      spawnRng(seed, RandomStream::getNameId("spawn")),
+      clueRng(seed, RandomStream::getNameId("clues")),
+      villainRng(seed, RandomStream::getNameId("villain"))
+{
+    RandomStream house(seed, RandomStream::getNameId("house"));
+    layout.generate(getRoomCount(static_cast<int>(characters.size())), house);
+    placeClues();
+    // rolled room by room
+    for(auto it = clues.begin(); it != clues.end(); it++){
+        it->highLow = clueRng.equilikely(0, 1);
+        int roll = clueRng.equilikely(0, 99);
+        if(roll <= rules.worthlessUpTo)
+            it->tier = WORTHLESS;
+        else if(roll <= rules.vagueUpTo)
+            it->tier = VAGUE;
+        else if(roll <= rules.specificUpTo)
+            it->tier = SPECIFIC;
+        else
+            it->tier = JACKPOT;
+    }
+    for(std::size_t i = 0; i < characters.size(); i++){
+        Player p;
+        p.character = characters[i];
+        p.health = rules.health[characters[i]];
+        p.itemDamage = rules.baseDamage;
+        int r = spawnRng.equilikely(0, layout.rooms.size() - 1);
+        const sf::FloatRect& floor = layout.rooms[r].floor;
+        // player numbers start at 1
+        p.position = sf::Vector2f(floor.left + 20 + 32 * (i + 1), floor.top + RoomType::get(layout.rooms[r].type).spawnY);
+        players.push_back(p);
+    }
+    inputs.resize(players.size());
+    held.resize(players.size());
+    moves.resize(players.size());
+}
+
+void Match::placeClues()
+{
+    clues.clear();
+    firstClue.assign(1, 0);
+    for(std::size_t r = 0; r < layout.rooms.size(); r++){
+        const HouseLayout::Room& room = layout.rooms[r];
+        const RoomType& type = RoomType::get(room.type);
+        for(int i = 0; i < type.furnitureCount; i++){
+            const RoomType::Furniture& f = type.furniture[i];
+            Clue c;
+            c.box = sf::FloatRect(room.area.left + 32 * f.x, room.area.top + 32 * f.y, 32 * f.w, 32 * f.h);
+            c.room = static_cast<int>(r);
+            c.tier = WORTHLESS;
+            c.highLow = 0;
+            clues.push_back(c);
+        }
+        firstClue.push_back(static_cast<int>(clues.size()));
+    }
+}
+
+void Match::save(MatchState& state) const
+{
+    state.seed = seed;
+    state.tick = ticks;
+    state.result = static_cast<uint8_t>(result);
+    state.phase = static_cast<uint8_t>(phase);
+    state.time = time;
+    state.phaseTime = phaseTime;
+    state.rooms.resize(layout.rooms.size());
+    for(std::size_t r = 0; r < layout.rooms.size(); r++){
+        state.rooms[r].gridX = static_cast<uint8_t>(layout.rooms[r].gridX);
+        state.rooms[r].gridY = static_cast<uint8_t>(layout.rooms[r].gridY);
+        state.rooms[r].type = static_cast<uint8_t>(layout.rooms[r].type);
+    }
+    state.clues.resize(clues.size());
+    for(std::size_t c = 0; c < clues.size(); c++){
+        state.clues[c].tier = static_cast<uint8_t>(clues[c].tier);
+        state.clues[c].highLow = static_cast<uint8_t>(clues[c].highLow);
+        state.clues[c].open = clues[c].open;
+    }
+    state.players = players;
+    state.controls.resize(players.size());
+    for(std::size_t p = 0; p < players.size(); p++){
+        state.controls[p].last = inputs[p].down;
+        state.controls[p].held = held[p];
+        state.controls[p].move = moves[p];
+    }
+    state.villain = villain;
+    state.spawnDrawn = spawnRng.getPosition();
+    state.clueDrawn = clueRng.getPosition();
+    state.villainDrawn = villainRng.getPosition();
+}
+
+bool Match::restore(const MatchState& state)
+{
+    if(state.players.empty() || state.controls.size() != state.players.size() || state.rooms.empty())
+        return false;
+    std::vector<HouseLayout::Room> placed(state.rooms.size());
+    std::vector<bool> taken(HouseLayout::GRID * HouseLayout::GRID, false);
+    for(std::size_t r = 0; r < state.rooms.size(); r++){
+        const MatchState::Room& s = state.rooms[r];
+        if(s.gridX >= HouseLayout::GRID || s.gridY >= HouseLayout::GRID || s.type < 1 || s.type > RoomType::COUNT)
+            return false;
+        if(taken[s.gridX * HouseLayout::GRID + s.gridY])
+            return false;
+        taken[s.gridX * HouseLayout::GRID + s.gridY] = true;
+        placed[r].gridX = s.gridX;
+        placed[r].gridY = s.gridY;
+        placed[r].type = s.type;
+    }
+    HouseLayout house;
+    house.build(placed);
+    std::size_t clueCount = 0;
+    for(auto it = placed.begin(); it != placed.end(); it++)
+        clueCount += RoomType::get(it->type).furnitureCount;
+    if(clueCount != state.clues.size())
+        return false;
+    // anything used as an index has to point somewhere
+    int playerCount = static_cast<int>(state.players.size());
+    for(auto it = state.players.begin(); it != state.players.end(); it++)
+        if(it->character < 0 || it->character > 3 || it->reading < -1 || it->reading >= static_cast<int>(clueCount)
+           || it->itemHighLow < 0 || it->itemHighLow > 1)
+            return false;
+    if(state.villain.target < -1 || state.villain.target >= playerCount
+       || state.villain.cameFrom < -1 || state.villain.cameFrom > 3)
+        return false;
+
+    seed = static_cast<unsigned long>(state.seed);
+    layout = house;
+    placeClues();
+    for(std::size_t c = 0; c < clues.size(); c++){
+        clues[c].tier = static_cast<CLUE>(state.clues[c].tier);
+        clues[c].highLow = state.clues[c].highLow;
+        clues[c].open = state.clues[c].open;
+    }
+    players = state.players;
+    inputs.assign(players.size(), Input::State());
+    held.resize(players.size());
+    moves.resize(players.size());
+    for(std::size_t p = 0; p < players.size(); p++){
+        inputs[p].down = state.controls[p].last;
+        held[p] = state.controls[p].held;
+        moves[p] = state.controls[p].move;
+    }
+    villain = state.villain;
+    spawnRng = RandomStream(seed, RandomStream::getNameId("spawn"));
+    spawnRng.setPosition(state.spawnDrawn);
+    clueRng = RandomStream(seed, RandomStream::getNameId("clues"));
+    clueRng.setPosition(state.clueDrawn);
+    villainRng = RandomStream(seed, RandomStream::getNameId("villain"));
+    villainRng.setPosition(state.villainDrawn);
+    result = static_cast<RESULT>(state.result);
+    phase = state.phase;
+    time = state.time;
+    phaseTime = state.phaseTime;
+    ticks = state.tick;
+    return true;
+}
+
+std::vector<Match::Rules::Field> Match::Rules::getFields()
+{
+    Field fields[] = {
+        {"playerSpeed", &playerSpeed, NULL},
+        {"runMultiplier", &runMultiplier, NULL},
+        {"healthBro", NULL, &health[Config::BRO]},
+        {"healthSis", NULL, &health[Config::SIS]},
+        {"healthDad", NULL, &health[Config::DAD]},
+        {"healthMom", NULL, &health[Config::MOM]},
+        {"invulnerableSeconds", &invulnerableSeconds, NULL},
+        {"attackSeconds", &attackSeconds, NULL},
+        {"attackReach", &attackReach, NULL},
+        {"worthlessUpTo", NULL, &worthlessUpTo},
+        {"vagueUpTo", NULL, &vagueUpTo},
+        {"specificUpTo", NULL, &specificUpTo},
+        {"itemDamageLow", NULL, &itemDamage[0]},
+        {"itemDamageHigh", NULL, &itemDamage[1]},
+        {"baseDamage", NULL, &baseDamage},
+        {"villainHealth", NULL, &villainHealth},
+        {"villainSpeed", &villainSpeed, NULL},
+        {"chaseMultiplier", &chaseMultiplier, NULL},
+        {"calmDivisor", &calmDivisor, NULL},
+        {"phaseSeconds", &phaseSeconds, NULL},
+        {"timeLimitSeconds", &timeLimitSeconds, NULL},
+    };
+    return std::vector<Field>(fields, fields + sizeof(fields) / sizeof(fields[0]));
+}
+
+bool Match::Rules::set(const std::string& name, float value)
+{
+    std::vector<Field> fields = getFields();
+    for(auto it = fields.begin(); it != fields.end(); it++){
+        if(name != it->name)
+            continue;
+        if(it->real)
+            *it->real = value;
+        else
+            *it->whole = static_cast<int>(std::lround(value));
+        return true;
+    }
+    return false;
+}
+
+bool Match::Rules::get(const std::string& name, float& value) const
+{
+    std::vector<Field> fields = const_cast<Rules*>(this)->getFields();
+    for(auto it = fields.begin(); it != fields.end(); it++){
+        if(name != it->name)
+            continue;
+        value = it->real ? *it->real : static_cast<float>(*it->whole);
+        return true;
+    }
+    return false;
+}
+
+const char* Match::Rules::getProblem() const
+{
+    for(int c = 0; c < 4; c++)
+        if(health[c] <= 0)
+            return "every character's health has to be above 0";
+    if(villainHealth <= 0)
+        return "villainHealth has to be above 0";
+    // setRules() and the chase scale the ghost's speed by these
+    if(villainSpeed <= 0)
+        return "villainSpeed has to be above 0";
+    if(chaseMultiplier <= 0 || calmDivisor <= 0)
+        return "chaseMultiplier and calmDivisor have to be above 0";
+    if(!(worthlessUpTo < vagueUpTo && vagueUpTo < specificUpTo))
+        return "worthlessUpTo, vagueUpTo and specificUpTo have to go up in that order";
+    return NULL;
+}
+
+bool Match::Rules::load(const std::string& filename)
+{
+    std::ifstream file(filename);
+    if(!file){
+        std::cout << "Rules: couldn't read " << filename << std::endl;
+        return false;
+    }
+    Rules loaded = *this;
+    std::string line;
+    for(int number = 1; std::getline(file, line); number++){
+        line = trimmed(line.substr(0, line.find('#')));
+        if(line.empty())
+            continue;
+        std::size_t equals = line.find('=');
+        std::string name = trimmed(line.substr(0, equals));
+        std::string text = equals == std::string::npos ? "" : trimmed(line.substr(equals + 1));
+        char* end = NULL;
+        float value = std::strtof(text.c_str(), &end);
+        if(text.empty() || *end != '\0')
+            std::cout << filename << ":" << number << ": expected name = number" << std::endl;
+        else if(!loaded.set(name, value))
+            std::cout << filename << ":" << number << ": no rule called " << name << std::endl;
+    }
+    if(const char* problem = loaded.getProblem()){
+        std::cout << filename << ": " << problem << ", keeping the rules as they were" << std::endl;
+        return false;
+    }
+    *this = loaded;
+    return true;
+}
+
+int Match::getRoomCount(int players)
+{
+    switch(players){
+        case 1: return 20;
+        case 2: return 40;
+        case 3: return 60;
+        default: return 100;
+    }
+}
+
+void Match::setRules(const Rules& next)
+{
+    for(auto it = players.begin(); it != players.end(); it++){
+        if(it->isAlive())
+            it->health = std::max(1, it->health + next.health[it->character] - rules.health[it->character]);
+        it->itemDamage = it->hasItem ? next.itemDamage[it->itemHighLow] : next.baseDamage;
+    }
+    if(villain.present && villain.health > 0){
+        villain.health = std::max(1, villain.health + next.villainHealth - rules.villainHealth);
+        villain.speed *= next.villainSpeed / rules.villainSpeed;
+    }
+    rules = next;
+}
+
+void Match::setInput(int player, const Input::Actions& down, sf::Vector2f move)
+{
+    held[player] = down;
+    moves[player] = move;
+}
+
+void Match::tick(float dt)
+{
+    if(result != PLAYING)
+        return;
+    ticks++;
+    time += dt;
+    phaseTime += dt;
+    if(phaseTime >= rules.phaseSeconds){
+        if(phase == 1){
+            spawnVillain();
+            phase++;
+        }
+        phaseTime = 0;
+    }
+    for(std::size_t p = 0; p < players.size(); p++){
+        Input::State& in = inputs[p];
+        in.advance(held[p]);
+        in.move = moves[p];
+        Player& pl = players[p];
+        pl.invulnerable = std::max(0.0f, pl.invulnerable - dt);
+        pl.attacking = std::max(0.0f, pl.attacking - dt);
+        if(!pl.isAlive())
+            continue;
+        if(in.wasPressed(Input::GIVE_UP)){
+            pl.health = 0;
+            continue;
+        }
+        // steer: walk where the stick says, face its larger axis
+        pl.direction = in.move;
+        if(in.move.x != 0 || in.move.y != 0){
+            if(std::abs(in.move.x) > std::abs(in.move.y))
+                pl.facing = in.move.x < 0 ? FACE_LEFT : FACE_RIGHT;
+            else
+                pl.facing = in.move.y < 0 ? FACE_UP : FACE_DOWN;
+        }
+        movePlayer(static_cast<int>(p), dt);
+        if(in.wasPressed(Input::ATTACK) && pl.attacking <= 0){
+            pl.attacking = rules.attackSeconds;
+            attackWith(static_cast<int>(p));
+        }
+        if(in.wasPressed(Input::USE) && pl.reading < 0)
+            usePlayer(static_cast<int>(p));
+        if(in.wasReleased(Input::USE) && pl.reading >= 0){
+            clues[pl.reading].open = false;
+            pl.reading = -1;
+        }
+    }
+    if(villain.present && villain.health > 0)
+        moveVillain(dt);
+    checkEnd();
+}
+
+void Match::movePlayer(int p, float dt)
+{
+    Player& pl = players[p];
+    float speed = rules.playerSpeed;
+    if(pl.character == Config::BRO && inputs[p].isDown(Input::RUN))
+        speed *= rules.runMultiplier;
+    float dx = pl.direction.x * speed * dt;
+    float dy = pl.direction.y * speed * dt;
+    sf::FloatRect box = pl.getHitbox();
+    if(!layout.isInside(moved(box, dx, dy)))
+        return;
+    // furniture stops each way separately, so you slide along it
+    int room = layout.roomAt(sf::Vector2f(box.left, box.top));
+    if(dx != 0 && blocked(box, dx, 0, room))
+        dx = 0;
+    if(dy != 0 && blocked(box, 0, dy, room))
+        dy = 0;
+    pl.position += sf::Vector2f(dx, dy);
+}
+
+bool Match::blocked(const sf::FloatRect& box, float dx, float dy, int room) const
+{
+    if(room < 0)
+        return false;
+    sf::FloatRect to = moved(box, dx, dy);
+    for(int c = firstClue[room]; c < firstClue[room + 1]; c++){
+        // whatever it's already on it can walk off
+        if(clues[c].box.intersects(to) && !clues[c].box.intersects(box))
+            return true;
+    }
+    return false;
+}
+
+int Match::clueAt(int player) const
+{
+    sf::FloatRect box = players[player].getHitbox();
+    int room = layout.roomAt(sf::Vector2f(box.left, box.top));
+    if(room < 0)
+        return -1;
+    // furniture stops you just short, so reach a little
+    sf::FloatRect reach(box.left - 4, box.top - 4, box.width + 8, box.height + 8);
+    for(int c = firstClue[room]; c < firstClue[room + 1]; c++)
+        if(clues[c].box.intersects(reach))
+            return c;
+    return -1;
+}
+
+void Match::usePlayer(int p)
+{
+    Player& pl = players[p];
+    int c = clueAt(p);
+    if(c < 0)
+        return;
+    clues[c].open = true;
+    pl.reading = c;
+    if(clues[c].tier == JACKPOT && !pl.hasItem){
+        pl.itemHighLow = clues[c].highLow;
+        pl.itemDamage = rules.itemDamage[pl.itemHighLow];
+        pl.hasItem = true;
+    }
+}
+
+void Match::attackWith(int p)
+{
+    if(!villain.present || villain.health <= 0)
+        return;
+    sf::FloatRect me = players[p].getHitbox();
+    sf::FloatRect v = villain.getHitbox();
+    float reach = rules.attackReach;
+    bool hit = false;
+    switch(players[p].facing){
+        case FACE_RIGHT:
+            hit = v.left > me.left + me.width && v.left < me.left + me.width + reach &&
+                  std::abs(v.top - me.top) <= 32;
+            break;
+        case FACE_LEFT:
+            hit = v.left + v.width < me.left && v.left + v.width > me.left - reach &&
+                  std::abs(v.top - me.top) <= 32;
+            break;
+        case FACE_UP:
+            hit = v.top + v.height < me.top && v.top + v.height > me.top - reach &&
+                  std::abs(v.left - me.left) <= 32;
+            break;
+        case FACE_DOWN:
+            hit = v.top > me.top + me.height && v.top < me.top + me.height + reach &&
+                  std::abs(v.left - me.left) <= 32;
+            break;
+    }
+    if(hit)
+        hurtVillain(players[p].itemDamage);
+}
+
+void Match::spawnVillain()
+{
+    villain.present = true;
+    villain.health = rules.villainHealth;
+    villain.speed = rules.villainSpeed;
+    villain.position = getSpot(0);
+    pickHeading(0);
+}
+
+sf::Vector2f Match::getSpot(int room) const
+{
+    const sf::FloatRect& f = layout.rooms[room].floor;
+    return sf::Vector2f(f.left + f.width / 2 - 16, f.top + f.height / 2 - 36);
+}
+
+int Match::villainRoom() const
+{
+    sf::FloatRect box = villain.getHitbox();
+    return layout.roomAt(sf::Vector2f(box.left + box.width / 2, box.top + box.height / 2));
+}
+
+void Match::pickHeading(int room)
+{
+    villain.direction = sf::Vector2f();
+    if(room < 0)
+        return;
+    const HouseLayout::Room& r = layout.rooms[room];
+    // anywhere but back, unless it's a dead end
+    int sides[4];
+    int n = 0;
+    for(int s = 0; s < 4; s++)
+        if(r.next[s] >= 0 && s != villain.cameFrom)
+            sides[n++] = s;
+    if(n == 0 && villain.cameFrom >= 0 && r.next[villain.cameFrom] >= 0)
+        sides[n++] = villain.cameFrom;
+    if(n == 0)
+        return;
+    int side = sides[villainRng.equilikely(0, n - 1)];
+    villain.heading = getSpot(r.next[side]);
+    villain.cameFrom = opposite(side);
+    villain.direction = villain.heading - villain.position;
+    float length = std::sqrt(villain.direction.x * villain.direction.x + villain.direction.y * villain.direction.y);
+    if(length > 0)
+        villain.direction /= length;
+}
+
+int Match::findTarget(int room) const
+{
+    const sf::FloatRect& floor = layout.rooms[room].floor;
+    for(std::size_t p = 0; p < players.size(); p++){
+        const Player& pl = players[p];
+        // SIS can hide by standing still
+        if(pl.character == Config::SIS && pl.direction.x == 0 && pl.direction.y == 0)
+            continue;
+        if(pl.isAlive() && pl.invulnerable <= 0 && pl.getHitbox().intersects(floor))
+            return static_cast<int>(p);
+    }
+    return -1;
+}
+
+void Match::moveVillain(float dt)
+{
+    Villain& v = villain;
+    int room = villainRoom();
+    int target = room >= 0 ? findTarget(room) : -1;
+    if(target >= 0){
+        if(!v.fast){
+            v.speed *= rules.chaseMultiplier;
+            v.fast = true;
+        }
+        v.chasing = true;
+        v.target = target;
+        sf::FloatRect box = v.getHitbox();
+        sf::FloatRect them = players[target].getHitbox();
+        v.direction = sf::Vector2f();
+        if(them.left < box.left)
+            v.direction.x = -1;
+        else if(them.left - 10 > box.left)
+            v.direction.x = 1;
+        if(them.top < box.top)
+            v.direction.y = -1;
+        else if(them.top - 10 > box.top)
+            v.direction.y = 1;
+        // whole pixels a tick, as the ghost has always stepped: at 60 Hz a
+        // chase at 150 px/s covers 2 px a tick (120 px/s)
+        sf::Vector2f step(std::trunc(v.direction.x * v.speed * dt), std::trunc(v.direction.y * v.speed * dt));
+        // chased itself out of the house
+        if(!layout.isInside(moved(box, step.x, step.y))){
+            teleportVillain(rules.chaseMultiplier);
+            return;
+        }
+        v.position += step;
+        box = v.getHitbox();
+        for(std::size_t p = 0; p < players.size(); p++){
+            const Player& pl = players[p];
+            if(pl.isAlive() && pl.invulnerable <= 0 && box.intersects(pl.getHitbox())){
+                hurtPlayer(static_cast<int>(p));
+                teleportVillain(rules.calmDivisor);
+                return;
+            }
+        }
+        return;
+    }
+    if(v.chasing){
+        // lost them: back to the middle of the room, then wander on
+        if(v.fast){
+            v.speed /= rules.calmDivisor;
+            v.fast = false;
+        }
+        v.chasing = false;
+        v.target = -1;
+        v.cameFrom = -1;
+        if(room >= 0)
+            v.heading = getSpot(room);
+    }
+    sf::Vector2f d = v.heading - v.position;
+    float distance = std::sqrt(d.x * d.x + d.y * d.y);
+    // whole pixels here too, and never less than one
+    float step = std::max(1.0f, std::trunc(v.speed * dt));
+    if(distance <= step){
+        v.position = v.heading;
+        pickHeading(villainRoom());
+    }
+    else{
+        v.direction = d / distance;
+        v.position += v.direction * step;
+    }
+}
+
+void Match::hurtPlayer(int p)
+{
+    players[p].health--;
+    players[p].invulnerable = rules.invulnerableSeconds;
+}
+
+void Match::hurtVillain(int damage)
+{
+    villain.health -= damage;
+    villain.direction = sf::Vector2f();
+    if(villain.health > 0)
+        teleportVillain(rules.chaseMultiplier);
+}
+
+void Match::teleportVillain(float divisor)
+{
+    int here = villainRoom();
+    int room = here;
+    while(room == here && layout.rooms.size() > 1)
+        room = villainRng.equilikely(0, layout.rooms.size() - 1);
+    if(villain.fast){
+        villain.speed /= divisor;
+        villain.fast = false;
+    }
+    villain.position = getSpot(room);
+    villain.chasing = false;
+    villain.target = -1;
+    villain.cameFrom = -1;
+    pickHeading(room);
+}
+
+void Match::checkEnd()
+{
+    if(villain.present && villain.health <= 0){
+        result = PLAYERS_WON;
+        return;
+    }
+    bool anyAlive = false;
+    for(auto it = players.begin(); it != players.end(); it++)
+        anyAlive = anyAlive || it->isAlive();
+    if(!anyAlive)
+        result = VILLAIN_WON;
+    else if(rules.timeLimitSeconds > 0 && time >= rules.timeLimitSeconds)
+        result = TIMED_OUT;
+}
@@ -0,0 +1,399 @@
+#include "game/sim/MatchBot.hpp"
+#include "game/rooms/RoomTypes.hpp"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+
+namespace
+{
+    // the ghost this close (middle to middle) and it has to do something
+    const float DANGER = 128;
+    // fights at this much health, or with an item
+    const int BRAVE_HEALTH = 3;
+    // how long it reads a clue for
+    const float READ_MIN = 0.5f;
+    const float READ_MAX = 1.5f;
+    // seconds on one piece of furniture, or one leg of a route, before
+    // giving up on it
+    const float CLUE_GIVE_UP = 8;
+    const float LEG_GIVE_UP = 4;
+    // barely moving this long while trying to means it's caught on
+    // something; it sidesteps for a moment
+    const float STUCK = 0.4f;
+    const float SIDESTEP = 0.3f;
+    const float ARRIVED = 4;
+
+    // A room's picture is TILES_X by TILES_Y tiles of TILE px, of which
+    // the floor is the ones from FLOOR_FIRST to FLOOR_LAST
+    const int TILE = 32;
+    const int TILES_X = HouseLayout::ROOM_W / TILE;
+    const int TILES_Y = HouseLayout::ROOM_H / TILE;
+    const sf::Vector2i FLOOR_FIRST(1, 2);
+    const sf::Vector2i FLOOR_LAST(14, 10);
+    // the floor tile in front of each SIDE's doorway, lined up with it
+    const sf::Vector2i DOORSTEP[4] = {sf::Vector2i(14, 5), sf::Vector2i(7, 10),
+                                      sf::Vector2i(1, 5), sf::Vector2i(7, 2)};
+
+    sf::Vector2f centreOf(const sf::FloatRect& r)
+    {
+        return sf::Vector2f(r.left + r.width / 2, r.top + r.height / 2);
+    }
+    float length(sf::Vector2f v)
+    {
+        return std::sqrt(v.x * v.x + v.y * v.y);
+    }
+    // where a player stands in the middle of a tile (the hitbox hangs
+    // below and either side of its position)
+    sf::Vector2f tileSpot(const HouseLayout::Room& room, sf::Vector2i tile)
+    {
+        return sf::Vector2f(room.area.left + TILE * tile.x + TILE / 2,
+                            room.area.top + TILE * tile.y + TILE / 2 - 8);
+    }
+    sf::Vector2i tileAt(const HouseLayout::Room& room, sf::Vector2f position)
+    {
+        int x = static_cast<int>(std::floor((position.x - room.area.left) / TILE));
+        int y = static_cast<int>(std::floor((position.y + 8 - room.area.top) / TILE));
+        return sf::Vector2i(std::max(FLOOR_FIRST.x, std::min(FLOOR_LAST.x, x)),
+                            std::max(FLOOR_FIRST.y, std::min(FLOOR_LAST.y, y)));
+    }
+    bool covers(const RoomType::Furniture& f, int x, int y)
+    {
+        return x >= f.x && x < f.x + f.w && y >= f.y && y < f.y + f.h;
+    }
+}
+
+MatchBot::MatchBot(int player, unsigned long seed)
+    : player(player),
+      rng(seed, RandomStream::getNameId("bot") + player)
+{
+}
+
+int MatchBot::getRoomsVisited() const
+{
+    return static_cast<int>(std::count(visited.begin(), visited.end(), true));
+}
+
+void MatchBot::drive(Match& match, float dt)
+{
+    sf::Vector2f move;
+    Input::Actions down = think(match, dt, move);
+    match.setInput(player, down, move);
+}
+
+Input::Actions MatchBot::think(const Match& match, float dt, sf::Vector2f& move)
+{
+    Input::Actions down;
+    move = sf::Vector2f();
+    const Match::Player& me = match.getPlayers()[player];
+    if(!me.isAlive() || match.getResult() != Match::PLAYING){
+        last = down;
+        return down;
+    }
+    const HouseLayout& layout = match.getLayout();
+    if(visited.empty()){
+        visited.assign(layout.rooms.size(), false);
+        searched.assign(match.getClues().size(), false);
+        lastPosition = me.position;
+    }
+    position = me.position;
+    int here = layout.roomAt(me.getHitbox());
+    if(here >= 0 && here != room){
+        room = here;
+        visited[room] = true;
+    }
+    if(walking && length(position - lastPosition) < 0.25f)
+        stuckFor += dt;
+    else
+        stuckFor = 0;
+    lastPosition = position;
+
+    float ghost = ghostDistance(match);
+    bool danger = ghost >= 0 && ghost < DANGER;
+    if(me.reading >= 0){
+        // keep it open a moment, unless there's something to run from
+        readFor -= dt;
+        down[Input::USE] = readFor > 0 && !danger;
+        last = down;
+        walking = false;
+        return down;
+    }
+    if(danger){
+        // whatever it was up to gets planned again afterwards
+        route.clear();
+        goalFor = 0;
+        if(me.hasItem || me.health >= BRAVE_HEALTH)
+            fight(match, down, move);
+        else
+            flee(match, move);
+    }
+    else if(goal >= 0 || (room >= 0 && route.empty() && (goal = nearestClue(match, room)) >= 0))
+        search(match, dt, down, move);
+    else
+        explore(match, dt, move);
+
+    if(stuckFor > STUCK && (move.x != 0 || move.y != 0)){
+        // off at right angles, either way
+        float side = rng.bernoulli(0.5) ? 1.0f : -1.0f;
+        sidestep = sf::Vector2f(-move.y * side, move.x * side);
+        sidestepFor = SIDESTEP;
+        stuckFor = 0;
+    }
+    if(sidestepFor > 0){
+        sidestepFor -= dt;
+        move = sidestep;
+    }
+    down[Input::RUN] = task == FLEE || task == EXPLORE;
+    walking = move.x != 0 || move.y != 0;
+    last = down;
+    return down;
+}
+
+float MatchBot::ghostDistance(const Match& match) const
+{
+    const Match::Villain& v = match.getVillain();
+    if(!v.present || v.health <= 0)
+        return -1;
+    return length(centreOf(v.getHitbox()) - centreOf(match.getPlayers()[player].getHitbox()));
+}
+
+void MatchBot::fight(const Match& match, Input::Actions& down, sf::Vector2f& move)
+{
+    task = FIGHT;
+    const Match::Player& me = match.getPlayers()[player];
+    sf::FloatRect mine = me.getHitbox();
+    sf::FloatRect theirs = match.getVillain().getHitbox();
+    sf::Vector2f d = centreOf(theirs) - centreOf(mine);
+    bool across = std::abs(d.x) > std::abs(d.y);
+    // the space between the two boxes, the way it's facing
+    float gap = across ? std::abs(d.x) - (mine.width + theirs.width) / 2
+                       : std::abs(d.y) - (mine.height + theirs.height) / 2;
+    float reach = match.getRules().attackReach;
+    // closes in, then just leans its way (enough to face it, not to bump it)
+    float push = gap > reach / 2 ? 1.0f : 0.05f;
+    if(across)
+        move = sf::Vector2f(d.x < 0 ? -push : push, 0);
+    else
+        move = sf::Vector2f(0, d.y < 0 ? -push : push);
+    if(gap > 0 && gap < reach && me.attacking <= 0 && !last[Input::ATTACK]){
+        down[Input::ATTACK] = true;
+        swings++;
+    }
+}
+
+void MatchBot::flee(const Match& match, sf::Vector2f& move)
+{
+    task = FLEE;
+    sf::Vector2f away = centreOf(match.getPlayers()[player].getHitbox())
+                      - centreOf(match.getVillain().getHitbox());
+    float l = length(away);
+    move = l > 0 ? away / l : sf::Vector2f(1, 0);
+}
+
+void MatchBot::search(const Match& match, float dt, Input::Actions& down, sf::Vector2f& move)
+{
+    task = SEARCH;
+    int c = match.clueAt(player);
+    if(c >= 0 && !searched[c]){
+        // whatever it's next to, not just the one it was after
+        if(!last[Input::USE]){
+            down[Input::USE] = true;
+            searched[c] = true;
+            cluesRead++;
+            readFor = static_cast<float>(rng.uniform(READ_MIN, READ_MAX));
+            if(c == goal){
+                goal = -1;
+                route.clear();
+            }
+        }
+        return;
+    }
+    if(goal < 0)
+        return;
+    if(goalFor == 0){
+        route.clear();
+        const HouseLayout::Room& r = match.getLayout().rooms[room];
+        if(!planTiles(match, room, tileAt(r, position), sf::Vector2i(), goal))
+            goalFor = CLUE_GIVE_UP;
+    }
+    goalFor += dt;
+    if(searched[goal] || goalFor > CLUE_GIVE_UP){
+        searched[goal] = true;
+        goal = -1;
+        goalFor = 0;
+        route.clear();
+        return;
+    }
+    if(follow(match, dt, move))
+        return;
+    // next to it: lean in until the reach touches it
+    sf::Vector2f to = centreOf(match.getClues()[goal].box);
+    move = steer(sf::Vector2f(to.x, to.y - 8));
+}
+
+void MatchBot::explore(const Match& match, float dt, sf::Vector2f& move)
+{
+    task = EXPLORE;
+    if(route.empty())
+        planRoute(match, room);
+    follow(match, dt, move);
+}
+
+bool MatchBot::follow(const Match& match, float dt, sf::Vector2f& move)
+{
+    const Match::Rules& rules = match.getRules();
+    // a step can be this long, so closer than that is there
+    float arrived = std::max(ARRIVED, rules.playerSpeed * rules.runMultiplier * dt);
+    while(!route.empty() && length(route.front() - position) <= arrived){
+        route.erase(route.begin());
+        legFor = 0;
+    }
+    if(route.empty())
+        return false;
+    legFor += dt;
+    if(legFor > LEG_GIVE_UP){
+        // plans again from wherever it ended up
+        route.clear();
+        legFor = 0;
+        return false;
+    }
+    move = steer(route.front());
+    return true;
+}
+
+void MatchBot::planRoute(const Match& match, int from)
+{
+    route.clear();
+    legFor = 0;
+    if(from < 0)
+        return;
+    const HouseLayout& layout = match.getLayout();
+    // breadth first over the doors to the nearest room it hasn't seen
+    std::vector<int> cameFrom(layout.rooms.size(), -2);
+    std::deque<int> open;
+    cameFrom[from] = -1;
+    open.push_back(from);
+    int found = -1;
+    while(!open.empty() && found < 0){
+        int r = open.front();
+        open.pop_front();
+        for(int s = 0; s < 4; s++){
+            int n = layout.rooms[r].next[s];
+            if(n < 0 || cameFrom[n] != -2)
+                continue;
+            cameFrom[n] = r;
+            if(!visited[n]){
+                found = n;
+                break;
+            }
+            open.push_back(n);
+        }
+    }
+    if(found < 0){
+        // been everywhere: start over, somewhere at random
+        visited.assign(visited.size(), false);
+        visited[from] = true;
+        found = rng.equilikely(0, static_cast<long>(layout.rooms.size()) - 1);
+        if(found == from || cameFrom[found] == -2)
+            return;
+    }
+    std::vector<int> path;
+    for(int r = found; r != from; r = cameFrom[r])
+        path.push_back(r);
+    path.push_back(from);
+    std::reverse(path.begin(), path.end());
+    // across each room to the doorstep, then straight through the door
+    // onto the next room's
+    sf::Vector2i tile = tileAt(layout.rooms[from], position);
+    for(std::size_t i = 0; i + 1 < path.size(); i++){
+        const HouseLayout::Room& a = layout.rooms[path[i]];
+        int side = 0;
+        while(side < 3 && a.next[side] != path[i + 1])
+            side++;
+        if(!planTiles(match, path[i], tile, DOORSTEP[side], -1))
+            route.push_back(tileSpot(a, DOORSTEP[side]));
+        tile = DOORSTEP[(side + 2) % 4];
+        route.push_back(tileSpot(layout.rooms[path[i + 1]], tile));
+    }
+}
+
+bool MatchBot::planTiles(const Match& match, int room, sf::Vector2i from, sf::Vector2i to, int clue)
+{
+    const HouseLayout::Room& r = match.getLayout().rooms[room];
+    const RoomType& type = RoomType::get(r.type);
+    bool blocked[TILES_X][TILES_Y] = {};
+    for(int i = 0; i < type.furnitureCount; i++)
+        for(int x = FLOOR_FIRST.x; x <= FLOOR_LAST.x; x++)
+            for(int y = FLOOR_FIRST.y; y <= FLOOR_LAST.y; y++)
+                blocked[x][y] = blocked[x][y] || covers(type.furniture[i], x, y);
+    // the clue's furniture, in tiles
+    RoomType::Furniture piece = {0, 0, 0, 0, RoomType::NO_LIGHT};
+    if(clue >= 0){
+        const sf::FloatRect& box = match.getClues()[clue].box;
+        piece.x = static_cast<int>((box.left - r.area.left) / TILE);
+        piece.y = static_cast<int>((box.top - r.area.top) / TILE);
+        piece.w = static_cast<int>(box.width / TILE);
+        piece.h = static_cast<int>(box.height / TILE);
+    }
+    auto isGoal = [&](int x, int y){
+        if(clue < 0)
+            return x == to.x && y == to.y;
+        return covers(piece, x - 1, y) || covers(piece, x + 1, y) ||
+               covers(piece, x, y - 1) || covers(piece, x, y + 1);
+    };
+    const sf::Vector2i steps[4] = {sf::Vector2i(1, 0), sf::Vector2i(0, 1), sf::Vector2i(-1, 0), sf::Vector2i(0, -1)};
+    // tile index it was reached from, -1 for the start, -2 for not yet
+    int cameFrom[TILES_X * TILES_Y];
+    std::fill(cameFrom, cameFrom + TILES_X * TILES_Y, -2);
+    std::deque<sf::Vector2i> open;
+    cameFrom[from.x * TILES_Y + from.y] = -1;
+    open.push_back(from);
+    int found = -1;
+    while(!open.empty()){
+        sf::Vector2i t = open.front();
+        open.pop_front();
+        if(isGoal(t.x, t.y)){
+            found = t.x * TILES_Y + t.y;
+            break;
+        }
+        for(int s = 0; s < 4; s++){
+            sf::Vector2i n = t + steps[s];
+            if(n.x < FLOOR_FIRST.x || n.x > FLOOR_LAST.x || n.y < FLOOR_FIRST.y || n.y > FLOOR_LAST.y)
+                continue;
+            if(blocked[n.x][n.y] || cameFrom[n.x * TILES_Y + n.y] != -2)
+                continue;
+            cameFrom[n.x * TILES_Y + n.y] = t.x * TILES_Y + t.y;
+            open.push_back(n);
+        }
+    }
+    if(found < 0)
+        return false;
+    std::vector<sf::Vector2f> legs;
+    for(int t = found; t != -1; t = cameFrom[t])
+        legs.push_back(tileSpot(r, sf::Vector2i(t / TILES_Y, t % TILES_Y)));
+    route.insert(route.end(), legs.rbegin(), legs.rend());
+    return true;
+}
+
+int MatchBot::nearestClue(const Match& match, int room) const
+{
+    const std::vector<Match::Clue>& clues = match.getClues();
+    int best = -1;
+    float bestDistance = 0;
+    for(std::size_t c = 0; c < clues.size(); c++){
+        if(clues[c].room != room || searched[c])
+            continue;
+        float d = length(centreOf(clues[c].box) - position);
+        if(best < 0 || d < bestDistance){
+            best = static_cast<int>(c);
+            bestDistance = d;
+        }
+    }
+    return best;
+}
+
+sf::Vector2f MatchBot::steer(sf::Vector2f to) const
+{
+    sf::Vector2f d = to - position;
+    float l = length(d);
+    return l > 0 ? d / l : sf::Vector2f();
+}
@@ -0,0 +1,180 @@
+#include "game/sim/MatchClient.hpp"
+#include "engine/Input.hpp"
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+const sf::Uint32 MatchClient::HISTORY;
+
+namespace
+{
+    // how long to wait for JOINED before asking again
+    const double JOIN_RETRY = 0.5;
+}
+
+bool MatchClient::open(const sf::IpAddress& address, unsigned short port, sf::Uint32 seed,
+                       const std::vector<Config::CHARACTER>& characters, int seats)
+{
+    if(socket.bind(sf::Socket::AnyPort) != sf::Socket::Done){
+        std::cout << "MatchClient: couldn't open a port" << std::endl;
+        return false;
+    }
+    socket.setBlocking(false);
+    this->address = address;
+    this->port = port;
+    this->seed = seed;
+    this->characters = characters;
+    wanted = seats < 0 ? static_cast<int>(characters.size()) : seats;
+    this->seats.clear();
+    frames.assign(wanted, Lockstep::Frame());
+    history.assign(HISTORY, MatchSnapshot());
+    joined = false;
+    askedAt = 0;
+    send();
+    return true;
+}
+
+MatchClient::~MatchClient()
+{
+    close();
+}
+
+void MatchClient::close()
+{
+    if(!joined)
+        return;
+    sf::Packet packet;
+    packet << MatchServer::MAGIC << static_cast<sf::Uint8>(MatchServer::LEAVE) << seed;
+    socket.send(packet, address, port);
+    joined = false;
+}
+
+void MatchClient::setInput(int i, const Lockstep::Frame& frame)
+{
+    frames[i] = frame;
+}
+
+void MatchClient::update()
+{
+    receive();
+    send();
+}
+
+void MatchClient::send()
+{
+    sf::Packet packet;
+    packet << MatchServer::MAGIC;
+    if(!joined){
+        double now = Input::now();
+        if(now - askedAt < JOIN_RETRY)
+            return;
+        askedAt = now;
+        packet << static_cast<sf::Uint8>(MatchServer::JOIN) << seed
+               << static_cast<sf::Uint8>(characters.size());
+        for(auto it = characters.begin(); it != characters.end(); it++)
+            packet << static_cast<sf::Uint8>(*it);
+        packet << static_cast<sf::Uint8>(wanted);
+    }
+    else{
+        packet << static_cast<sf::Uint8>(MatchServer::INPUT) << seed << acked
+               << static_cast<sf::Uint8>(seats.size());
+        for(std::size_t i = 0; i < seats.size(); i++)
+            packet << static_cast<sf::Uint8>(seats[i]) << frames[i].down << frames[i].moveX << frames[i].moveY;
+    }
+    stats.bytesSent += packet.getDataSize();
+    socket.send(packet, address, port);
+}
+
+void MatchClient::receive()
+{
+    sf::Packet packet;
+    sf::IpAddress from;
+    unsigned short fromPort;
+    while(socket.receive(packet, from, fromPort) == sf::Socket::Done){
+        stats.bytesReceived += packet.getDataSize();
+        sf::Uint16 magic = 0;
+        sf::Uint8 type = 0;
+        sf::Uint32 matchSeed = 0;
+        packet >> magic >> type >> matchSeed;
+        if(!packet || magic != MatchServer::MAGIC || matchSeed != seed)
+            continue;
+        if(type == MatchServer::JOINED){
+            sf::Uint8 players = 0;
+            sf::Uint8 count = 0;
+            packet >> players >> count;
+            std::vector<int> given;
+            for(int i = 0; i < count; i++){
+                sf::Uint8 seat = 0;
+                packet >> seat;
+                given.push_back(seat);
+            }
+            if(!packet)
+                continue;
+            if(given.size() > frames.size())
+                given.resize(frames.size());
+            seats = given;
+            joined = true;
+            continue;
+        }
+        // snapshots can come before JOINED (if it was lost); we keep asking
+        // to join until we know our seats
+        if(type != MatchServer::SNAPSHOT)
+            continue;
+        sf::Uint32 tick = 0;
+        sf::Uint32 base = MatchServer::NO_TICK;
+        packet >> tick >> base;
+        // old news
+        if(!packet || (acked != MatchServer::NO_TICK && tick <= acked))
+            continue;
+        const MatchSnapshot* against = NULL;
+        if(base != MatchServer::NO_TICK){
+            against = &history[base % HISTORY];
+            if(against->tick != base){
+                stats.undecodable++;
+                continue;
+            }
+        }
+        const char* data = static_cast<const char*>(packet.getData());
+        BitReader bits(data + MatchServer::SNAPSHOT_HEADER, packet.getDataSize() - MatchServer::SNAPSHOT_HEADER);
+        MatchSnapshot s;
+        if(!s.read(bits, against))
+            continue;
+        s.tick = tick;
+        history[tick % HISTORY] = s;
+        latest = s;
+        acked = tick;
+        stats.snapshots++;
+    }
+}
+
+bool MatchClient::askLoad(const sf::IpAddress& address, unsigned short port,
+                          MatchServer::Load& load, float timeout)
+{
+    sf::UdpSocket socket;
+    if(socket.bind(sf::Socket::AnyPort) != sf::Socket::Done)
+        return false;
+    socket.setBlocking(false);
+    sf::Packet ask;
+    ask << MatchServer::MAGIC << static_cast<sf::Uint8>(MatchServer::ASK_LOAD);
+    double until = Input::now() + timeout;
+    double askedAt = 0;
+    while(Input::now() < until){
+        // again every so often in case one got lost
+        if(Input::now() - askedAt > 0.1){
+            socket.send(ask, address, port);
+            askedAt = Input::now();
+        }
+        sf::Packet reply;
+        sf::IpAddress from;
+        unsigned short fromPort;
+        if(socket.receive(reply, from, fromPort) == sf::Socket::Done){
+            sf::Uint16 magic = 0;
+            sf::Uint8 type = 0;
+            reply >> magic >> type;
+            if(magic == MatchServer::MAGIC && type == MatchServer::LOAD)
+                return load.unpack(reply);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+}
@@ -0,0 +1,262 @@
+#include "game/sim/MatchSave.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MATCH_SAVE_MMAP
+#endif
+
+namespace
+{
+    const char MAGIC[4] = {'H', 'H', 'S', 'V'};
+    // 2: players carry their item's highLow
+    // 3: 64-bit seeds
+    const uint32_t VERSION = 3;
+    // magic, version, slot size, spare
+    const std::size_t HEADER = 16;
+    // a 4 player house is about 800 bytes; bigger states grow the file
+    const uint32_t FIRST_SLOT_BYTES = 2048;
+
+    uint32_t checksum(const char* data, std::size_t size)
+    {
+        // FNV-1a
+        uint32_t h = 2166136261u;
+        for(std::size_t i = 0; i < size; i++){
+            h ^= static_cast<uint8_t>(data[i]);
+            h *= 16777619u;
+        }
+        return h;
+    }
+    uint32_t getU32(const char* at)
+    {
+        uint32_t v;
+        std::memcpy(&v, at, sizeof(v));
+        return v;
+    }
+    void putU32(char* at, uint32_t v)
+    {
+        std::memcpy(at, &v, sizeof(v));
+    }
+}
+
+MatchSave::~MatchSave()
+{
+    close();
+}
+
+bool MatchSave::open(const std::string& filename)
+{
+    close();
+    this->filename = filename;
+    std::size_t existing = 0;
+#ifdef MATCH_SAVE_MMAP
+    fd = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if(fd < 0){
+        std::cout << "MatchSave: couldn't open " << filename << std::endl;
+        return false;
+    }
+    struct stat st;
+    if(fstat(fd, &st) == 0)
+        existing = st.st_size;
+    if(existing >= HEADER && !mapFile(existing)){
+        close();
+        return false;
+    }
+#else
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if(file){
+        existing = file.tellg();
+        file.seekg(0);
+        buffer.resize(existing);
+        file.read(buffer.data(), existing);
+        data = buffer.data();
+        length = existing;
+    }
+#endif
+    // keep what's there if it's one of ours, whole (longer is a resize
+    // that didn't get as far as the header, and loads as it was)
+    if(existing >= HEADER && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0 && getU32(data + 4) == VERSION){
+        uint32_t slotBytes = getU32(data + 8);
+        if(existing >= HEADER + 2 * (sizeof(Slot) + slotBytes))
+            return true;
+    }
+    // anything else is only made over if there's nothing in it: missing,
+    // empty, or the first resize() not as far as the header (which it
+    // writes last); an old save or the wrong file is left alone
+    if(existing > 0 && (existing < HEADER || std::count(data, data + HEADER, 0) != static_cast<long>(HEADER))){
+        std::cout << "MatchSave: " << filename << " isn't a version " << VERSION << " save, leaving it alone" << std::endl;
+        close();
+        return false;
+    }
+    if(!resize(FIRST_SLOT_BYTES, std::vector<char>())){
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MatchSave::close()
+{
+#ifdef MATCH_SAVE_MMAP
+    if(mapped)
+        munmap(data, length);
+    if(fd >= 0)
+        ::close(fd);
+    fd = -1;
+#endif
+    mapped = false;
+    data = NULL;
+    length = 0;
+    buffer.clear();
+}
+
+bool MatchSave::mapFile(std::size_t length)
+{
+#ifdef MATCH_SAVE_MMAP
+    if(mapped)
+        munmap(data, this->length);
+    mapped = false;
+    data = NULL;
+    this->length = 0;
+    // shared, so what's written here is the file
+    void* m = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if(m == MAP_FAILED){
+        std::cout << "MatchSave: couldn't map " << filename << std::endl;
+        return false;
+    }
+    data = static_cast<char*>(m);
+    this->length = length;
+    mapped = true;
+    return true;
+#else
+    (void)length;
+    return false;
+#endif
+}
+
+bool MatchSave::resize(uint32_t slotBytes, const std::vector<char>& kept)
+{
+    std::size_t size = HEADER + 2 * (sizeof(Slot) + slotBytes);
+#ifdef MATCH_SAVE_MMAP
+    if(ftruncate(fd, size) != 0 || !mapFile(size)){
+        std::cout << "MatchSave: couldn't size " << filename << std::endl;
+        return false;
+    }
+#else
+    buffer.assign(size, 0);
+    data = buffer.data();
+    length = size;
+#endif
+    // Slot 0 starts in the same place whatever the slot size, so until
+    // the header changes the file still loads under the old one: first
+    // the save being kept, then slot 1 unstamped, the header last
+    Slot empty = {0, 0, 0};
+    if(kept.size() >= sizeof(Slot))
+        std::memcpy(data + HEADER, kept.data(), kept.size());
+    else
+        std::memcpy(data + HEADER, &empty, sizeof(empty));
+    std::memcpy(data + HEADER + sizeof(Slot) + slotBytes, &empty, sizeof(empty));
+    std::memcpy(data, MAGIC, sizeof(MAGIC));
+    putU32(data + 4, VERSION);
+    putU32(data + 8, slotBytes);
+    putU32(data + 12, 0);
+    return writeBack();
+}
+
+bool MatchSave::writeBack()
+{
+    if(mapped)
+        return true;
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file.write(data, length);
+    return static_cast<bool>(file);
+}
+
+char* MatchSave::slotAt(int slot) const
+{
+    return data + HEADER + slot * (sizeof(Slot) + getU32(data + 8));
+}
+
+int MatchSave::newest() const
+{
+    if(!data)
+        return -1;
+    uint32_t slotBytes = getU32(data + 8);
+    int best = -1;
+    uint32_t bestSequence = 0;
+    for(int s = 0; s < 2; s++){
+        Slot slot;
+        std::memcpy(&slot, slotAt(s), sizeof(slot));
+        if(slot.sequence == 0 || slot.size > slotBytes)
+            continue;
+        if(checksum(slotAt(s) + sizeof(Slot), slot.size) != slot.checksum)
+            continue;
+        if(best < 0 || slot.sequence > bestSequence){
+            best = s;
+            bestSequence = slot.sequence;
+        }
+    }
+    return best;
+}
+
+uint32_t MatchSave::getSequence() const
+{
+    int s = newest();
+    return s < 0 ? 0 : getU32(slotAt(s));
+}
+
+bool MatchSave::save(const MatchState& state)
+{
+    if(!data)
+        return false;
+    bits.clear();
+    state.write(bits, NULL, MatchState::EXACT);
+    uint32_t size = static_cast<uint32_t>(bits.getByteCount());
+    if(size > getU32(data + 8)){
+        // room to spare for it to grow again, with the newest save brought
+        // along so there's still one to load if this one never lands
+        std::vector<char> kept;
+        int s = newest();
+        if(s >= 0){
+            Slot slot;
+            std::memcpy(&slot, slotAt(s), sizeof(slot));
+            kept.assign(slotAt(s), slotAt(s) + sizeof(Slot) + slot.size);
+        }
+        if(!resize(std::max(size * 2, FIRST_SLOT_BYTES), kept))
+            return false;
+    }
+    int now = newest();
+    uint32_t sequence = now < 0 ? 1 : getU32(slotAt(now)) + 1;
+    char* at = slotAt(now == 0 ? 1 : 0);
+    // unstamped until it's whole
+    Slot slot = {0, size, checksum(reinterpret_cast<const char*>(bits.getData()), size)};
+    std::memcpy(at, &slot, sizeof(slot));
+    std::memcpy(at + sizeof(Slot), bits.getData(), size);
+    putU32(at, sequence);
+    return writeBack();
+}
+
+bool MatchSave::load(MatchState& state) const
+{
+    int s = newest();
+    if(s < 0)
+        return false;
+    Slot slot;
+    std::memcpy(&slot, slotAt(s), sizeof(slot));
+    BitReader in(slotAt(s) + sizeof(Slot), slot.size);
+    return state.read(in, NULL);
+}
+
+void MatchSave::flush()
+{
+#ifdef MATCH_SAVE_MMAP
+    if(mapped)
+        msync(data, length, MS_SYNC);
+#endif
+}
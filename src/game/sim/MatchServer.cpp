@@ -0,0 +1,434 @@
+#include "game/sim/MatchServer.hpp"
+#include "engine/Input.hpp"
+#include "engine/Lockstep.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+const sf::Uint16 MatchServer::MAGIC;
+const sf::Uint32 MatchServer::NO_TICK;
+const std::size_t MatchServer::SNAPSHOT_HEADER;
+const sf::Uint32 MatchServer::HISTORY;
+
+MatchServer::Load MatchServer::Load::since(const Load& earlier) const
+{
+    Load d = *this;
+    d.ticks -= earlier.ticks;
+    d.finished -= earlier.finished;
+    d.seconds -= earlier.seconds;
+    d.busySeconds -= earlier.busySeconds;
+    d.overruns -= earlier.overruns;
+    d.bytesSent -= earlier.bytesSent;
+    d.bytesReceived -= earlier.bytesReceived;
+    d.snapshotsSent -= earlier.snapshotsSent;
+    return d;
+}
+
+void MatchServer::Load::pack(sf::Packet& packet) const
+{
+    packet << static_cast<sf::Int32>(matches) << static_cast<sf::Int32>(clients)
+           << static_cast<sf::Uint32>(ticks) << static_cast<sf::Uint32>(finished)
+           << seconds << busySeconds << static_cast<sf::Uint32>(overruns)
+           << static_cast<sf::Uint32>(bytesSent) << static_cast<sf::Uint32>(bytesReceived)
+           << static_cast<sf::Uint32>(snapshotsSent);
+}
+
+bool MatchServer::Load::unpack(sf::Packet& packet)
+{
+    sf::Int32 m = 0, c = 0;
+    sf::Uint32 t = 0, f = 0, o = 0, bs = 0, br = 0, ss = 0;
+    packet >> m >> c >> t >> f >> seconds >> busySeconds >> o >> bs >> br >> ss;
+    matches = m;
+    clients = c;
+    ticks = t;
+    finished = f;
+    overruns = o;
+    bytesSent = bs;
+    bytesReceived = br;
+    snapshotsSent = ss;
+    return packet;
+}
+
+MatchServer::MatchServer()
+    : running(false)
+{
+}
+
+MatchServer::~MatchServer()
+{
+    stop();
+}
+
+bool MatchServer::start(unsigned short port, int threads)
+{
+    stop();
+    workers.clear();
+    for(int t = 0; t < threads; t++){
+        std::unique_ptr<Worker> w(new Worker());
+        if(w->socket.bind(port + t) != sf::Socket::Done){
+            std::cout << "MatchServer: couldn't listen on port " << port + t << std::endl;
+            workers.clear();
+            return false;
+        }
+        w->socket.setBlocking(false);
+        workers.push_back(std::move(w));
+    }
+    running = true;
+    for(auto it = workers.begin(); it != workers.end(); it++){
+        Worker& w = **it;
+        w.started = Input::now();
+        w.thread = std::thread([this, &w](){ run(w); });
+    }
+    std::cout << "MatchServer: " << threads << " threads on ports " << port
+              << "-" << port + threads - 1 << std::endl;
+    return true;
+}
+
+void MatchServer::stop()
+{
+    running = false;
+    for(auto it = workers.begin(); it != workers.end(); it++)
+        if((*it)->thread.joinable())
+            (*it)->thread.join();
+}
+
+void MatchServer::setCheckpoints(const std::string& directory, float everySeconds)
+{
+    checkpointDirectory = directory;
+    checkpointSeconds = everySeconds;
+}
+
+std::string MatchServer::getSavePath(sf::Uint32 seed) const
+{
+    return checkpointDirectory + "/match-" + std::to_string(seed) + ".hhs";
+}
+
+void MatchServer::openSave(Worker& w, Hosted& h)
+{
+    std::unique_ptr<MatchSave> save(new MatchSave());
+    if(!save->open(getSavePath(h.seed)))
+        return;
+    if(save->load(w.state) && w.state.seed == h.seed && w.state.result == Match::PLAYING
+       && h.match->restore(w.state)){
+        // carry on counting from the save, so snapshot ticks still go up
+        h.tick = h.match->getTicks();
+        std::cout << "MatchServer: resumed match " << h.seed << " at tick " << h.tick << std::endl;
+    }
+    h.save = std::move(save);
+}
+
+void MatchServer::run(Worker& w)
+{
+    unsigned int checkpointTicks = std::max(1L, std::lround(checkpointSeconds / tickSeconds));
+    double next = Input::now();
+    while(running){
+        double start = Input::now();
+        Load l;
+        receive(w, l, start);
+        for(auto it = w.matches.begin(); it != w.matches.end();){
+            Hosted& h = *it->second;
+            // nobody left: drop it
+            for(auto c = h.clients.begin(); c != h.clients.end();)
+                c = start - c->heard > idleSeconds ? h.clients.erase(c) : c + 1;
+            if(h.clients.empty()){
+                it = w.matches.erase(it);
+                continue;
+            }
+            if(!h.ended){
+                h.match->tick(tickSeconds);
+                l.ticks++;
+                if(h.match->getResult() != Match::PLAYING){
+                    h.ended = true;
+                    l.finished++;
+                    // nothing left to resume
+                    if(h.save){
+                        std::string path = h.save->getFilename();
+                        h.save.reset();
+                        std::remove(path.c_str());
+                    }
+                }
+            }
+            h.tick++;
+            if(h.save && h.tick % checkpointTicks == 0){
+                h.match->save(w.state);
+                // on the disk, not just handed to the OS, so the machine
+                // going down still leaves it to resume from
+                if(h.save->save(w.state))
+                    h.save->flush();
+            }
+            if(h.tick % snapshotInterval == 0)
+                sendSnapshots(w, h, l);
+            it++;
+        }
+        double end = Input::now();
+        next += tickSeconds;
+        {
+            std::lock_guard<std::mutex> guard(w.lock);
+            Load& total = w.load;
+            total.matches = static_cast<int>(w.matches.size());
+            total.clients = 0;
+            for(auto it = w.matches.begin(); it != w.matches.end(); it++)
+                total.clients += static_cast<int>(it->second->clients.size());
+            total.ticks += l.ticks;
+            total.finished += l.finished;
+            total.seconds = static_cast<float>(end - w.started);
+            total.busySeconds += static_cast<float>(end - start);
+            total.bytesSent += l.bytesSent;
+            total.bytesReceived += l.bytesReceived;
+            total.snapshotsSent += l.snapshotsSent;
+            if(next < end){
+                total.overruns++;
+                next = end;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::duration<double>(next - end));
+    }
+}
+
+void MatchServer::receive(Worker& w, Load& load, double now)
+{
+    sf::Packet packet;
+    sf::IpAddress address;
+    unsigned short port;
+    while(w.socket.receive(packet, address, port) == sf::Socket::Done){
+        load.bytesReceived += packet.getDataSize();
+        sf::Uint16 magic = 0;
+        sf::Uint8 type = 0;
+        packet >> magic >> type;
+        if(!packet || magic != MAGIC)
+            continue;
+        switch(type){
+            case JOIN:
+                join(w, packet, address, port, now);
+                break;
+            case INPUT:
+                input(w, packet, address, port, now);
+                break;
+            case LEAVE:
+                leave(w, packet, address, port);
+                break;
+            case ASK_LOAD:{
+                Load total;
+                {
+                    std::lock_guard<std::mutex> guard(w.lock);
+                    total = w.load;
+                }
+                sf::Packet reply;
+                reply << MAGIC << static_cast<sf::Uint8>(LOAD);
+                total.pack(reply);
+                w.socket.send(reply, address, port);
+                break;
+            }
+            default:
+                break;
+        }
+    }
+}
+
+bool MatchServer::setRules(const Match::Rules& r)
+{
+    if(!MatchSnapshot::fits(r)){
+        std::cout << "MatchServer: snapshots carry health up to " << MatchSnapshot::MAX_HEALTH
+                  << ", keeping the rules it had" << std::endl;
+        return false;
+    }
+    rules = r;
+    return true;
+}
+
+void MatchServer::join(Worker& w, sf::Packet& packet, const sf::IpAddress& address, unsigned short port, double now)
+{
+    sf::Uint32 seed = 0;
+    sf::Uint8 count = 0;
+    packet >> seed >> count;
+    // snapshots only have room for so many players
+    if(count < 1 || count > MatchSnapshot::MAX_PLAYERS)
+        return;
+    std::vector<Config::CHARACTER> characters;
+    for(int i = 0; i < count; i++){
+        sf::Uint8 c = 0;
+        packet >> c;
+        characters.push_back(static_cast<Config::CHARACTER>(c % 4));
+    }
+    sf::Uint8 wanted = 0;
+    packet >> wanted;
+    if(!packet || characters.empty())
+        return;
+    Hosted* h = find(w, seed);
+    if(!h){
+        std::unique_ptr<Hosted> made(new Hosted());
+        made->seed = seed;
+        made->match.reset(new Match(seed, characters, rules));
+        if(!checkpointDirectory.empty())
+            openSave(w, *made);
+        h = made.get();
+        w.matches[seed] = std::move(made);
+    }
+    // asking again (JOINED got lost) gets the same seats back
+    if(!findClient(*h, address, port)){
+        Client c;
+        c.address = address;
+        c.port = port;
+        c.sent.resize(HISTORY);
+        c.seats = freeSeats(*h, wanted);
+        h->clients.push_back(c);
+    }
+    Client* c = findClient(*h, address, port);
+    c->heard = now;
+    sf::Packet reply;
+    reply << MAGIC << static_cast<sf::Uint8>(JOINED) << seed
+          << static_cast<sf::Uint8>(h->match->getPlayers().size())
+          << static_cast<sf::Uint8>(c->seats.size());
+    for(auto it = c->seats.begin(); it != c->seats.end(); it++)
+        reply << *it;
+    w.socket.send(reply, address, port);
+}
+
+void MatchServer::input(Worker& w, sf::Packet& packet, const sf::IpAddress& address, unsigned short port, double now)
+{
+    sf::Uint32 seed = 0;
+    sf::Uint32 ack = NO_TICK;
+    sf::Uint8 count = 0;
+    packet >> seed >> ack >> count;
+    Hosted* h = find(w, seed);
+    Client* c = h ? findClient(*h, address, port) : NULL;
+    if(!packet || !c)
+        return;
+    c->heard = now;
+    if(ack != NO_TICK && (c->acked == NO_TICK || ack > c->acked))
+        c->acked = ack;
+    int players = static_cast<int>(h->match->getPlayers().size());
+    for(int i = 0; i < count; i++){
+        sf::Uint8 player = 0;
+        Lockstep::Frame f;
+        packet >> player >> f.down >> f.moveX >> f.moveY;
+        if(!packet)
+            break;
+        // nobody plays anyone else's seat
+        if(player < players && c->owns(player))
+            h->match->setInput(player, f.getActions(), f.getMove());
+    }
+}
+
+void MatchServer::leave(Worker& w, sf::Packet& packet, const sf::IpAddress& address, unsigned short port)
+{
+    sf::Uint32 seed = 0;
+    packet >> seed;
+    Hosted* h = find(w, seed);
+    if(!packet || !h)
+        return;
+    for(auto it = h->clients.begin(); it != h->clients.end(); it++){
+        if(it->address == address && it->port == port){
+            // the match goes at the next tick if it was the last
+            h->clients.erase(it);
+            return;
+        }
+    }
+}
+
+void MatchServer::sendSnapshots(Worker& w, Hosted& h, Load& load)
+{
+    MatchSnapshot snapshot;
+    snapshot.capture(*h.match, h.tick);
+    BitWriter bits;
+    for(auto c = h.clients.begin(); c != h.clients.end(); c++){
+        const MatchSnapshot* base = NULL;
+        if(c->acked != NO_TICK && h.tick - c->acked < HISTORY && c->sent[c->acked % HISTORY].tick == c->acked)
+            base = &c->sent[c->acked % HISTORY];
+        bits.clear();
+        snapshot.write(bits, base);
+        sf::Packet packet;
+        packet << MAGIC << static_cast<sf::Uint8>(SNAPSHOT) << h.seed << h.tick
+               << (base ? c->acked : NO_TICK);
+        packet.append(bits.getData(), bits.getByteCount());
+        w.socket.send(packet, c->address, c->port);
+        c->sent[h.tick % HISTORY] = snapshot;
+        load.bytesSent += packet.getDataSize();
+        load.snapshotsSent++;
+    }
+}
+
+MatchServer::Hosted* MatchServer::find(Worker& w, sf::Uint32 seed)
+{
+    auto it = w.matches.find(seed);
+    return it != w.matches.end() ? it->second.get() : NULL;
+}
+
+MatchServer::Client* MatchServer::findClient(Hosted& h, const sf::IpAddress& address, unsigned short port)
+{
+    for(auto it = h.clients.begin(); it != h.clients.end(); it++)
+        if(it->address == address && it->port == port)
+            return &*it;
+    return NULL;
+}
+
+bool MatchServer::Client::owns(int seat) const
+{
+    return std::find(seats.begin(), seats.end(), seat) != seats.end();
+}
+
+std::vector<sf::Uint8> MatchServer::freeSeats(const Hosted& h, int count) const
+{
+    std::vector<sf::Uint8> seats;
+    int players = static_cast<int>(h.match->getPlayers().size());
+    for(int s = 0; s < players && static_cast<int>(seats.size()) < count; s++){
+        bool taken = false;
+        for(auto c = h.clients.begin(); c != h.clients.end() && !taken; c++)
+            taken = c->owns(s);
+        if(!taken)
+            seats.push_back(static_cast<sf::Uint8>(s));
+    }
+    return seats;
+}
+
+std::vector<MatchServer::Load> MatchServer::takeLoad()
+{
+    std::vector<Load> loads;
+    for(auto it = workers.begin(); it != workers.end(); it++){
+        Worker& w = **it;
+        std::lock_guard<std::mutex> guard(w.lock);
+        loads.push_back(w.load.since(w.taken));
+        w.taken = w.load;
+    }
+    return loads;
+}
+
+MatchServer::Load MatchServer::total(const std::vector<Load>& loads)
+{
+    Load sum;
+    for(auto it = loads.begin(); it != loads.end(); it++){
+        sum.matches += it->matches;
+        sum.clients += it->clients;
+        sum.ticks += it->ticks;
+        sum.finished += it->finished;
+        sum.busySeconds += it->busySeconds;
+        sum.overruns += it->overruns;
+        sum.bytesSent += it->bytesSent;
+        sum.bytesReceived += it->bytesReceived;
+        sum.snapshotsSent += it->snapshotsSent;
+        // they all ran over the same stretch
+        sum.seconds = std::max(sum.seconds, it->seconds);
+    }
+    return sum;
+}
+
+void MatchServer::report(std::ostream& out)
+{
+    std::vector<Load> loads = takeLoad();
+    char line[200];
+    for(std::size_t t = 0; t < loads.size(); t++){
+        const Load& l = loads[t];
+        float seconds = std::max(0.001f, l.seconds);
+        std::snprintf(line, sizeof(line), "  thread %u: %d matches, %d clients, %.0f%% busy, %u late ticks, %.0f KB/s out, %.0f KB/s in",
+                      static_cast<unsigned>(t), l.matches, l.clients, l.busySeconds / seconds * 100, l.overruns,
+                      l.bytesSent / seconds / 1024, l.bytesReceived / seconds / 1024);
+        out << line << std::endl;
+    }
+    Load sum = total(loads);
+    std::snprintf(line, sizeof(line), "MatchServer: %d matches, %u finished, %.0f matches per core, %.1f B per snapshot",
+                  sum.matches, sum.finished, sum.getMatchesPerCore(),
+                  sum.snapshotsSent ? static_cast<float>(sum.bytesSent) / sum.snapshotsSent : 0.0f);
+    out << line << std::endl;
+}
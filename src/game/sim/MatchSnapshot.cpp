@@ -0,0 +1,136 @@
+#include "game/sim/MatchSnapshot.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+    // deltas in -256..255 quarter pixels take 9 bits, anything else 16
+    const int SMALL_BITS = 9;
+    const int SMALL = 1 << (SMALL_BITS - 1);
+
+    uint16_t quantize(float v)
+    {
+        long q = std::lround(v * 4);
+        return static_cast<uint16_t>(std::max(0L, std::min(65535L, q)));
+    }
+    uint8_t facingFlags(Match::FACING facing)
+    {
+        return static_cast<uint8_t>(facing << 5);
+    }
+
+    void writeCoord(BitWriter& out, uint16_t v, uint16_t base)
+    {
+        int d = static_cast<int>(v) - static_cast<int>(base);
+        out.writeBool(d != 0);
+        if(d == 0)
+            return;
+        bool small = d >= -SMALL && d < SMALL;
+        out.writeBool(small);
+        if(small)
+            out.writeSigned(d, SMALL_BITS);
+        else
+            out.write(v, 16);
+    }
+    uint16_t readCoord(BitReader& in, uint16_t base)
+    {
+        if(!in.readBool())
+            return base;
+        if(in.readBool())
+            return static_cast<uint16_t>(base + in.readSigned(SMALL_BITS));
+        return static_cast<uint16_t>(in.read(16));
+    }
+}
+
+void MatchSnapshot::capture(const Match& match, uint32_t tick)
+{
+    this->tick = tick;
+    result = static_cast<uint8_t>(match.getResult());
+    phase = static_cast<uint8_t>(match.getPhase());
+    const std::vector<Match::Player>& players = match.getPlayers();
+    playerCount = static_cast<int>(players.size());
+    const Match::Villain& villain = match.getVillain();
+    entities.resize(players.size() + (villain.present ? 1 : 0));
+    for(std::size_t i = 0; i < players.size(); i++){
+        const Match::Player& p = players[i];
+        Entity& e = entities[i];
+        e.x = quantize(p.position.x);
+        e.y = quantize(p.position.y);
+        e.health = static_cast<uint8_t>(std::max(0, p.health));
+        e.flags = facingFlags(p.facing);
+        if(p.invulnerable > 0) e.flags |= INVULNERABLE;
+        if(p.attacking > 0)    e.flags |= ATTACKING;
+        if(p.reading >= 0)     e.flags |= READING;
+        if(p.hasItem)          e.flags |= HAS_ITEM;
+    }
+    if(villain.present){
+        Entity& e = entities.back();
+        e.x = quantize(villain.position.x);
+        e.y = quantize(villain.position.y);
+        e.health = static_cast<uint8_t>(std::max(0, villain.health));
+        // faces the way it's going, like its walk cycles
+        Match::FACING facing = Match::FACE_DOWN;
+        if(std::abs(villain.direction.x) > std::abs(villain.direction.y))
+            facing = villain.direction.x < 0 ? Match::FACE_LEFT : Match::FACE_RIGHT;
+        else if(villain.direction.y < 0)
+            facing = Match::FACE_UP;
+        e.flags = facingFlags(facing);
+        if(villain.chasing) e.flags |= CHASING;
+    }
+}
+
+bool MatchSnapshot::fits(const Match::Rules& rules)
+{
+    for(int c = 0; c < 4; c++)
+        if(rules.health[c] > MAX_HEALTH)
+            return false;
+    return rules.villainHealth <= MAX_HEALTH;
+}
+
+void MatchSnapshot::write(BitWriter& out, const MatchSnapshot* base) const
+{
+    out.write(result, 2);
+    out.writeBool(phase > 1);
+    out.write(playerCount, 3);
+    out.writeBool(hasVillain());
+    const Entity zero;
+    for(std::size_t i = 0; i < entities.size(); i++){
+        const Entity& e = entities[i];
+        const Entity& b = base && i < base->entities.size() ? base->entities[i] : zero;
+        out.writeBool(!(e == b));
+        if(e == b)
+            continue;
+        writeCoord(out, e.x, b.x);
+        writeCoord(out, e.y, b.y);
+        out.writeBool(e.health != b.health);
+        if(e.health != b.health)
+            out.write(e.health, 4);
+        out.writeBool(e.flags != b.flags);
+        if(e.flags != b.flags)
+            out.write(e.flags, 7);
+    }
+}
+
+bool MatchSnapshot::read(BitReader& in, const MatchSnapshot* base)
+{
+    result = static_cast<uint8_t>(in.read(2));
+    phase = in.readBool() ? 2 : 1;
+    playerCount = static_cast<int>(in.read(3));
+    bool villain = in.readBool();
+    entities.resize(playerCount + (villain ? 1 : 0));
+    const Entity zero;
+    for(std::size_t i = 0; i < entities.size() && in.isValid(); i++){
+        const Entity& b = base && i < base->entities.size() ? base->entities[i] : zero;
+        Entity& e = entities[i];
+        e = b;
+        if(!in.readBool())
+            continue;
+        e.x = readCoord(in, b.x);
+        e.y = readCoord(in, b.y);
+        if(in.readBool())
+            e.health = static_cast<uint8_t>(in.read(4));
+        if(in.readBool())
+            e.flags = static_cast<uint8_t>(in.read(7));
+    }
+    return in.isValid();
+}
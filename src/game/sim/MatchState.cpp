@@ -0,0 +1,333 @@
+#include "game/sim/MatchState.hpp"
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // What a quantized float is kept in, and how many bits a change from
+    // the base takes before it's written whole (32)
+    struct Scale
+    {
+        float units;
+        int smallBits;
+    };
+    // quarter pixels, small within 128 px
+    const Scale POSITION = {4, 10};
+    // 127ths, like Lockstep::Frame; always small
+    const Scale DIRECTION = {127, 9};
+    // milliseconds, small within two seconds
+    const Scale SECONDS = {1000, 12};
+    // 64ths of a pixel a second
+    const Scale SPEED = {64, 10};
+    // draws of a random stream, tick counts
+    const int COUNT_SMALL_BITS = 8;
+
+    const int ACTION_BITS = Input::ACTION_COUNT;
+    const int ROOM_COUNT_BITS = 9;
+    const int CLUE_COUNT_BITS = 12;
+    // clue numbers, the ghost's target and sides, all of which can be -1
+    const int INDEX_BITS = 13;
+
+    uint32_t floatBits(float v)
+    {
+        uint32_t u;
+        std::memcpy(&u, &v, sizeof(u));
+        return u;
+    }
+    float bitsFloat(uint32_t u)
+    {
+        float v;
+        std::memcpy(&v, &u, sizeof(v));
+        return v;
+    }
+    bool fits(long d, int bits)
+    {
+        return d >= -(1L << (bits - 1)) && d < (1L << (bits - 1));
+    }
+
+    // write() and read() are the same walk over the state, one with a
+    // Writer and one with a Reader, so they can't drift apart. Each takes
+    // the value as it stands (the reader's starts out as the base's) and
+    // the base's value to delta against.
+    class Writer
+    {
+    public:
+        Writer(BitWriter& out, bool exact) : out(out), exact(exact) {};
+        // Whether a part differs from the base; if not the part's skipped
+        bool changed(bool differs)
+        {
+            out.writeBool(differs);
+            return differs;
+        }
+        void flag(bool& v){ out.writeBool(v); };
+        void number(int& v, int n){ out.writeSigned(v, n); };
+        void actions(Input::Actions& v){ out.write(static_cast<uint32_t>(v.to_ulong()), ACTION_BITS); };
+        void real(float& v, float base, const Scale& scale)
+        {
+            if(!changed(floatBits(v) != floatBits(base)))
+                return;
+            if(exact){
+                out.write(floatBits(v), 32);
+                return;
+            }
+            long q = std::lround(v * scale.units);
+            long d = q - std::lround(base * scale.units);
+            bool small = fits(d, scale.smallBits);
+            out.writeBool(small);
+            if(small)
+                out.writeSigned(static_cast<int32_t>(d), scale.smallBits);
+            else
+                out.write(static_cast<uint32_t>(static_cast<int32_t>(q)), 32);
+        }
+        void count(uint64_t& v, uint64_t base)
+        {
+            if(!changed(v != base))
+                return;
+            bool small = v > base && v - base <= (1u << COUNT_SMALL_BITS);
+            out.writeBool(small);
+            if(small){
+                out.write(static_cast<uint32_t>(v - base - 1), COUNT_SMALL_BITS);
+                return;
+            }
+            out.write(static_cast<uint32_t>(v), 32);
+            out.write(static_cast<uint32_t>(v >> 32), 32);
+        }
+    private:
+        BitWriter& out;
+        bool exact;
+    };
+
+    class Reader
+    {
+    public:
+        Reader(BitReader& in, bool exact) : in(in), exact(exact) {};
+        bool changed(bool){ return in.readBool(); };
+        void flag(bool& v){ v = in.readBool(); };
+        void number(int& v, int n){ v = in.readSigned(n); };
+        void actions(Input::Actions& v){ v = Input::Actions(in.read(ACTION_BITS)); };
+        void real(float& v, float base, const Scale& scale)
+        {
+            if(!in.readBool())
+                return;
+            if(exact){
+                v = bitsFloat(in.read(32));
+                return;
+            }
+            if(in.readBool())
+                v = (std::lround(base * scale.units) + in.readSigned(scale.smallBits)) / scale.units;
+            else
+                v = static_cast<int32_t>(in.read(32)) / scale.units;
+        }
+        void count(uint64_t& v, uint64_t base)
+        {
+            if(!in.readBool())
+                return;
+            if(in.readBool()){
+                v = base + in.read(COUNT_SMALL_BITS) + 1;
+                return;
+            }
+            uint64_t low = in.read(32);
+            v = low | static_cast<uint64_t>(in.read(32)) << 32;
+        }
+    private:
+        BitReader& in;
+        bool exact;
+    };
+
+    // For the handful of small fields that go through as ints
+    template<class Stream, class T>
+    void small(Stream& s, T& v, int n)
+    {
+        int i = static_cast<int>(v);
+        s.number(i, n);
+        v = static_cast<T>(i);
+    }
+    template<class Stream>
+    void coords(Stream& s, sf::Vector2f& v, sf::Vector2f base, const Scale& scale)
+    {
+        s.real(v.x, base.x, scale);
+        s.real(v.y, base.y, scale);
+    }
+
+    bool sameStatus(const Match::Player& a, const Match::Player& b)
+    {
+        return a.character == b.character && a.facing == b.facing && a.health == b.health
+            && a.itemDamage == b.itemDamage && a.hasItem == b.hasItem && a.itemHighLow == b.itemHighLow
+            && a.reading == b.reading;
+    }
+    bool sameStatus(const Match::Villain& a, const Match::Villain& b)
+    {
+        return a.health == b.health && a.fast == b.fast && a.chasing == b.chasing
+            && a.target == b.target && a.cameFrom == b.cameFrom;
+    }
+
+    template<class Stream>
+    void player(Stream& s, Match::Player& p, const Match::Player& b)
+    {
+        coords(s, p.position, b.position, POSITION);
+        coords(s, p.direction, b.direction, DIRECTION);
+        s.real(p.invulnerable, b.invulnerable, SECONDS);
+        s.real(p.attacking, b.attacking, SECONDS);
+        if(s.changed(!sameStatus(p, b))){
+            small(s, p.character, 3);
+            small(s, p.facing, 3);
+            s.number(p.health, 8);
+            s.number(p.itemDamage, 8);
+            s.flag(p.hasItem);
+            s.number(p.itemHighLow, 2);
+            s.number(p.reading, INDEX_BITS);
+        }
+    }
+
+    template<class Stream>
+    void villain(Stream& s, Match::Villain& v, const Match::Villain& b)
+    {
+        coords(s, v.position, b.position, POSITION);
+        coords(s, v.direction, b.direction, DIRECTION);
+        coords(s, v.heading, b.heading, POSITION);
+        s.real(v.speed, b.speed, SPEED);
+        if(s.changed(!sameStatus(v, b))){
+            s.number(v.health, 8);
+            s.flag(v.fast);
+            s.flag(v.chasing);
+            s.number(v.target, INDEX_BITS);
+            s.number(v.cameFrom, INDEX_BITS);
+        }
+    }
+
+    // Everything after the header. The vectors are already the size the
+    // stream says; b's are whatever size the base had.
+    template<class Stream>
+    void body(Stream& s, MatchState& m, const MatchState& b)
+    {
+        s.real(m.time, b.time, SECONDS);
+        s.real(m.phaseTime, b.phaseTime, SECONDS);
+        s.count(m.spawnDrawn, b.spawnDrawn);
+        s.count(m.clueDrawn, b.clueDrawn);
+        s.count(m.villainDrawn, b.villainDrawn);
+
+        if(s.changed(m.rooms != b.rooms)){
+            for(auto it = m.rooms.begin(); it != m.rooms.end(); it++){
+                small(s, it->gridX, 6);
+                small(s, it->gridY, 6);
+                small(s, it->type, 5);
+            }
+        }
+        // hardly any are open at once, so they go as a list
+        std::vector<int> open;
+        bool sameSize = m.clues.size() == b.clues.size();
+        bool sameRolls = sameSize;
+        bool sameOpen = sameSize;
+        for(std::size_t i = 0; i < m.clues.size(); i++){
+            const MatchState::Clue& c = m.clues[i];
+            if(c.open)
+                open.push_back(static_cast<int>(i));
+            if(sameSize){
+                const MatchState::Clue& bc = b.clues[i];
+                sameRolls = sameRolls && c.tier == bc.tier && c.highLow == bc.highLow;
+                sameOpen = sameOpen && c.open == bc.open;
+            }
+        }
+        if(s.changed(!sameRolls)){
+            for(auto it = m.clues.begin(); it != m.clues.end(); it++){
+                small(s, it->tier, 3);
+                small(s, it->highLow, 2);
+            }
+        }
+        if(s.changed(!sameOpen)){
+            int n = static_cast<int>(open.size());
+            s.number(n, CLUE_COUNT_BITS + 1);
+            open.resize(n < 0 ? 0 : n);
+            for(auto it = m.clues.begin(); it != m.clues.end(); it++)
+                it->open = false;
+            for(int i = 0; i < n; i++){
+                s.number(open[i], INDEX_BITS);
+                if(open[i] >= 0 && open[i] < static_cast<int>(m.clues.size()))
+                    m.clues[open[i]].open = true;
+            }
+        }
+
+        const Match::Player none = Match::Player();
+        const MatchState::Controls idle;
+        for(std::size_t i = 0; i < m.players.size(); i++){
+            Match::Player& p = m.players[i];
+            const Match::Player& bp = i < b.players.size() ? b.players[i] : none;
+            bool samePlayer = sameStatus(p, bp) && floatBits(p.position.x) == floatBits(bp.position.x)
+                && floatBits(p.position.y) == floatBits(bp.position.y)
+                && floatBits(p.direction.x) == floatBits(bp.direction.x)
+                && floatBits(p.direction.y) == floatBits(bp.direction.y)
+                && floatBits(p.invulnerable) == floatBits(bp.invulnerable)
+                && floatBits(p.attacking) == floatBits(bp.attacking);
+            if(s.changed(!samePlayer))
+                player(s, p, bp);
+
+            MatchState::Controls& c = m.controls[i];
+            const MatchState::Controls& bc = i < b.controls.size() ? b.controls[i] : idle;
+            if(s.changed(c.last != bc.last || c.held != bc.held
+                         || floatBits(c.move.x) != floatBits(bc.move.x)
+                         || floatBits(c.move.y) != floatBits(bc.move.y))){
+                s.actions(c.last);
+                s.actions(c.held);
+                coords(s, c.move, bc.move, DIRECTION);
+            }
+        }
+        if(m.villain.present)
+            villain(s, m.villain, b.villain);
+    }
+}
+
+void MatchState::write(BitWriter& out, const MatchState* base, PRECISION precision) const
+{
+    static const MatchState zero;
+    const MatchState& b = base ? *base : zero;
+    out.writeBool(precision == EXACT);
+    out.writeBool(seed != b.seed);
+    if(seed != b.seed){
+        out.write(static_cast<uint32_t>(seed), 32);
+        out.write(static_cast<uint32_t>(seed >> 32), 32);
+    }
+    Writer w(out, precision == EXACT);
+    uint64_t t = tick;
+    w.count(t, b.tick);
+    out.write(result, 2);
+    out.write(phase, 2);
+    out.write(static_cast<uint32_t>(players.size()), 3);
+    out.writeBool(villain.present);
+    out.writeBool(rooms.size() != b.rooms.size());
+    if(rooms.size() != b.rooms.size())
+        out.write(static_cast<uint32_t>(rooms.size()), ROOM_COUNT_BITS);
+    out.writeBool(clues.size() != b.clues.size());
+    if(clues.size() != b.clues.size())
+        out.write(static_cast<uint32_t>(clues.size()), CLUE_COUNT_BITS);
+    // the walk doesn't change anything when writing
+    body(w, const_cast<MatchState&>(*this), b);
+}
+
+bool MatchState::read(BitReader& in, const MatchState* base)
+{
+    static const MatchState zero;
+    const MatchState& b = base ? *base : zero;
+    *this = b;
+    bool exact = in.readBool();
+    if(in.readBool()){
+        uint64_t low = in.read(32);
+        seed = low | static_cast<uint64_t>(in.read(32)) << 32;
+    }
+    Reader r(in, exact);
+    uint64_t t = tick;
+    r.count(t, b.tick);
+    tick = static_cast<uint32_t>(t);
+    result = static_cast<uint8_t>(in.read(2));
+    phase = static_cast<uint8_t>(in.read(2));
+    players.resize(in.read(3));
+    controls.resize(players.size());
+    villain.present = in.readBool();
+    if(in.readBool())
+        rooms.resize(in.read(ROOM_COUNT_BITS));
+    if(in.readBool())
+        clues.resize(in.read(CLUE_COUNT_BITS));
+    if(!in.isValid())
+        return false;
+    body(r, *this, b);
+    return in.isValid();
+}
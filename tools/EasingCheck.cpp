@@ -0,0 +1,184 @@
+////////////////////////////
+// EasingCheck.cpp
+//
+// Accuracy check for the batched easing (include/engine/Interpolate.hpp):
+// every curve is run through interpolate::ease() on batches of every length
+// up to a few SIMD registers (so each tail length is covered) and compared
+// with the scalar function, on random tweens plus the start, middle and end
+// of each. Then a TweenManager full of tweens on every curve is stepped to
+// the end and checked against the scalar curves at each step.
+//
+//     easing_check [--seed=N]
+//
+// CMake runs it as the easing_check test (ctest, or the check target).
+////////////////////////////
+#include "engine/Interpolate.hpp"
+#include "engine/RandomStream.hpp"
+#include "engine/TweenManager.hpp"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const char* NAMES[interpolate::EASE_COUNT] = {
+        "linear",
+        "expo in", "expo out", "expo in out",
+        "cubic in", "cubic out", "cubic in out",
+        "quartic in", "quartic out", "quartic in out",
+        "quintic in", "quintic out", "quintic in out",
+        "quadratic in", "quadratic out", "quadratic in out",
+        "sine in", "sine out", "sine in out",
+        "circular in", "circular out", "circular in out",
+        "back in", "back out", "back in out",
+        "elastic in", "elastic out", "elastic in out"
+    };
+
+    // The SIMD kernels do the same operations as the scalar functions but
+    // not always in the same order, so allow a few float roundings at the
+    // size of the values involved (and nothing like a wrong constant)
+    bool close(float batched, float scalar, float b, float c)
+    {
+        if(std::isnan(scalar))
+            return std::isnan(batched);
+        float scale = std::fabs(b) + std::fabs(c) + 1;
+        return std::fabs(batched - scalar) <= 4 * FLT_EPSILON * scale;
+    }
+
+    struct Tweens
+    {
+        std::vector<float> t, b, c, d;
+        void add(float time, float start, float change, float duration)
+        {
+            t.push_back(time);
+            b.push_back(start);
+            c.push_back(change);
+            d.push_back(duration);
+        }
+    };
+
+    // Random tweens, with the points the curves branch on mixed in
+    Tweens makeTweens(RandomStream& rng, std::size_t n)
+    {
+        Tweens tweens;
+        for(std::size_t i = 0; i < n; i++){
+            float d = static_cast<float>(rng.uniform(0.05, 5));
+            float b = static_cast<float>(rng.uniform(-500, 500));
+            float c = static_cast<float>(rng.uniform(-500, 500));
+            float t;
+            switch(rng.equilikely(0, 4)){
+                case 0: t = 0; break;
+                case 1: t = d / 2; break;
+                case 2: t = d; break;
+                default: t = static_cast<float>(rng.uniform(0, d)); break;
+            }
+            tweens.add(t, b, c, d);
+        }
+        return tweens;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    unsigned long seed = 1;
+    for(int i = 1; i < argc; i++){
+        std::string arg(argv[i]);
+        if(arg.compare(0, 7, "--seed=") == 0)
+            seed = std::stoul(arg.substr(7));
+        else
+            std::cout << "Unknown option " << arg << std::endl;
+    }
+    RandomStream rng(seed, RandomStream::getNameId("easing"));
+    int failures = 0;
+
+    // ease() against the scalar functions, batch lengths 1..40 and a big one
+    for(int e = 0; e < interpolate::EASE_COUNT; e++){
+        interpolate::EASE curve = static_cast<interpolate::EASE>(e);
+        interpolate::Function f = interpolate::function(curve);
+        int checked = 0;
+        int wrong = 0;
+        float worst = 0;
+        for(std::size_t n = 1; n <= 41; n++){
+            Tweens tweens = makeTweens(rng, n == 41 ? 4099 : n);
+            std::size_t count = tweens.t.size();
+            std::vector<float> out(count);
+            interpolate::ease(curve, tweens.t.data(), tweens.b.data(), tweens.c.data(), tweens.d.data(), out.data(), count);
+            for(std::size_t i = 0; i < count; i++){
+                float expected = f(tweens.t[i], tweens.b[i], tweens.c[i], tweens.d[i]);
+                checked++;
+                if(!std::isnan(expected))
+                    worst = std::max(worst, std::fabs(out[i] - expected));
+                if(close(out[i], expected, tweens.b[i], tweens.c[i]))
+                    continue;
+                if(wrong++ < 3){
+                    char line[200];
+                    std::snprintf(line, sizeof(line), "easing_check: %s at t=%g b=%g c=%g d=%g (batch of %zu, #%zu) is %.7g, scalar %.7g",
+                                  NAMES[e], tweens.t[i], tweens.b[i], tweens.c[i], tweens.d[i], count, i, out[i], expected);
+                    std::cerr << line << std::endl;
+                }
+            }
+        }
+        failures += wrong;
+        char line[160];
+        std::snprintf(line, sizeof(line), "  %-18s %-7s %6d checked, %d wrong, worst difference %.3g",
+                      NAMES[e], interpolate::isVectorized(curve) ? "simd" : "scalar", checked, wrong, worst);
+        std::cout << line << std::endl;
+    }
+
+    // TweenManager: every curve, some delayed, stepped past the end
+    const int PER_CURVE = 37;
+    const float DT = 1 / 60.0f;
+    TweenManager manager;
+    std::vector<float> targets(interpolate::EASE_COUNT * PER_CURVE, 0);
+    Tweens tweens;
+    std::vector<float> delays;
+    std::vector<int> curves;
+    for(int e = 0; e < interpolate::EASE_COUNT; e++){
+        for(int i = 0; i < PER_CURVE; i++){
+            float d = static_cast<float>(rng.uniform(0.1, 2));
+            float start = static_cast<float>(rng.uniform(-500, 500));
+            float end = static_cast<float>(rng.uniform(-500, 500));
+            float delay = rng.bernoulli(0.3) ? static_cast<float>(rng.uniform(0, 0.5)) : 0;
+            manager.add(&targets[tweens.t.size()], static_cast<interpolate::EASE>(e), start, end, d, delay);
+            tweens.add(0, start, end - start, d);
+            delays.push_back(-delay);
+            curves.push_back(e);
+        }
+    }
+    int tweenWrong = 0;
+    for(int step = 0; step < 3 * 60 && manager.size() > 0; step++){
+        manager.update(DT);
+        for(std::size_t i = 0; i < targets.size(); i++){
+            // the manager's own sum, so the times match to the bit
+            delays[i] = std::min(delays[i] + DT, tweens.d[i]);
+            if(delays[i] < 0)
+                continue;
+            float expected = interpolate::function(static_cast<interpolate::EASE>(curves[i]))(delays[i], tweens.b[i], tweens.c[i], tweens.d[i]);
+            if(close(targets[i], expected, tweens.b[i], tweens.c[i]))
+                continue;
+            if(tweenWrong++ < 3){
+                char line[200];
+                std::snprintf(line, sizeof(line), "easing_check: TweenManager %s at %.4g s of %.4g is %.7g, scalar %.7g",
+                              NAMES[curves[i]], delays[i], tweens.d[i], targets[i], expected);
+                std::cerr << line << std::endl;
+            }
+        }
+    }
+    if(manager.size() > 0){
+        std::cerr << "easing_check: " << manager.size() << " tweens never finished" << std::endl;
+        tweenWrong++;
+    }
+    std::cout << "  TweenManager: " << targets.size() << " tweens, " << tweenWrong << " wrong" << std::endl;
+    failures += tweenWrong;
+
+    if(failures){
+        std::cerr << "easing_check: " << failures << " batched values differ from the scalar curves" << std::endl;
+        return 1;
+    }
+    std::cout << "easing_check: batched easing matches the scalar curves" << std::endl;
+    return 0;
+}
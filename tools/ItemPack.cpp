@@ -0,0 +1,137 @@
+////////////////////////////
+// ItemPack.cpp
+//
+// Build step that compiles resources/items.xml into the constant tables
+// declared in include/engine/ItemPack.hpp. CMake runs it whenever items.xml
+// changes:
+//
+//     itempack <items.xml> <output.cpp>
+//
+// Every item is checked before anything is written, so a broken item file
+// fails the build instead of crashing a match.
+////////////////////////////
+#include "engine/ItemDatabase.hpp"
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <string>
+
+// Writes s as a C++ string literal
+static std::string quote(const char* s)
+{
+    std::string out = "\"";
+    for(; *s; s++){
+        unsigned char c = *s;
+        if(c == '"' || c == '\\' || c == '?'){
+            // '?' so nothing can turn into a trigraph
+            out += '\\';
+            out += c;
+        }
+        else if(c < 0x20 || c == 0x7f){
+            // octal escapes stop after three digits, unlike hex ones
+            out += '\\';
+            out += '0' + ((c >> 6) & 7);
+            out += '0' + ((c >> 3) & 7);
+            out += '0' + (c & 7);
+        }
+        else
+            out += c;
+    }
+    return out + "\"";
+}
+
+// Checks everything selectItems and createClues rely on
+static bool validate(const ItemDatabase& db)
+{
+    const char* tiers[] = {"high", "low"};
+    const char* clues[] = {"jackpot", "specific", "vague", "worthless"};
+    int errors = 0;
+    for(int t = 0; t < ItemDatabase::TIER_COUNT; t++){
+        ItemDatabase::TIER tier = static_cast<ItemDatabase::TIER>(t);
+        if(db.getItemCount(tier) == 0){
+            std::cerr << "items: tier '" << tiers[t] << "' has no items" << std::endl;
+            errors++;
+        }
+        std::set<std::string> names;
+        for(int i = 0; i < db.getItemCount(tier); i++){
+            const ItemRecord& item = db.getItem(tier, i);
+            std::string where = std::string(tiers[t]) + " item " + std::to_string(i);
+            if(!*item.name){
+                std::cerr << "items: " << where << " has no name" << std::endl;
+                errors++;
+            }
+            else if(!names.insert(item.name).second){
+                std::cerr << "items: " << where << " reuses the name '" << item.name << "'" << std::endl;
+                errors++;
+            }
+            if(!*item.type){
+                std::cerr << "items: " << where << " has no type" << std::endl;
+                errors++;
+            }
+            else if(db.getInfo(item.type).empty()){
+                std::cerr << "items: " << where << " has type '" << item.type << "' with no info lines" << std::endl;
+                errors++;
+            }
+            for(int c = 0; c < ItemDatabase::CLUE_COUNT; c++){
+                if(!*item.clues[c]){
+                    std::cerr << "items: " << where << " is missing its " << clues[c] << " clue" << std::endl;
+                    errors++;
+                }
+            }
+        }
+    }
+    return errors == 0;
+}
+
+int main(int argc, char** argv)
+{
+    if(argc != 3){
+        std::cerr << "usage: " << argv[0] << " <items.xml> <output.cpp>" << std::endl;
+        return 1;
+    }
+    std::shared_ptr<const ItemDatabase> db = ItemDatabase::load(argv[1]);
+    if(!db || !validate(*db))
+        return 1;
+
+    std::ofstream out(argv[2]);
+    if(!out){
+        std::cerr << "items: can't write " << argv[2] << std::endl;
+        return 1;
+    }
+    out << "// Generated from " << argv[1] << " by tools/ItemPack.cpp. Do not edit.\n";
+    out << "#include \"engine/ItemPack.hpp\"\n\n";
+
+    std::vector<std::string> types = db->getInfoTypes();
+    for(int i = 0; i < (int)types.size(); i++){
+        out << "static const char* const INFO_" << i << "[] = {\n";
+        const std::vector<const char*>& lines = db->getInfo(types[i]);
+        for(auto it = lines.begin(); it != lines.end(); it++)
+            out << "    " << quote(*it) << ",\n";
+        out << "};\n";
+    }
+
+    out << "\nconst ItemRecord ItemPack::ITEMS[] = {\n";
+    int start = 0;
+    std::string starts = "0";
+    for(int t = 0; t < ItemDatabase::TIER_COUNT; t++){
+        ItemDatabase::TIER tier = static_cast<ItemDatabase::TIER>(t);
+        for(int i = 0; i < db->getItemCount(tier); i++){
+            const ItemRecord& item = db->getItem(tier, i);
+            out << "    {" << quote(item.name) << ", " << quote(item.type) << ", {";
+            for(int c = 0; c < ItemDatabase::CLUE_COUNT; c++)
+                out << (c ? ", " : "") << quote(item.clues[c]);
+            out << "}},\n";
+        }
+        start += db->getItemCount(tier);
+        starts += ", " + std::to_string(start);
+    }
+    out << "};\n";
+    out << "const int ItemPack::TIER_START[ItemDatabase::TIER_COUNT + 1] = {" << starts << "};\n\n";
+
+    out << "const ItemPackInfo ItemPack::INFO[] = {\n";
+    for(int i = 0; i < (int)types.size(); i++)
+        out << "    {" << quote(types[i].c_str()) << ", INFO_" << i << ", " << db->getInfo(types[i]).size() << "},\n";
+    out << "};\n";
+    out << "const int ItemPack::INFO_COUNT = " << types.size() << ";\n";
+    return out ? 0 : 1;
+}
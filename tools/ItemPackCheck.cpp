@@ -0,0 +1,140 @@
+////////////////////////////
+// ItemPackCheck.cpp
+//
+// Round trip check for the item pack: walks resources/items.xml as a plain
+// rapidxml document, the way ClueReader read it before ItemDatabase
+// existed, and compares every item, clue and info line against the tables
+// tools/ItemPack.cpp generated (include/engine/ItemPack.hpp). The generator
+// goes through ItemDatabase, so this deliberately doesn't: a mistake there
+// would show up on both sides and pass. Any difference fails it:
+//
+//     itempack_check <items.xml>
+//
+// CMake runs it as the itempack_check test (ctest, or the check target).
+////////////////////////////
+#include "engine/ItemPack.hpp"
+#include "rapidxml/rapidxml.hpp"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace rapidxml;
+
+namespace
+{
+    int mismatches = 0;
+
+    void compare(const std::string& where, const char* parsed, const char* packed)
+    {
+        if(std::strcmp(parsed, packed) == 0)
+            return;
+        std::cerr << "itempack_check: " << where << " is \"" << parsed
+                  << "\" in items.xml but \"" << packed << "\" in the pack" << std::endl;
+        mismatches++;
+    }
+
+    void compareCount(const std::string& what, int parsed, int packed)
+    {
+        if(parsed == packed)
+            return;
+        std::cerr << "itempack_check: items.xml has " << parsed << " " << what
+                  << " but the pack has " << packed << std::endl;
+        mismatches++;
+    }
+
+    // "" for a child that isn't there, so it shows up as a difference
+    const char* childValue(xml_node<>* parent, const char* name)
+    {
+        xml_node<>* child = parent ? parent->first_node(name) : NULL;
+        return child ? child->value() : "";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if(argc != 2){
+        std::cerr << "usage: " << argv[0] << " <items.xml>" << std::endl;
+        return 1;
+    }
+    std::ifstream file(argv[1]);
+    if(!file){
+        std::cerr << "itempack_check: can't read " << argv[1] << std::endl;
+        return 1;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string content(buffer.str());
+    xml_document<> doc;
+    try{
+        doc.parse<0>(&content[0]);
+    }catch(parse_error& e){
+        std::cerr << "itempack_check: " << argv[1] << ": " << e.what() << std::endl;
+        return 1;
+    }
+    xml_node<>* root = doc.first_node("items");
+    if(!root){
+        std::cerr << "itempack_check: no <items> in " << argv[1] << std::endl;
+        return 1;
+    }
+
+    const char* tiers[] = {"high", "low"};
+    const char* clues[] = {"jackpot", "specific", "vague", "worthless"};
+    int items = 0;
+    for(int t = 0; t < ItemDatabase::TIER_COUNT; t++){
+        std::vector<xml_node<>*> parsed;
+        xml_node<>* list = root->first_node(tiers[t]);
+        for(xml_node<>* node = list ? list->first_node("item") : NULL; node; node = node->next_sibling("item"))
+            parsed.push_back(node);
+        int packed = ItemPack::TIER_START[t + 1] - ItemPack::TIER_START[t];
+        compareCount(std::string(tiers[t]) + " items", parsed.size(), packed);
+        for(int i = 0; i < (int)parsed.size() && i < packed; i++){
+            const ItemRecord& pack = ItemPack::ITEMS[ItemPack::TIER_START[t] + i];
+            std::string where = std::string(tiers[t]) + " item " + std::to_string(i);
+            compare(where + " name", childValue(parsed[i], "name"), pack.name);
+            compare(where + " type", childValue(parsed[i], "type"), pack.type);
+            xml_node<>* clueNode = parsed[i]->first_node("clues");
+            for(int c = 0; c < ItemDatabase::CLUE_COUNT; c++)
+                compare(where + " " + clues[c] + " clue", childValue(clueNode, clues[c]), pack.clues[c]);
+            items++;
+        }
+    }
+
+    // <info> holds one element per type, named after it, of lines; the pack
+    // has them sorted by type, so they're looked up by name
+    std::map<std::string, std::vector<const char*>> info;
+    xml_node<>* infoNode = root->first_node("info");
+    for(xml_node<>* type = infoNode ? infoNode->first_node() : NULL; type; type = type->next_sibling()){
+        std::vector<const char*>& lines = info[type->name()];
+        for(xml_node<>* line = type->first_node(); line; line = line->next_sibling())
+            lines.push_back(line->value());
+    }
+    compareCount("info types", info.size(), ItemPack::INFO_COUNT);
+    int lines = 0;
+    for(int i = 0; i < ItemPack::INFO_COUNT; i++){
+        const ItemPackInfo& pack = ItemPack::INFO[i];
+        auto it = info.find(pack.type);
+        if(it == info.end()){
+            std::cerr << "itempack_check: the pack has info for " << pack.type
+                      << " but items.xml doesn't" << std::endl;
+            mismatches++;
+            continue;
+        }
+        const std::vector<const char*>& parsed = it->second;
+        compareCount("info lines for " + it->first, parsed.size(), pack.count);
+        for(int l = 0; l < (int)parsed.size() && l < pack.count; l++){
+            compare("info line " + std::to_string(l) + " for " + it->first, parsed[l], pack.lines[l]);
+            lines++;
+        }
+    }
+
+    if(mismatches){
+        std::cerr << "itempack_check: " << mismatches << " differences, rebuild the item pack" << std::endl;
+        return 1;
+    }
+    std::cout << "itempack_check: " << items << " items and " << lines << " info lines match" << std::endl;
+    return 0;
+}